@@ -0,0 +1,100 @@
+#include "Benchmark.h"
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace bench {
+
+  nlohmann::json Result::to_json() const {
+    std::vector<double> sorted = times;
+    std::ranges::sort(sorted);
+
+    const auto   n    = static_cast<double>(sorted.size());
+    const double mean = sorted.empty() ? 0.0 : std::accumulate(sorted.begin(), sorted.end(), 0.0) / n;
+
+    double variance = 0.0;
+    for (const double t : sorted) {
+      variance += (t - mean) * (t - mean);
+    }
+    variance = (sorted.size() > 1) ? variance / (n - 1.0) : 0.0;
+
+    // Nearest-rank percentile of the sorted timings
+    auto percentile = [&sorted](double p) {
+      if (sorted.empty()) {
+        return 0.0;
+      }
+      const auto idx = static_cast<std::size_t>(std::ceil(p * static_cast<double>(sorted.size()))) - 1;
+      return sorted[std::min(idx, sorted.size() - 1)];
+    };
+
+    nlohmann::json result;
+    result["component"]   = component;
+    result["scenario"]    = scenario;
+    result["parameter"]   = parameter;
+    result["repetitions"] = sorted.size();
+    result["min_ns"]      = sorted.empty() ? 0.0 : sorted.front();
+    result["median_ns"]   = percentile(0.5);
+    result["p90_ns"]      = percentile(0.9);
+    result["max_ns"]      = sorted.empty() ? 0.0 : sorted.back();
+    result["mean_ns"]     = mean;
+    result["stddev_ns"]   = std::sqrt(variance);
+    return result;
+  }
+
+  Runner::Runner(unsigned int repetitions, unsigned int warmup, std::size_t flush_size, std::string filter)
+    : m_Repetitions(repetitions)
+    , m_Warmup(warmup)
+    , m_Filter(std::move(filter))
+    , m_FlushBuffer(flush_size, 0) {
+    if (m_Repetitions == 0) {
+      throw std::invalid_argument("The number of benchmark repetitions must be positive");
+    }
+  }
+
+  void Runner::flush_caches() noexcept {
+    // Touch every cache line, so the data of the benchmarked component is evicted from all cache levels
+    constexpr std::size_t cache_line = 64;
+
+    char sum = 0;
+    for (std::size_t i = 0; i < m_FlushBuffer.size(); i += cache_line) {
+      m_FlushBuffer[i] += 1;
+      sum += m_FlushBuffer[i];
+    }
+    do_not_optimize(sum);
+  }
+
+  nlohmann::json Runner::to_json(nlohmann::json context) const {
+    nlohmann::json result;
+    result["context"] = std::move(context);
+
+    result["benchmarks"] = nlohmann::json::array();
+    for (const auto& r : m_Results) {
+      result["benchmarks"].push_back(r.to_json());
+    }
+    return result;
+  }
+
+  void Runner::add_result(Result result) {
+    const auto summary = result.to_json();
+
+    std::string name = result.component + '/' + result.scenario;
+    if (!result.parameter.empty()) {
+      name += ':' + result.parameter;
+    }
+
+    std::stringstream ss;
+    ss << std::left << std::setw(56) << name << std::right << std::fixed << std::setprecision(0)
+       << " median " << std::setw(14) << summary["median_ns"].get<double>() << " ns"
+       << "   min " << std::setw(14) << summary["min_ns"].get<double>() << " ns\n";
+    std::cout << ss.str();
+
+    m_Results.push_back(std::move(result));
+  }
+
+}  // namespace bench
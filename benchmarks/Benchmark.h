@@ -0,0 +1,125 @@
+#pragma once
+
+// STL includes
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// nlohmann includes
+#include <nlohmann/json.hpp>
+
+namespace bench {
+
+  /**
+   * @brief Prevents the compiler from optimizing away the computation of a value.
+   */
+  template <typename T>
+  inline void do_not_optimize(const T& value) noexcept {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  /**
+   * @brief The timings of a single benchmark case.
+   */
+  struct Result {
+    std::string         component;  ///< The benchmarked component.
+    std::string         scenario;   ///< The scenario, e.g. recalculate_cold or unchanged.
+    std::string         parameter;  ///< The changed parameter of a single parameter scenario, empty otherwise.
+    std::vector<double> times;      ///< The wall time of every repetition in nanoseconds.
+
+    /**
+     * @brief Returns the summary statistics of the timings as JSON object.
+     */
+    [[nodiscard]] nlohmann::json to_json() const;
+  };
+
+  /**
+   * @class Runner
+   * @brief Runs micro-benchmarks and collects their timings.
+   *
+   * Every case consists of a setup and a body. Only the body is timed, the setup prepares the state of the next
+   * repetition, e.g. it changes a parameter or evicts the CPU caches with flush_caches().
+   */
+  class Runner {
+   public:
+    /**
+     * @brief Constructs a runner.
+     *
+     * @param repetitions The number of timed repetitions of every case.
+     * @param warmup The number of untimed repetitions before the timed ones.
+     * @param flush_size The size of the buffer used to evict the CPU caches in bytes.
+     * @param filter Only cases whose component name contains this string are run.
+     */
+    Runner(unsigned int repetitions, unsigned int warmup, std::size_t flush_size, std::string filter);
+
+    ~Runner() = default;
+
+    /**
+     * @brief Checks if the cases of a component are selected by the filter.
+     */
+    [[nodiscard]] bool selected(const std::string& component) const noexcept { return component.find(m_Filter) != std::string::npos; }
+
+    /**
+     * @brief Runs a benchmark case and stores its timings.
+     *
+     * @param component The name of the benchmarked component.
+     * @param scenario The name of the scenario.
+     * @param parameter The name of the changed parameter, if any.
+     * @param setup Called before every repetition, not timed.
+     * @param body Called once per repetition, timed.
+     */
+    template <typename Setup, typename Body>
+    void run(std::string component, std::string scenario, std::string parameter, Setup&& setup, Body&& body) {
+      if (!selected(component)) {
+        return;
+      }
+
+      for (unsigned int i = 0; i < m_Warmup; ++i) {
+        setup();
+        body();
+      }
+
+      std::vector<double> times;
+      times.reserve(m_Repetitions);
+
+      for (unsigned int i = 0; i < m_Repetitions; ++i) {
+        setup();
+
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const auto stop = std::chrono::steady_clock::now();
+
+        times.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+      }
+
+      add_result({std::move(component), std::move(scenario), std::move(parameter), std::move(times)});
+    }
+
+    /**
+     * @brief Evicts the CPU caches by writing and reading a buffer larger than the last-level cache.
+     */
+    void flush_caches() noexcept;
+
+    /**
+     * @brief Returns all results, including the context of the run, as JSON object.
+     *
+     * @param context Additional information about the run, e.g. the size of the synthetic data.
+     */
+    [[nodiscard]] nlohmann::json to_json(nlohmann::json context) const;
+
+    [[nodiscard]] const std::vector<Result>& results() const noexcept { return m_Results; }
+
+   private:
+    void add_result(Result result);
+
+    unsigned int m_Repetitions;  ///< The number of timed repetitions.
+    unsigned int m_Warmup;       ///< The number of untimed repetitions.
+    std::string  m_Filter;       ///< The component filter.
+
+    std::vector<char>   m_FlushBuffer;  ///< The buffer used to evict the CPU caches.
+    std::vector<Result> m_Results;      ///< The results of all cases run so far.
+  };
+
+}  // namespace bench
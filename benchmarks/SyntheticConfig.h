@@ -0,0 +1,112 @@
+#pragma once
+
+// includes
+#include "Parameter.h"
+
+// STL includes
+#include <array>
+#include <string>
+#include <tuple>
+#include <utility>
+
+// boost includes
+#include <boost/property_tree/ptree.hpp>
+
+namespace bench {
+
+  /**
+   * @brief Returns the start value and step width of a parameter in the synthetic configuration.
+   *
+   * The oscillation parameters are set to their global best fit values, the rates to one event per day and all
+   * other parameters, which are deviations from central values in units of their uncertainty, to zero.
+   */
+  inline std::pair<double, double> synthetic_parameter(int idx) {
+    using namespace params;
+    using enum params::dc::Detector;
+
+    switch (idx) {
+      case SinSqT13:
+        return {0.1, 0.01};
+      case DeltaMee:
+        return {2.484e-3, 1.0e-4};
+      case SinSqT12:
+        return {0.307, 0.013};
+      case DeltaM21:
+        return {7.53e-5, 1.8e-6};
+      case SinSqT14:
+      case DeltaM41:
+        return {0.0, 0.01};
+      case Bugey4:
+        return {1.0, 0.014};
+      default:
+        break;
+    }
+
+    if (idx < number_of_general_parameters()) {
+      return {0.0, 1.0};
+    }
+
+    switch ((idx - number_of_general_parameters()) % number_of_DoubleChooz_detector_parameters()) {
+      case BkgRAcc:
+      case BkgRLi:
+      case BkgRFNSM:
+      case BkgRDNCHy:
+      case BkgRDNCGd:
+        return {1.0, 0.1};
+      default:
+        return {0.0, 1.0};
+    }
+  }
+
+  /**
+   * @brief Creates a configuration tree for the synthetic Double Chooz data base.
+   *
+   * The tree has the layout of the config file, i.e. a "Parameter" list with all parameters and a "DoubleChooz"
+   * section with the lifetimes and the central values of the energy and MC normalization parameters per detector.
+   * No input paths are given, the samples are generated with --dc.synthetic.
+   */
+  inline boost::property_tree::ptree synthetic_config() {
+    namespace pt = boost::property_tree;
+
+    pt::ptree config;
+
+    pt::ptree parameters;
+
+    const auto names = params::get_all_parameter_names();
+    for (int i = 0, end = static_cast<int>(names.size()); i < end; ++i) {
+      const auto [value, step] = synthetic_parameter(i);
+
+      pt::ptree parameter;
+      parameter.put("Name", names[i]);
+      parameter.put("StartValue", value);
+      parameter.put("StepWidth", step);
+      parameter.put("Fixed", false);
+      parameter.put("Constrained", false);
+      parameters.push_back({"", parameter});
+    }
+    config.add_child("Parameter", parameters);
+
+    // Lifetimes in days, roughly the ones of the Double Chooz data sets
+    const std::array<std::tuple<std::string, double, double>, 3> detectors = {std::make_tuple("ND", 150.0, 8.0),
+                                                                               std::make_tuple("FDI", 460.0, 7.0),
+                                                                               std::make_tuple("FDII", 260.0, 9.0)};
+
+    for (const auto& [name, on_lifetime, off_lifetime] : detectors) {
+      pt::ptree detector;
+      detector.put("on_lifetime", on_lifetime);
+      detector.put("off_lifetime", off_lifetime);
+      detector.put("energy_A_CV", 0.0);
+      detector.put("energy_A_Sig", 0.01);
+      detector.put("energy_B_CV", 1.0);
+      detector.put("energy_B_Sig", 0.01);
+      detector.put("energy_C_CV", 0.0);
+      detector.put("energy_C_Sig", 0.001);
+      detector.put("MCNorm_Total_CV", 1.0);
+      detector.put("MCNorm_Total_Sig", 0.01);
+      config.add_child("DoubleChooz." + name, detector);
+    }
+
+    return config;
+  }
+
+}  // namespace bench
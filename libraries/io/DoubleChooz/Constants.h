@@ -32,6 +32,10 @@ namespace io::dc {
                                                               25., 30., 35., 40., 45., 50.};
 
     static constexpr int number_of_energy_bins = 38;  // Number of energy bins used in the Double Chooz experiment
+
+    static constexpr int number_of_spectrum_bins   = EnergyBinXaxis.size() - 1;  // Number of bins of the background and energy corrected spectra
+    static constexpr int number_of_reactor_bins    = 80;                         // Number of 0.25 MeV bins of the oscillated reactor spectra
+    static constexpr int number_of_covariance_bins = 43;                         // Size of the reactor covariance matrices
   };
 
 }  // namespace io::dc
@@ -29,11 +29,25 @@ namespace io::dc {
     ("dc.addStatisticalErrors,t", po::bool_switch(&m_UseStatisticalErrors), "Use Statistics Errors for toy-Spectra creation")
     ("dc.fakeBump", po::bool_switch(&m_FakeBump), "Add fake bump to fake data")
     ("dc.llhScan", po::bool_switch(&m_LikelihoodScan), "Perform a likelihood scan")
+    ("dc.scanParameter", po::value<std::string>(&m_ScanParameter)->default_value("SinSqT13"), "Parameter scanned in the likelihood scan")
+    ("dc.scanPoints", po::value<unsigned int>(&m_ScanPoints)->default_value(21), "Number of likelihood scan points")
+    ("dc.scanMin", po::value<double>(&m_ScanMin)->default_value(0.0), "Lower end of the likelihood scan range")
+    ("dc.scanMax", po::value<double>(&m_ScanMax)->default_value(0.2), "Upper end of the likelihood scan range")
+    ("dc.synthetic", po::bool_switch(&m_Synthetic), "Generate synthetic reactor and background samples instead of reading the input files")
+    ("dc.syntheticScale", po::value<double>(&m_SyntheticScale)->default_value(1.0), "Scale factor for the number of synthetic samples")
     ("dc.useSterile", po::bool_switch(&m_UseSterile), "Use Sterile Neutrino Parameters")
+    ("dc.oscillationPrecision", po::value<std::string>(&m_OscillationPrecision)->default_value("double"), "Precision of the oscillation of the reactor events: double, float or validate, which runs float and reports the deviation from double")
+    ("dc.offOff", po::bool_switch(&m_OffOff), "Add the off-off data of ND and FDII above 3 MeV to the likelihood")
     ("dc.reactorSplit,r", po::bool_switch(&m_ReactorSplit), "Use reactor split");
   }
 
   void DCInputOptions::read(const boost::program_options::variables_map& vm, const boost::property_tree::ptree& config) {
+    if (m_Synthetic) {
+      // The synthetic data base does not read any input files
+      std::cout << "Using synthetic Double Chooz samples, scaled by " << m_SyntheticScale << '\n';
+      return;
+    }
+
     std::cout << "Reading Double Chooz Input Paths\n";
 
     auto get_detectorType_from_String = [](const std::string& detector) -> params::dc::DetectorType {
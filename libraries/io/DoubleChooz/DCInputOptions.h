@@ -86,6 +86,33 @@ namespace io::dc {
      */
     [[nodiscard]] bool likelihood_scan() const noexcept { return m_LikelihoodScan; }
 
+    /**
+     * @brief Returns the name of the parameter that is scanned in the likelihood scan.
+     */
+    [[nodiscard]] const std::string& scan_parameter() const noexcept { return m_ScanParameter; }
+
+    /**
+     * @brief Returns the number of points of the likelihood scan.
+     */
+    [[nodiscard]] unsigned int scan_points() const noexcept { return m_ScanPoints; }
+
+    /**
+     * @brief Returns the scan range of the likelihood scan as pair of lower and upper end.
+     */
+    [[nodiscard]] std::pair<double, double> scan_range() const noexcept { return {m_ScanMin, m_ScanMax}; }
+
+    /**
+     * @brief Checks if the synthetic samples are used instead of the input files.
+     *
+     * @return true if the reactor and background samples are generated in memory, false otherwise.
+     */
+    [[nodiscard]] bool synthetic() const noexcept { return m_Synthetic; }
+
+    /**
+     * @brief Returns the scale factor for the number of generated synthetic samples.
+     */
+    [[nodiscard]] double synthetic_scale() const noexcept { return m_SyntheticScale; }
+
     /**
      * @brief Checks if the sterile option is enabled.
      *
@@ -95,6 +122,16 @@ namespace io::dc {
      */
     [[nodiscard]] bool use_sterile() const noexcept { return m_UseSterile; }
 
+    /**
+     * @brief Returns the precision of the oscillation of the reactor events: double, float or validate.
+     */
+    [[nodiscard]] const std::string& oscillation_precision() const noexcept { return m_OscillationPrecision; }
+
+    /**
+     * @brief Checks if the off-off data, i.e. the background measured with both reactors off, enter the likelihood.
+     */
+    [[nodiscard]] bool off_off() const noexcept { return m_OffOff; }
+
     /**
      * @brief Checks if the reactor split option is enabled.
      *
@@ -121,12 +158,21 @@ namespace io::dc {
 
     std::string m_ConfigFile;  // < The configuration file path
 
+    std::string  m_ScanParameter;  // < The parameter scanned in the likelihood scan
+    std::string  m_OscillationPrecision; // < The precision of the oscillation of the reactor events
+    unsigned int m_ScanPoints;     // < The number of likelihood scan points
+    double       m_ScanMin;        // < The lower end of the likelihood scan range
+    double       m_ScanMax;        // < The upper end of the likelihood scan range
+    double       m_SyntheticScale; // < The scale factor for the number of synthetic samples
+
     bool m_UseData;               // < Use Double Chooz Measurement Data
     bool m_UseStatisticalErrors;  // < Use Statistics Errors for toy-Spectra creation
     bool m_UseSystematicErrors;   // < Use Systematic Errors for toy-Spectra creation
     bool m_FakeBump;              // < Add fake bump to fake data
     bool m_LikelihoodScan;        // < Perform a likelihood scan
+    bool m_Synthetic;             // < Generate synthetic samples instead of reading the input files
     bool m_UseSterile;            // < Use Sterile Neutrino Parameters
+    bool m_OffOff;                // < Add the off-off data to the likelihood
     bool m_ReactorSplit;          // < Use reactor split
   };
 }  // namespace io::dc
\ No newline at end of file
@@ -3,13 +3,14 @@
 // includes
 #include "DataBase.h"
 #include "StartingParameter.h"
+#include "TaskScheduler.h"
 
 namespace io::dc {
 
   class DCOptions {
   public:
-    explicit DCOptions(const InputOptions& inputOptions)
-      : m_DataBase(inputOptions)
+    DCOptions(const InputOptions& inputOptions, utilities::TaskScheduler& scheduler)
+      : m_DataBase(inputOptions, scheduler)
       , m_StartingParameter(inputOptions) { }
 
     ~DCOptions() = default;
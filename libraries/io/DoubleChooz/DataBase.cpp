@@ -12,11 +12,13 @@
 // boost includes
 #include <boost/timer/progress_display.hpp>
 
+// Eigen includes
+#include <Eigen/Eigenvalues>
+
 // ROOT includes
 #include <TFile.h>
 #include <TH1D.h>
 #include <TMatrixD.h>
-#include <TMatrixDSym.h>
 #include <TTree.h>
 #include <TTreeReader.h>
 #include <TTreeReaderValue.h>
@@ -268,17 +270,62 @@ namespace io::dc {
     return entries;
   }
 
-  void DataBase::construct_energy_correlation_matrix() {
-    TMatrixD    corrMatrix(7, 7);
-    TVectorD    eigenValues(7);
-    TMatrixD    eigenVectors(corrMatrix.EigenVectors(eigenValues));
-    TMatrixDSym eigenValueMatrix(7);
+  /**
+   * @brief Reads an N x N correlation matrix, given as array of rows, and returns its factor L = V sqrt(D).
+   *
+   * V and D are the eigenvectors and eigenvalues of the correlation matrix C, so L L^T = C. Without the entry the
+   * parameters are uncorrelated and the identity is returned.
+   */
+  template <int N>
+  Eigen::Matrix<double, N, N> read_correlation_factor(const boost::property_tree::ptree& correlations, const std::string& name) {
+    using matrix_t = Eigen::Matrix<double, N, N>;
+
+    const auto rows = correlations.get_child_optional(name);
+    if (!rows) {
+      return matrix_t::Identity();
+    }
+
+    matrix_t correlation;
+    int      i = 0;
+    for (const auto& [_, row] : *rows) {
+      int j = 0;
+      for (const auto& [_, value] : row) {
+        if (i >= N || j >= N) {
+          throw std::invalid_argument("The " + name + " correlation matrix has more than " + std::to_string(N) + " rows or columns");
+        }
+        correlation(i, j++) = value.template get_value<double>();
+      }
+      if (j != N) {
+        throw std::invalid_argument("The " + name + " correlation matrix needs " + std::to_string(N) + " columns");
+      }
+      ++i;
+    }
+    if (i != N) {
+      throw std::invalid_argument("The " + name + " correlation matrix needs " + std::to_string(N) + " rows");
+    }
+
+    constexpr double tolerance = 1e-9;
+    if (!correlation.isApprox(correlation.transpose(), tolerance) || (correlation.diagonal().array() - 1.0).abs().maxCoeff() > tolerance) {
+      throw std::invalid_argument("The " + name + " correlation matrix has to be symmetric with a unit diagonal");
+    }
+
+    const Eigen::SelfAdjointEigenSolver<matrix_t> solver(correlation);
+    if (solver.eigenvalues().minCoeff() < -tolerance) {
+      throw std::invalid_argument("The " + name + " correlation matrix is not positive semi-definite");
+    }
+
+    return solver.eigenvectors() * solver.eigenvalues().cwiseMax(0.0).cwiseSqrt().asDiagonal();
+  }
 
-    for (int i = 0; i < 7; ++i) {
-      eigenValueMatrix(i, i) = std::sqrt(eigenValues(i));
+  void DataBase::construct_correlation_matrices() {
+    const auto correlations = m_InputOptions.config_tree().get_child_optional("Correlations");
+    if (!correlations) {
+      return;
     }
 
-    m_EnergyCorrelationMatrix.Mult(eigenVectors, eigenValueMatrix);
+    m_EnergyCorrelationMatrix        = read_correlation_factor<7>(*correlations, "energy");
+    m_MCNormCorrelationMatrix        = read_correlation_factor<3>(*correlations, "mcNorm");
+    m_InterDetectorCorrelationMatrix = read_correlation_factor<3>(*correlations, "interDetector");
   }
 
   std::vector<double> generate_lithium_background(std::default_random_engine& gen, std::size_t num_samples) {
@@ -385,19 +432,22 @@ namespace io::dc {
           lower = 0;
           break;
         case FDII:
-          lower = 44;
+          lower = io::dc::Constants::number_of_spectrum_bins;
           break;
         case ND:
-          lower = 88;
+          lower = 2 * io::dc::Constants::number_of_spectrum_bins;
           break;
         default:
           throw std::invalid_argument("Detector now implemented");
       }
 
-      Eigen::MatrixXd covMatrix = Eigen::Array<double, 43, 43>::Zero();
+      constexpr int nCov  = io::dc::Constants::number_of_covariance_bins;
+      constexpr int nBins = io::dc::Constants::number_of_energy_bins;
+
+      Eigen::MatrixXd covMatrix = Eigen::Array<double, nCov, nCov>::Zero();
 
-      for (unsigned int i = lower, a = 0; i < lower + 38; ++i, ++a) {
-        for (unsigned int j = lower, b = 0; j < lower + 38; ++j, ++b) {
+      for (unsigned int i = lower, a = 0; i < lower + nBins; ++i, ++a) {
+        for (unsigned int j = lower, b = 0; j < lower + nBins; ++j, ++b) {
           covMatrix(a, b) = (*ROOT_matrix)(i, j);
         }
       }
@@ -418,15 +468,12 @@ namespace io::dc {
       h->Fill(E);
     }
 
-    std::vector<double> binnedSpectrum(38, 0.0);
+    constexpr int numBins = io::dc::Constants::number_of_energy_bins;
 
-    for (int i = 0; i < 38; ++i) {
-      binnedSpectrum[i] = 0.01 * h->GetBinContent(i + 1);
-    }
+    std::vector<double> binnedSpectrum(numBins, 0.0);
 
-    constexpr int numBins = 38;
-    if (binnedSpectrum.size() != numBins) {
-      throw std::invalid_argument("Input spectrum must have exactly 38 bins.");
+    for (int i = 0; i < numBins; ++i) {
+      binnedSpectrum[i] = 0.01 * h->GetBinContent(i + 1);
     }
 
     Eigen::MatrixXd covarianceMatrix = Eigen::MatrixXd::Zero(numBins, numBins);
@@ -461,7 +508,7 @@ namespace io::dc {
 
     // Fractionalize the covariance matrix
     using matrix_t                = Eigen::MatrixXd;
-    matrix_t fractionalCovariance = matrix_t::Zero(43, 43);
+    matrix_t fractionalCovariance = matrix_t::Zero(io::dc::Constants::number_of_covariance_bins, io::dc::Constants::number_of_covariance_bins);
     for (int i = 0; i < numBins; ++i) {
       for (int j = 0; j < numBins; ++j) {
         fractionalCovariance(i, j) = covarianceMatrix(i, j);
@@ -476,14 +523,21 @@ namespace io::dc {
     return fractionalCovariance;
   }
 
-  DataBase::DataBase(const io::InputOptions& inputOptions)
-    : m_InputOptions(inputOptions) {
+  void DataBase::read_input_files(utilities::TaskScheduler& scheduler) {
     using enum params::dc::DetectorType;
 
     std::default_random_engine gen(std::chrono::system_clock::now().time_since_epoch().count());
 
     try {
-      for (auto detector : {ND, FDI, FDII}) {
+      constexpr std::array reactor_detectors = {ND, FDI, FDII};
+
+      // Every detector has its own file, which is read as a separate task into its own slot
+      std::array<std::shared_ptr<ReactorData>, reactor_detectors.size()> reactor_data;
+      utilities::TaskGroup                                                reading(scheduler);
+
+      for (std::size_t d = 0; d < reactor_detectors.size(); ++d) {
+        const auto detector = reactor_detectors[d];
+
         // In the usual case, the input paths are read from the configuration file.
         // Here they are generated on the fly.
         // const auto& paths = m_InputOptions.double_chooz().input_paths(detector);
@@ -518,11 +572,18 @@ namespace io::dc {
         }
 
         // std::cout << "Generating " << std::setw(10) << num_samples << " samples for reactor data set for " << name << '\n';
-        auto reactor_tree_entries = read_reactor_root_file(m_InputOptions.double_chooz().input_paths(detector));
+        reading.run([this, &data = reactor_data[d], detector] {
+          auto reactor_tree_entries = read_reactor_root_file(m_InputOptions.double_chooz().input_paths(detector));
 
-        m_ReactorData[detector] = std::make_shared<ReactorData>(reactor_tree_entries, detector);
+          data = std::make_shared<ReactorData>(reactor_tree_entries, detector);
+        });
+      }
 
+      reading.wait();
+      for (std::size_t d = 0; d < reactor_detectors.size(); ++d) {
+        m_ReactorData[reactor_detectors[d]] = std::move(reactor_data[d]);
       }
+
       // FDI, FDII, ND
       auto m = read_reactor_cov(m_InputOptions.double_chooz().input_paths(ND).reactor_covariance_matrix_path()); //generate_reactor_covariance_matrix(m_ReactorData[detector]->evis());
 
@@ -587,6 +648,75 @@ namespace io::dc {
       //   m_CovarianceMatrices[key_pair] = get_bkg_cov_matrix(m_BackgroundData[key_pair]); // TODO Read from Double Chooz files
       // }
     }
+  }
+
+  void DataBase::generate_synthetic_data() {
+    using enum params::dc::DetectorType;
+    using enum params::dc::SpectrumType;
+
+    // A fixed seed keeps the synthetic samples identical between runs, so timings of different builds are comparable
+    std::default_random_engine gen(m_InputOptions.seed());
+
+    const double scale = m_InputOptions.double_chooz().synthetic_scale();
+
+    auto scaled = [scale](std::size_t n) { return std::max<std::size_t>(1, static_cast<std::size_t>(scale * static_cast<double>(n))); };
+
+    for (const auto detector : {ND, FDI, FDII}) {
+      // Same sample sizes and baselines as the generated reactor samples of the production data base
+      std::size_t num_samples;
+      double      ratio, p1, p2;
+      switch (detector) {
+        case ND:
+          ratio       = 0.6;
+          num_samples = 6'000'000;
+          p1          = 355.0;
+          p2          = 470.0;
+          break;
+        case FDI:
+          ratio       = 0.5;
+          num_samples = 5'000'000;
+          p1          = 997.0;
+          p2          = 1115.0;
+          break;
+        case FDII:
+          ratio       = 0.55;
+          num_samples = 10'000'000;
+          p1          = 997.0;
+          p2          = 1115.0;
+          break;
+        default:
+          throw std::invalid_argument("Detector type unknown");
+      }
+
+      std::cout << "Generating " << std::setw(10) << scaled(num_samples) << " samples for reactor data set for " << get_detector_name(detector) << '\n';
+      auto reactor_tree_entries = generate_reactor_entries(gen, scaled(num_samples), ratio, p1, p2);
+
+      m_ReactorData[detector] = std::make_shared<ReactorData>(reactor_tree_entries, detector);
+
+      m_CovarianceMatrices[{detector, reactor}] = std::make_shared<Eigen::MatrixXd>(generate_reactor_covariance_matrix(m_ReactorData[detector]->evis()));
+
+      auto add_background = [this, detector](params::dc::SpectrumType type, std::vector<double> entries) {
+        std::ranges::sort(entries);
+        const auto key_pair            = std::make_tuple(detector, type);
+        m_BackgroundData[key_pair]     = std::move(entries);
+        m_CovarianceMatrices[key_pair] = get_bkg_cov_matrix(m_BackgroundData[key_pair]);
+      };
+
+      add_background(accidental, generate_accidental_background(gen, scaled(40'000)));
+      add_background(lithium, generate_lithium_background(gen, scaled(650'000)));
+      add_background(fastN, generate_fastN_background(gen, scaled(2'000'000)));
+    }
+  }
+
+  DataBase::DataBase(const io::InputOptions& inputOptions, utilities::TaskScheduler& scheduler)
+    : m_InputOptions(inputOptions) {
+    using enum params::dc::DetectorType;
+
+    if (m_InputOptions.double_chooz().synthetic()) {
+      generate_synthetic_data();
+    } else {
+      read_input_files(scheduler);
+    }
 
     auto string_to_DetectorType = [](std::string_view name) -> params::dc::DetectorType {
       if (name == "ND") {
@@ -641,6 +771,8 @@ namespace io::dc {
     } else {
       throw std::invalid_argument("Energy central values for the EnergyA parameter are not the same for all detectors!");
     }
+
+    construct_correlation_matrices();
   }
 
   std::string get_spectrum_type_string(params::dc::SpectrumType type) {
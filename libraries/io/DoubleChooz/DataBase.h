@@ -3,6 +3,7 @@
 #include "../InputOptions.h"
 #include "../Parameter.h"
 #include "../ReactorData.h"
+#include "TaskScheduler.h"
 
 #include <span>
 #include <string>
@@ -10,8 +11,6 @@
 #include <unordered_map>
 #include <vector>
 
-#include <TMatrixD.h>
-
 #include <Eigen/Core>
 
 namespace io::dc {
@@ -24,11 +23,15 @@ namespace io::dc {
    */
   class DataBase {
    public:
+    using energy_correlation_t   = Eigen::Matrix<double, 7, 7>; ///< EnergyA and EnergyB, EnergyC of FDI, ND and FDII.
+    using detector_correlation_t = Eigen::Matrix3d;             ///< A parameter of FDI, ND and FDII.
+
     /**
      * Constructor
      * @param inputs InputOptions
+     * @param scheduler The task scheduler, the input files of the detectors are read in parallel
      */
-    explicit DataBase(const io::InputOptions& inputs);
+    DataBase(const io::InputOptions& inputs, utilities::TaskScheduler& scheduler);
 
     /** Default destructor */
     ~DataBase() = default;
@@ -67,11 +70,22 @@ namespace io::dc {
 
     [[nodiscard]] std::shared_ptr<Eigen::MatrixXd> covariance_matrix(params::dc::DetectorType detectorType, params::dc::SpectrumType spectrumType) const;
 
-    [[nodiscard]] const TMatrixD& energy_correlation_matrix() const { return m_EnergyCorrelationMatrix; }
+    /**
+     * @brief Returns the factor L of the energy correlation matrix C = L L^T.
+     *
+     * L maps uncorrelated energy parameters onto correlated ones. Without configured correlations it is the identity.
+     */
+    [[nodiscard]] const energy_correlation_t& energy_correlation_matrix() const noexcept { return m_EnergyCorrelationMatrix; }
 
-    [[nodiscard]] const TMatrixD& mcNorm_correlation_matrix() const { return m_MCNormCorrelationMatrix; }
+    /**
+     * @brief Returns the factor L of the correlation matrix of the MC normalizations of the detectors.
+     */
+    [[nodiscard]] const detector_correlation_t& mcNorm_correlation_matrix() const noexcept { return m_MCNormCorrelationMatrix; }
 
-    [[nodiscard]] const TMatrixD& interDetector_correlation_matrix() const { return m_InterDetectorCorrelationMatrix; }
+    /**
+     * @brief Returns the factor L of the correlation matrix of a reactor shape parameter between the detectors.
+     */
+    [[nodiscard]] const detector_correlation_t& interDetector_correlation_matrix() const noexcept { return m_InterDetectorCorrelationMatrix; }
 
     [[nodiscard]] double off_lifetime(params::dc::DetectorType type) const noexcept { return m_OffLifeTime.at(type); }
 
@@ -100,7 +114,30 @@ namespace io::dc {
     }
 
    private:
-    void construct_energy_correlation_matrix();
+    /**
+     * @brief Factorizes the correlation matrices of the "Correlations" section of the configuration.
+     *
+     * The section is optional, as are its entries "energy", "mcNorm" and "interDetector", each an array of rows.
+     * A missing matrix means no correlation.
+     *
+     * @throws std::invalid_argument if a matrix has the wrong size or is not a correlation matrix.
+     */
+    void construct_correlation_matrices();
+
+    /**
+     * @brief Reads the reactor and background samples and the covariance matrices from the input files.
+     *
+     * @param scheduler The task scheduler, the reactor files of the detectors are read as separate tasks.
+     */
+    void read_input_files(utilities::TaskScheduler& scheduler);
+
+    /**
+     * @brief Generates the reactor and background samples and the covariance matrices in memory.
+     *
+     * Used for benchmarks and tests, where no input files are available. The samples are drawn with the global
+     * seed, so the data base is reproducible.
+     */
+    void generate_synthetic_data();
 
     const io::InputOptions& m_InputOptions;
 
@@ -163,9 +200,9 @@ namespace io::dc {
     using cov_matrix_t = std::shared_ptr<Eigen::MatrixXd>;
     std::unordered_map<tuple_t, cov_matrix_t, KeyHash>        m_CovarianceMatrices;
     std::unordered_map<tuple_t, std::vector<double>, KeyHash> m_BackgroundData;
-    TMatrixD                                                  m_EnergyCorrelationMatrix;         // TODO Replace with Eigen Matrix
-    TMatrixD                                                  m_MCNormCorrelationMatrix;         // TODO Replace with Eigen Matrix
-    TMatrixD                                                  m_InterDetectorCorrelationMatrix;  // TODO Replace with Eigen Matrix
+    energy_correlation_t                                      m_EnergyCorrelationMatrix        = energy_correlation_t::Identity();
+    detector_correlation_t                                    m_MCNormCorrelationMatrix        = detector_correlation_t::Identity();
+    detector_correlation_t                                    m_InterDetectorCorrelationMatrix = detector_correlation_t::Identity();
   };
 
 }  // namespace io::dc
@@ -15,8 +15,34 @@ namespace io {
   InputOptions::InputOptions(int argc, char** argv)
     : m_Seed(std::chrono::system_clock::now().time_since_epoch().count())
     , m_Silent(false)
-    , m_MultiThreadingCores(-1) {
-    std::string inputFile;
+    , m_MultiThreadingCores(-1)
+    , m_CheckpointInterval(600.0)
+    , m_Resume(false)
+    , m_Hesse(false)
+    , m_ProfileNuisances(false)
+    , m_HardwareCounters(false)
+    , m_TimelineCapacity(1 << 18)
+    , m_ResultSpectra(true)
+    , m_CoarseBins(0) {
+    parse(argc, argv, nullptr);
+  }
+
+  InputOptions::InputOptions(int argc, char** argv, const boost::property_tree::ptree& config)
+    : m_Seed(std::chrono::system_clock::now().time_since_epoch().count())
+    , m_Silent(false)
+    , m_MultiThreadingCores(-1)
+    , m_CheckpointInterval(600.0)
+    , m_Resume(false)
+    , m_Hesse(false)
+    , m_ProfileNuisances(false)
+    , m_HardwareCounters(false)
+    , m_TimelineCapacity(1 << 18)
+    , m_ResultSpectra(true)
+    , m_CoarseBins(0) {
+    parse(argc, argv, &config);
+  }
+
+  void InputOptions::parse(int argc, char** argv, const boost::property_tree::ptree* config) {
     try {
 
       m_DCInputOptions = std::make_shared<dc::DCInputOptions>();
@@ -32,8 +58,25 @@ namespace io {
       ("config,c", po::value<std::string>(&m_ConfigFile)->default_value("config.json")->required(), "Set Config File")
       ("seed", po::value<long>(&m_Seed)->default_value(current_time), "Set seed for simulation")
       ("silent", po::bool_switch(&m_Silent), "Run fit in silence mode")
-      ("multiThreading,m", po::value<int>(&m_MultiThreadingCores)->default_value(1), "Use multiple threads for fitting")
+      ("multiThreading,m", po::value<int>(&m_MultiThreadingCores)->default_value(1), "Number of threads of the task scheduler shared by all parallel parts of the fit, 0 uses all hardware threads")
+      ("memoryPlacement", po::value<std::string>(&m_MemoryPlacement)->default_value("default"), "Placement of the reactor events: default, hugepages, interleave over the NUMA nodes, or local to the pinned threads oscillating them")
       ("tolerance", po::value<double>(&m_Tolerance)->default_value(0.05), "Set Fit tolerance")
+      ("checkpoint", po::value<std::string>(&m_CheckpointFile)->default_value(""), "Periodically write the fit state to this file")
+      ("checkpointInterval", po::value<double>(&m_CheckpointInterval)->default_value(600.0), "Minimal time between two checkpoint writes in seconds")
+      ("resume", po::bool_switch(&m_Resume), "Resume from the checkpoint file if it exists")
+      ("warmStart", po::value<std::string>(&m_WarmStartDirectory)->default_value(""), "Seed the fit from the last best fit of the same configuration stored in this directory")
+      ("minimizer", po::value<std::string>(&m_Minimizer)->default_value("Migrad"), "Set the minimizer backend: Migrad, Fumili or LBFGS")
+      ("hesse", po::bool_switch(&m_Hesse), "Run Hesse after the minimization to calculate the error matrix")
+      ("profileNuisances", po::bool_switch(&m_ProfileNuisances), "Profile the linear shape nuisance parameters analytically instead of minimizing them")
+      ("fitStages", po::value<std::string>(&m_FitStages)->default_value("none"), "Release the shape parameters in stages: none, component or detector")
+      ("experiments", po::value<std::string>(&m_Experiments)->default_value("DoubleChooz"), "Comma separated experiments of a combined fit with shared oscillation parameters: DoubleChooz or DoubleChooz,JUNO")
+      ("coarseFit", po::value<unsigned int>(&m_CoarseBins)->default_value(0), "Minimize first on a reactor MC pre-binned into this many L/E bins per energy bin, 0 disables the coarse level")
+      ("trace", po::value<std::string>(&m_TraceFile)->default_value(""), "Record all likelihood calls of the fit in this binary trace file for ReplayTrace")
+      ("perfCounters", po::bool_switch(&m_HardwareCounters), "Sample cycles, instructions, cache and branch misses with perf_event_open (Linux only)")
+      ("timeline", po::value<std::string>(&m_TimelineFile)->default_value(""), "Write a Chrome trace timeline of the fits to this file")
+      ("timelineCapacity", po::value<std::size_t>(&m_TimelineCapacity)->default_value(1 << 18), "Maximal number of timeline events per thread")
+      ("resultFormat", po::value<std::string>(&m_ResultFormat)->default_value("json"), "Set the result format: json or binary")
+      ("resultSpectra", po::value<bool>(&m_ResultSpectra)->default_value(true), "Store the predicted spectra in binary result files")
       ;
 
       po::options_description cmdline_options;
@@ -55,12 +98,18 @@ namespace io {
       using option_ptr_t = std::shared_ptr<InputOptionBase>;
       namespace pt       = boost::property_tree;
 
-      if (!boost::filesystem::exists(m_ConfigFile)) {
-        throw std::invalid_argument("Error: Config File " + m_ConfigFile + " not found");
-      }
+      if (config != nullptr) {
+        // The configuration was handed over in memory, e.g. by the benchmarks
+        m_ConfigFile.clear();
+        m_ConfigTree = *config;
+      } else {
+        if (!boost::filesystem::exists(m_ConfigFile)) {
+          throw std::invalid_argument("Error: Config File " + m_ConfigFile + " not found");
+        }
 
-      std::cout << "Reading Config File: " << m_ConfigFile << '\n';
-      pt::read_json(m_ConfigFile, m_ConfigTree);
+        std::cout << "Reading Config File: " << m_ConfigFile << '\n';
+        pt::read_json(m_ConfigFile, m_ConfigTree);
+      }
 
       m_InputParameter = std::make_shared<InputParameter>(m_ConfigTree.get_child("Parameter"));
 
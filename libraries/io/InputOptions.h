@@ -27,6 +27,17 @@ namespace io {
      */
     InputOptions(int argc, char** argv);
 
+    /**
+     * @brief Constructor that initializes the input options with a configuration tree held in memory.
+     *
+     * The --config option is ignored, everything else is read from the command line arguments.
+     *
+     * @param argc The number of command line arguments.
+     * @param argv The array of command line arguments.
+     * @param config The configuration tree, with the same layout as the config file.
+     */
+    InputOptions(int argc, char** argv, const boost::property_tree::ptree& config);
+
     /** Default destructor */
     ~InputOptions() = default;
 
@@ -52,15 +63,165 @@ namespace io {
 
     [[nodiscard]] int multi_threading_cores() const noexcept { return m_MultiThreadingCores; }
 
+    /**
+     * @brief Returns the memory placement of the reactor events: default, hugepages, interleave or local.
+     */
+    [[nodiscard]] const std::string& memory_placement() const noexcept { return m_MemoryPlacement; }
+
     [[nodiscard]] const boost::property_tree::ptree& config_tree() const noexcept { return m_ConfigTree; }
 
     [[nodiscard]] double tolerance() const noexcept { return m_Tolerance; }
 
+    /**
+     * @brief Get the path of the checkpoint file.
+     *
+     * @return The checkpoint file path, empty if checkpointing is disabled.
+     */
+    [[nodiscard]] const std::string& checkpoint_file() const noexcept { return m_CheckpointFile; }
+
+    /**
+     * @brief Get the minimal time between two periodic checkpoint writes.
+     *
+     * @return The checkpoint interval in seconds.
+     */
+    [[nodiscard]] double checkpoint_interval() const noexcept { return m_CheckpointInterval; }
+
+    /**
+     * @brief Check if the fit should be resumed from an existing checkpoint.
+     *
+     * @return True if the fit should be resumed, false otherwise.
+     */
+    [[nodiscard]] bool resume() const noexcept { return m_Resume; }
+
+    /**
+     * @brief Get the directory of the warm-start store.
+     *
+     * @return The warm-start directory, empty if warm starts are disabled.
+     */
+    [[nodiscard]] const std::string& warm_start_directory() const noexcept { return m_WarmStartDirectory; }
+
+    /**
+     * @brief Get the name of the minimizer backend.
+     *
+     * @return The minimizer backend, i.e. Migrad, Fumili or LBFGS.
+     */
+    [[nodiscard]] const std::string& minimizer() const noexcept { return m_Minimizer; }
+
+    /**
+     * @brief Check if Hesse should be run after the minimization for every backend.
+     *
+     * @return True if Hesse should always be run, false if only for backends without error matrix.
+     */
+    [[nodiscard]] bool hesse() const noexcept { return m_Hesse; }
+
+    /**
+     * @brief Check if the linear nuisance parameters should be profiled analytically.
+     *
+     * @return True if the linear nuisance parameters are hidden from the minimizer, false otherwise.
+     */
+    [[nodiscard]] bool profile_nuisances() const noexcept { return m_ProfileNuisances; }
+
+    /**
+     * @brief Get the staged fit strategy.
+     *
+     * @return The strategy, i.e. none, component or detector.
+     */
+    [[nodiscard]] const std::string& fit_stages() const noexcept { return m_FitStages; }
+
+    /**
+     * @brief Get the experiments of the fit.
+     *
+     * @return The comma separated experiment names, e.g. DoubleChooz,JUNO.
+     */
+    [[nodiscard]] const std::string& experiments() const noexcept { return m_Experiments; }
+
+    /**
+     * @brief Get the number of L/E bins per energy bin of the reactor MC of the coarse fit level.
+     *
+     * @return The number of bins, 0 if the fit is performed on the full reactor MC only.
+     */
+    [[nodiscard]] unsigned int coarse_bins() const noexcept { return m_CoarseBins; }
+
+    /**
+     * @brief Get the path of the likelihood trace file.
+     *
+     * @return The trace file path, empty if the likelihood calls are not recorded.
+     */
+    [[nodiscard]] const std::string& trace_file() const noexcept { return m_TraceFile; }
+
+    /**
+     * @brief Check if the hardware performance counters should be sampled.
+     *
+     * @return True if cycles, instructions, cache and branch misses are counted per fit and per component stage.
+     */
+    [[nodiscard]] bool hardware_counters() const noexcept { return m_HardwareCounters; }
+
+    /**
+     * @brief Get the path of the Chrome trace timeline file.
+     *
+     * @return The timeline file path, empty if no timeline is recorded.
+     */
+    [[nodiscard]] const std::string& timeline_file() const noexcept { return m_TimelineFile; }
+
+    /**
+     * @brief Get the capacity of the timeline buffers.
+     *
+     * @return The maximum number of timeline events per thread.
+     */
+    [[nodiscard]] std::size_t timeline_capacity() const noexcept { return m_TimelineCapacity; }
+
+    /**
+     * @brief Get the result format.
+     *
+     * @return The format, i.e. json or binary.
+     */
+    [[nodiscard]] const std::string& result_format() const noexcept { return m_ResultFormat; }
+
+    /**
+     * @brief Check if the predicted spectra are stored in binary result files.
+     *
+     * @return True if the spectra are stored.
+     */
+    [[nodiscard]] bool result_spectra() const noexcept { return m_ResultSpectra; }
+
    private:
+    /**
+     * @brief Parses the command line arguments and reads the configuration.
+     *
+     * @param config The configuration tree, or a nullptr to read it from the config file.
+     */
+    void parse(int argc, char** argv, const boost::property_tree::ptree* config);
+
     long m_Seed;                /**< The global random seed. */
     bool m_Silent;              /**< Flag indicating if the program should run in silent mode. */
     int  m_MultiThreadingCores; /**< The number of cores to use for multi-threading. */
     double m_Tolerance;         /**< The tolerance for the minimizer. */
+    double m_CheckpointInterval; /**< The minimal time between two checkpoint writes in seconds. */
+    bool   m_Resume;             /**< Flag indicating if the fit should be resumed from a checkpoint. */
+    bool   m_Hesse;              /**< Flag indicating if Hesse should be run after every minimization. */
+    bool   m_ProfileNuisances;   /**< Flag indicating if the linear nuisance parameters are profiled analytically. */
+    bool   m_HardwareCounters;   /**< Flag indicating if the hardware performance counters are sampled. */
+    std::size_t m_TimelineCapacity; /**< The maximum number of timeline events per thread. */
+    bool   m_ResultSpectra;      /**< Flag indicating if the spectra are stored in binary result files. */
+    unsigned int m_CoarseBins;   /**< The number of L/E bins per energy bin of the coarse fit level, 0 to disable it. */
+
+    std::string m_CheckpointFile; /**< The checkpoint file path. */
+
+    std::string m_WarmStartDirectory; /**< The directory of the warm-start store. */
+
+    std::string m_Minimizer; /**< The minimizer backend. */
+
+    std::string m_FitStages; /**< The staged fit strategy. */
+
+    std::string m_Experiments; /**< The comma separated experiments of the fit. */
+
+    std::string m_TraceFile; /**< The likelihood trace file path. */
+
+    std::string m_TimelineFile; /**< The Chrome trace timeline file path. */
+
+    std::string m_ResultFormat; /**< The result format. */
+
+    std::string m_MemoryPlacement; /**< The memory placement of the reactor events. */
 
     std::string m_ConfigFile; /**< The configuration file path. */
 
@@ -1,4 +1,36 @@
 #include "Options.h"
 
+// includes
+#include "MemoryPlacement.h"
+
+// STL includes
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+// ROOT includes
+#include <TROOT.h>
+
 namespace io {
-}  // namespace io
\ No newline at end of file
+
+  std::unique_ptr<utilities::TaskScheduler> Options::make_scheduler(const InputOptions& inputOptions) {
+    const int cores = inputOptions.multi_threading_cores();
+    if (cores < 0) {
+      throw std::invalid_argument("The number of threads must not be negative");
+    }
+
+    // 0 uses all hardware threads
+    const unsigned int threads = (cores == 0) ? std::max(std::thread::hardware_concurrency(), 1U) : static_cast<unsigned int>(cores);
+
+    // ROOT has to be made thread-safe before files are read on several threads
+    if (threads > 1) {
+      ROOT::EnableThreadSafety();
+    }
+
+    // The local placement relies on the threads staying on the node of the memory they touched first
+    const bool pin = utilities::parse_memory_placement(inputOptions.memory_placement()) == utilities::MemoryPlacement::Local;
+
+    return std::make_unique<utilities::TaskScheduler>(threads, pin);
+  }
+
+}  // namespace io
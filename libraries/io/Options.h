@@ -3,6 +3,10 @@
 #include "DoubleChooz/DataBase.h"
 #include "InputOptions.h"
 #include "DoubleChooz/DCOptions.h"
+#include "TaskScheduler.h"
+
+// STL includes
+#include <memory>
 
 namespace io {
 
@@ -19,7 +23,19 @@ namespace io {
      */
     Options(int argc, char** argv)
       : m_InputOptions(argc, argv)
-      , m_DCOptions(m_InputOptions) {}
+      , m_Scheduler(make_scheduler(m_InputOptions))
+      , m_DCOptions(m_InputOptions, *m_Scheduler) {}
+
+    /**
+     * Constructor with a configuration tree held in memory
+     * @param argc Command line argc
+     * @param argv Command line argv
+     * @param config The configuration tree
+     */
+    Options(int argc, char** argv, const boost::property_tree::ptree& config)
+      : m_InputOptions(argc, argv, config)
+      , m_Scheduler(make_scheduler(m_InputOptions))
+      , m_DCOptions(m_InputOptions, *m_Scheduler) {}
 
     /** Default constructor */
     Options()
@@ -40,8 +56,22 @@ namespace io {
      */
     [[nodiscard]] const InputOptions& inputOptions() const noexcept { return m_InputOptions; }
 
+    /**
+     * Accessor for the task scheduler of the process, sized by the multiThreading option
+     * @return The scheduler all parallel features run their tasks on
+     */
+    [[nodiscard]] utilities::TaskScheduler& scheduler() const noexcept { return *m_Scheduler; }
+
    private:
+    /**
+     * Creates the task scheduler with the number of threads of the multiThreading option
+     * @param inputOptions The parsed input options
+     * @return The scheduler
+     */
+    static std::unique_ptr<utilities::TaskScheduler> make_scheduler(const InputOptions& inputOptions);
+
     InputOptions m_InputOptions;
+    std::unique_ptr<utilities::TaskScheduler> m_Scheduler;  // The scheduler is created before the data base, which reads its files in parallel
     dc::DCOptions m_DCOptions;
   };
 
@@ -0,0 +1,81 @@
+#include "ParameterRegistry.h"
+
+// STL includes
+#include <algorithm>
+#include <stdexcept>
+
+namespace params {
+
+  ParameterRegistry::ParameterRegistry(int number_of_parameters)
+    : m_Slots(number_of_parameters, -1) {
+    if (number_of_parameters < 0) {
+      throw std::invalid_argument("The number of parameters must not be negative");
+    }
+  }
+
+  void ParameterRegistry::add_component(std::string name, const std::vector<Block>& blocks) {
+    if (m_Finalized) {
+      throw std::invalid_argument("The parameter layout is finalized, the component " + name + " cannot be added");
+    }
+
+    // Check all blocks first, so a failed registration leaves the layout untouched
+    std::vector<char> used(m_Slots.size(), 0);
+    for (const auto [first, end] : blocks) {
+      if (first < 0 || end > size() || end <= first) {
+        throw std::invalid_argument("The component " + name + " has an invalid parameter block [" + std::to_string(first) + ", " + std::to_string(end) + ")");
+      }
+      for (int idx = first; idx < end; ++idx) {
+        if (m_Slots[idx] >= 0 || used[idx]) {
+          throw std::invalid_argument("The parameter " + std::to_string(idx) + " of the component " + name + " is already registered");
+        }
+        used[idx] = 1;
+      }
+    }
+
+    Component component{std::move(name), m_NextSlot, 0};
+    for (const auto [first, end] : blocks) {
+      for (int idx = first; idx < end; ++idx) {
+        m_Slots[idx] = m_NextSlot++;
+      }
+    }
+    component.size = m_NextSlot - component.offset;
+
+    m_Components.push_back(std::move(component));
+  }
+
+  void ParameterRegistry::finalize() {
+    if (m_Finalized) {
+      return;
+    }
+
+    std::vector<Block> unassigned;
+    for (int idx = 0; idx < size(); ++idx) {
+      if (m_Slots[idx] < 0) {
+        unassigned.push_back(block(idx));
+      }
+    }
+
+    if (!unassigned.empty()) {
+      add_component("Unassigned", unassigned);
+    }
+    m_Finalized = true;
+  }
+
+  const ParameterRegistry::Component& ParameterRegistry::component(std::string_view name) const {
+    const auto it = std::ranges::find(m_Components, name, &Component::name);
+    if (it == m_Components.end()) {
+      throw std::invalid_argument("No component " + std::string(name) + " in the parameter layout");
+    }
+    return *it;
+  }
+
+  bool ParameterRegistry::contiguous(int first, int last) const noexcept {
+    for (int idx = first; idx < last; ++idx) {
+      if (m_Slots[idx + 1] != m_Slots[idx] + 1) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+}  // namespace params
@@ -0,0 +1,114 @@
+#pragma once
+
+// includes
+#include "Parameter.h"
+
+// STL includes
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace params {
+
+  /**
+   * @class ParameterRegistry
+   * @brief Runtime layout of the parameter vector, in which the parameters of every component are contiguous.
+   *
+   * The fit and the config file address the parameters with the indices of params::index, where the general
+   * parameters are followed by one block per detector. A component, e.g. the shape correction, therefore reads
+   * parameters which are more than a hundred doubles apart. At startup every enabled component registers the
+   * blocks of parameters it reads, and the registry assigns consecutive slots to them in the order of registration.
+   * The parameters no component registered are appended at the end. The indices of params::index stay the
+   * interface, the registry only maps them onto the slots.
+   */
+  class ParameterRegistry {
+   public:
+    /**
+     * @brief A range [first, end) of params::index indices, its order is kept in the layout.
+     */
+    struct Block {
+      int first;  ///< The index of the first parameter.
+      int end;    ///< The index after the last parameter.
+    };
+
+    /**
+     * @brief The slots of a component in the layout.
+     */
+    struct Component {
+      std::string name;        ///< The name of the component.
+      int         offset = 0;  ///< The slot of the first parameter.
+      int         size   = 0;  ///< The number of parameters.
+    };
+
+    /**
+     * @brief Constructs an empty layout.
+     *
+     * @param number_of_parameters The number of parameters of the likelihood.
+     */
+    explicit ParameterRegistry(int number_of_parameters);
+
+    /**
+     * @brief Returns the block of a single parameter.
+     */
+    [[nodiscard]] static Block block(int idx) noexcept { return {idx, idx + 1}; }
+
+    /**
+     * @brief Returns the block of the detector parameters first to last of a detector, both included.
+     */
+    [[nodiscard]] static Block block(dc::DetectorType detector, dc::Detector first, dc::Detector last) noexcept {
+      return {index(detector, first), index(detector, last) + 1};
+    }
+
+    /**
+     * @brief Appends the blocks of a component contiguously to the layout.
+     *
+     * @param name The name of the component.
+     * @param blocks The blocks of the parameters the component reads.
+     * @throws std::invalid_argument if the layout is finalized, a block is out of range or a parameter already
+     *         belongs to another component.
+     */
+    void add_component(std::string name, const std::vector<Block>& blocks);
+
+    /**
+     * @brief Appends the parameters no component registered and fixes the layout.
+     */
+    void finalize();
+
+    [[nodiscard]] bool finalized() const noexcept { return m_Finalized; }
+
+    [[nodiscard]] int size() const noexcept { return static_cast<int>(m_Slots.size()); }
+
+    /**
+     * @brief Returns the slot of a parameter, the layout has to be finalized.
+     *
+     * @param idx The index of the parameter, see params::index.
+     */
+    [[nodiscard]] int slot(int idx) const noexcept { return m_Slots[idx]; }
+
+    /**
+     * @brief Returns the slot of every parameter, the layout has to be finalized.
+     */
+    [[nodiscard]] const std::vector<int>& slots() const noexcept { return m_Slots; }
+
+    [[nodiscard]] const std::vector<Component>& components() const noexcept { return m_Components; }
+
+    /**
+     * @brief Returns the slots of a component.
+     *
+     * @throws std::invalid_argument if no component with this name was registered.
+     */
+    [[nodiscard]] const Component& component(std::string_view name) const;
+
+    /**
+     * @brief Checks whether the parameters first to last, both included, have consecutive slots.
+     */
+    [[nodiscard]] bool contiguous(int first, int last) const noexcept;
+
+   private:
+    std::vector<int>       m_Slots;              ///< The slot of every parameter, -1 if it is not registered yet.
+    std::vector<Component> m_Components;         ///< The registered components in the order of the layout.
+    int                    m_NextSlot  = 0;      ///< The first free slot.
+    bool                   m_Finalized = false;  ///< Whether the layout is fixed.
+  };
+
+}  // namespace params
@@ -0,0 +1,164 @@
+#include "Checkpoint.h"
+
+// STL includes
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+// boost includes
+#include <boost/filesystem.hpp>
+
+namespace ana {
+
+  namespace {
+    constexpr std::array<char, 8> checkpoint_magic   = {'P', 'L', 'N', 'O', 'C', 'K', 'P', 'T'};
+    constexpr std::uint32_t       checkpoint_version = 1;
+
+    template <typename T>
+    void write_value(std::ostream& os, const T& value) {
+      os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void write_vector(std::ostream& os, const std::vector<T>& values) {
+      write_value(os, static_cast<std::uint64_t>(values.size()));
+      os.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+
+    void write_strings(std::ostream& os, const std::vector<std::string>& strings) {
+      write_value(os, static_cast<std::uint64_t>(strings.size()));
+      for (const auto& s : strings) {
+        write_value(os, static_cast<std::uint64_t>(s.size()));
+        os.write(s.data(), static_cast<std::streamsize>(s.size()));
+      }
+    }
+
+    template <typename T>
+    T read_value(std::istream& is) {
+      T value{};
+      is.read(reinterpret_cast<char*>(&value), sizeof(T));
+      if (!is) {
+        throw std::runtime_error("Unexpected end of checkpoint file");
+      }
+      return value;
+    }
+
+    template <typename T>
+    std::vector<T> read_vector(std::istream& is) {
+      std::vector<T> values(read_value<std::uint64_t>(is));
+      is.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+      if (!is) {
+        throw std::runtime_error("Unexpected end of checkpoint file");
+      }
+      return values;
+    }
+
+    std::vector<std::string> read_strings(std::istream& is) {
+      std::vector<std::string> strings(read_value<std::uint64_t>(is));
+      for (auto& s : strings) {
+        s.resize(read_value<std::uint64_t>(is));
+        is.read(s.data(), static_cast<std::streamsize>(s.size()));
+      }
+      if (!is) {
+        throw std::runtime_error("Unexpected end of checkpoint file");
+      }
+      return strings;
+    }
+  }  // namespace
+
+  void write_fit_state(std::ostream& os, const FitState& state) {
+    write_strings(os, state.names);
+    write_vector(os, state.parameters);
+    write_vector(os, state.errors);
+    write_vector(os, state.covariance);
+    write_value(os, state.min_value);
+    write_value(os, state.n_calls);
+    write_value(os, state.finished);
+  }
+
+  FitState read_fit_state(std::istream& is) {
+    FitState state;
+    state.names      = read_strings(is);
+    state.parameters = read_vector<double>(is);
+    state.errors     = read_vector<double>(is);
+    state.covariance = read_vector<double>(is);
+    state.min_value  = read_value<double>(is);
+    state.n_calls    = read_value<std::uint64_t>(is);
+    state.finished   = read_value<bool>(is);
+    return state;
+  }
+
+  Checkpoint::Checkpoint(std::string path, double interval)
+    : m_Path(std::move(path))
+    , m_Interval(interval)
+    , m_LastSave(std::chrono::steady_clock::now()) {}
+
+  bool Checkpoint::exists() const {
+    return boost::filesystem::exists(m_Path);
+  }
+
+  void Checkpoint::load() {
+    std::ifstream file(m_Path, std::ios::binary);
+    if (!file) {
+      throw std::runtime_error("Could not open checkpoint file " + m_Path);
+    }
+
+    std::array<char, 8> magic{};
+    file.read(magic.data(), magic.size());
+    if (!file || magic != checkpoint_magic) {
+      throw std::runtime_error(m_Path + " is not a checkpoint file");
+    }
+
+    if (const auto version = read_value<std::uint32_t>(file); version != checkpoint_version) {
+      throw std::runtime_error("Unsupported checkpoint version " + std::to_string(version) + " in " + m_Path);
+    }
+
+    FitState state = read_fit_state(file);
+
+    m_Completed = read_vector<CampaignTask>(file);
+    m_FitState  = std::move(state);
+
+    std::cout << "Resuming from checkpoint " << m_Path << " with " << m_Completed.size() << " completed tasks and "
+              << m_FitState.n_calls << " likelihood calls in the running fit\n";
+  }
+
+  void Checkpoint::save() {
+    // Write to a temporary file first and rename it afterward, which is atomic on POSIX file systems
+    const std::string tmp_path = m_Path + ".tmp";
+    {
+      std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+      if (!file) {
+        throw std::runtime_error("Could not write checkpoint file " + tmp_path);
+      }
+
+      file.write(checkpoint_magic.data(), checkpoint_magic.size());
+      write_value(file, checkpoint_version);
+
+      write_fit_state(file, m_FitState);
+      write_vector(file, m_Completed);
+    }
+
+    boost::filesystem::rename(tmp_path, m_Path);
+
+    m_LastSave = std::chrono::steady_clock::now();
+  }
+
+  bool Checkpoint::due() const noexcept {
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_LastSave;
+    return elapsed.count() >= m_Interval;
+  }
+
+  bool Checkpoint::completed(const std::uint64_t index) const noexcept {
+    return std::ranges::any_of(m_Completed, [index](const CampaignTask& task) { return task.index == index; });
+  }
+
+  void Checkpoint::mark_completed(const std::uint64_t index, const double value) {
+    if (!completed(index)) {
+      m_Completed.push_back({index, value});
+    }
+    reset_fit_state();
+  }
+
+}  // namespace ana
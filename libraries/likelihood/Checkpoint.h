@@ -0,0 +1,132 @@
+#pragma once
+
+// STL includes
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace ana {
+
+  /**
+   * @brief State of a single fit as it is stored in a checkpoint file.
+   *
+   * The parameter values are the best point visited so far. Errors and covariance are only filled once the
+   * minimizer provided them, i.e. after the minimization has finished.
+   */
+  struct FitState {
+    std::vector<std::string> names;       ///< The parameter names, used to validate the layout on restore.
+    std::vector<double>      parameters;  ///< The parameter values.
+    std::vector<double>      errors;      ///< The parameter errors, empty if not available.
+    std::vector<double>      covariance;  ///< The row-major covariance matrix, empty if not available.
+    double                   min_value = 0.0;    ///< The likelihood value at the stored parameters.
+    std::uint64_t            n_calls   = 0;      ///< The number of likelihood calls spent so far.
+    bool                     finished  = false;  ///< Whether the minimization has finished.
+
+    [[nodiscard]] bool empty() const noexcept { return parameters.empty(); }
+
+    [[nodiscard]] bool has_covariance() const noexcept { return covariance.size() == parameters.size() * parameters.size(); }
+
+    /**
+     * @brief Returns the covariance element (i, j).
+     */
+    [[nodiscard]] double covariance_at(std::size_t i, std::size_t j) const noexcept { return covariance[i * parameters.size() + j]; }
+  };
+
+  /**
+   * @brief Writes a fit state in binary form to the given stream.
+   */
+  void write_fit_state(std::ostream& os, const FitState& state);
+
+  /**
+   * @brief Reads a fit state in binary form from the given stream.
+   *
+   * @throws std::runtime_error if the stream ends prematurely.
+   */
+  [[nodiscard]] FitState read_fit_state(std::istream& is);
+
+  /**
+   * @brief A completed task of a fit campaign, i.e. a scan point or a toy fit.
+   */
+  struct CampaignTask {
+    std::uint64_t index;  ///< The index of the task within the campaign.
+    double        value;  ///< The scanned parameter value, if any.
+  };
+
+  /**
+   * @class Checkpoint
+   * @brief Periodically serializes the state of a fit campaign, so it can be resumed after preemption.
+   *
+   * A checkpoint holds the state of the currently running fit and the list of already completed tasks of a
+   * scan or toy campaign. It is written atomically, i.e. to a temporary file which is then renamed, so an
+   * interrupted write never corrupts an existing checkpoint.
+   */
+  class Checkpoint {
+   public:
+    /**
+     * @brief Constructs a checkpoint.
+     *
+     * @param path The path of the checkpoint file.
+     * @param interval The minimal time in seconds between two periodic writes.
+     */
+    Checkpoint(std::string path, double interval);
+
+    ~Checkpoint() = default;
+
+    [[nodiscard]] const std::string& path() const noexcept { return m_Path; }
+
+    /**
+     * @brief Checks if a checkpoint file exists at the configured path.
+     */
+    [[nodiscard]] bool exists() const;
+
+    /**
+     * @brief Reads the checkpoint file and replaces the in-memory state.
+     *
+     * @throws std::runtime_error if the file can not be read or is not a checkpoint file.
+     */
+    void load();
+
+    /**
+     * @brief Writes the in-memory state to the checkpoint file.
+     */
+    void save();
+
+    /**
+     * @brief Checks if the periodic write interval has passed since the last write.
+     */
+    [[nodiscard]] bool due() const noexcept;
+
+    [[nodiscard]] FitState& fit_state() noexcept { return m_FitState; }
+
+    [[nodiscard]] const FitState& fit_state() const noexcept { return m_FitState; }
+
+    /**
+     * @brief Discards the state of the running fit, e.g. once its task has been completed.
+     */
+    void reset_fit_state() noexcept { m_FitState = FitState{}; }
+
+    /**
+     * @brief Checks if the task with the given index has already been completed.
+     */
+    [[nodiscard]] bool completed(std::uint64_t index) const noexcept;
+
+    /**
+     * @brief Marks a task as completed and discards the state of its fit.
+     */
+    void mark_completed(std::uint64_t index, double value);
+
+    [[nodiscard]] const std::vector<CampaignTask>& completed_tasks() const noexcept { return m_Completed; }
+
+   private:
+    std::string m_Path;      ///< The path of the checkpoint file.
+    double      m_Interval;  ///< The minimal time between two periodic writes in seconds.
+
+    std::chrono::steady_clock::time_point m_LastSave;  ///< The time of the last write.
+
+    FitState                  m_FitState;   ///< The state of the running fit.
+    std::vector<CampaignTask> m_Completed;  ///< The completed tasks of the campaign.
+  };
+
+}  // namespace ana
@@ -0,0 +1,118 @@
+#include "CompositeLikelihood.h"
+
+// includes
+#include "TaskScheduler.h"
+#include "Timeline.h"
+
+// STL includes
+#include <algorithm>
+#include <stdexcept>
+
+namespace ana {
+
+  namespace {
+    /**
+     * @brief Returns the global name of a parameter of an experiment.
+     */
+    std::string global_name(const CompositeLikelihood::Experiment& experiment, const std::string& name, const std::vector<std::string>& shared_parameters) {
+      if (std::ranges::find(shared_parameters, name) != shared_parameters.end()) {
+        return name;
+      }
+      return experiment.prefix + name;
+    }
+  }  // namespace
+
+  std::vector<std::string> CompositeLikelihood::global_names(const std::vector<Experiment>& experiments, const std::vector<std::string>& shared_parameters) {
+    std::vector<std::string> names;
+
+    for (const auto& experiment : experiments) {
+      for (const auto& name : experiment.parameter_names) {
+        const std::string global = global_name(experiment, name, shared_parameters);
+        const bool        shared = std::ranges::find(shared_parameters, name) != shared_parameters.end();
+
+        if (std::ranges::find(names, global) == names.end()) {
+          names.push_back(global);
+        } else if (!shared) {
+          throw std::invalid_argument("The parameter " + global + " of " + experiment.name + " is not shared, but its global name is already used");
+        }
+      }
+    }
+
+    return names;
+  }
+
+  CompositeLikelihood::CompositeLikelihood(std::shared_ptr<io::Options> options, std::vector<Experiment> experiments, const std::vector<std::string>& shared_parameters)
+    : CompositeLikelihood(std::move(options), global_names(experiments, shared_parameters), experiments) {
+    for (std::size_t e = 0; e < m_Experiments.size(); ++e) {
+      const auto& experiment = m_Experiments[e];
+      auto&       state      = m_States[e];
+
+      for (const auto& name : experiment.parameter_names) {
+        const auto it = std::ranges::find(m_Names, global_name(experiment, name, shared_parameters));
+        state.indices.push_back(static_cast<int>(std::distance(m_Names.begin(), it)));
+      }
+      state.parameters.assign(state.indices.size(), 0.0);
+    }
+  }
+
+  CompositeLikelihood::CompositeLikelihood(std::shared_ptr<io::Options> options, std::vector<std::string> names, std::vector<Experiment> experiments)
+    : Likelihood(std::move(options), static_cast<int>(names.size()))
+    , m_Experiments(std::move(experiments))
+    , m_Names(std::move(names))
+    , m_States(m_Experiments.size()) {
+    for (const auto& experiment : m_Experiments) {
+      if (!experiment.likelihood) {
+        throw std::invalid_argument("The experiment " + experiment.name + " has no likelihood");
+      }
+    }
+    m_Changed.reserve(m_Experiments.size());
+  }
+
+  void CompositeLikelihood::evaluate(std::size_t idx) {
+    auto& state = m_States[idx];
+
+    state.value = m_Experiments[idx].likelihood->calculate_likelihood(state.parameters.data());
+    state.valid = true;
+    ++state.evaluations;
+  }
+
+  double CompositeLikelihood::calculate_likelihood(const double* parameter) {
+    PHYLINO_TIMELINE_SCOPE("CompositeLikelihood", "likelihood");
+
+    m_Parameter.reset_parameter(parameter);
+
+    // Map the global parameters onto the local layouts of the experiments with a changed parameter
+    m_Changed.clear();
+    for (std::size_t e = 0; e < m_States.size(); ++e) {
+      auto& state = m_States[e];
+
+      const bool changed = std::ranges::any_of(state.indices, [this](int idx) { return m_Parameter.check_parameter_changed(idx); });
+      if (state.valid && !changed) {
+        continue;
+      }
+
+      for (std::size_t i = 0; i < state.indices.size(); ++i) {
+        state.parameters[i] = m_Parameter[state.indices[i]];
+      }
+      m_Changed.push_back(e);
+    }
+
+    // The experiments are independent, so all but the first changed one are evaluated as tasks of the scheduler
+    if (!m_Changed.empty()) {
+      utilities::TaskGroup experiments(m_Options->scheduler());
+      for (std::size_t i = 1; i < m_Changed.size(); ++i) {
+        experiments.run([this, e = m_Changed[i]] { evaluate(e); });
+      }
+
+      evaluate(m_Changed.front());
+      experiments.wait();
+    }
+
+    double likelihood = 0.0;
+    for (const auto& state : m_States) {
+      likelihood += state.value;
+    }
+    return likelihood;
+  }
+
+}  // namespace ana
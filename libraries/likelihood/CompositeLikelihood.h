@@ -0,0 +1,113 @@
+#pragma once
+
+// includes
+#include "Likelihood.h"
+
+// STL includes
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace ana {
+
+  /**
+   * @class CompositeLikelihood
+   * @brief The sum of the likelihoods of several experiments with a common parameter vector.
+   *
+   * Every experiment keeps its own parameter layout. The global parameter vector contains every shared parameter,
+   * e.g. an oscillation parameter, once and the other parameters of every experiment with the prefix of the
+   * experiment. For every call the global parameters are mapped onto the local layouts. Only the experiments with
+   * a changed parameter are evaluated again, they run concurrently, while the others contribute their last value.
+   */
+  class CompositeLikelihood : public dc::Likelihood {
+   public:
+    /**
+     * @brief An experiment of the composite likelihood.
+     */
+    struct Experiment {
+      std::string                     name;             ///< The name of the experiment.
+      std::shared_ptr<dc::Likelihood> likelihood;       ///< The likelihood of the experiment.
+      std::vector<std::string>        parameter_names;  ///< The names of the parameters in the local layout.
+      std::string                     prefix;           ///< The prefix of the global names of the parameters which are not shared.
+    };
+
+    /**
+     * @brief Constructs the composite likelihood and the global parameter layout.
+     *
+     * @param options The options of the framework, only used for the parameter wrapper.
+     * @param experiments The experiments, the global layout lists their parameters in this order.
+     * @param shared_parameters The names of the parameters which are shared by all experiments that have them.
+     * @throws std::invalid_argument if an experiment has no likelihood or two parameters which are not shared
+     *         have the same global name.
+     */
+    CompositeLikelihood(std::shared_ptr<io::Options> options, std::vector<Experiment> experiments, const std::vector<std::string>& shared_parameters);
+
+    ~CompositeLikelihood() override = default;
+
+    /**
+     * @brief Calculates the sum of the likelihoods of all experiments.
+     *
+     * @param parameter The values of the global parameters, see parameter_names().
+     */
+    [[nodiscard]] double calculate_likelihood(const double* parameter) override;
+
+    /**
+     * @brief Returns the global names of the parameters, i.e. the layout of the global parameter vector.
+     *
+     * @param experiments The experiments, their likelihoods are not used.
+     * @param shared_parameters The names of the parameters which are shared by all experiments that have them.
+     * @throws std::invalid_argument if two parameters which are not shared have the same global name.
+     */
+    [[nodiscard]] static std::vector<std::string> global_names(const std::vector<Experiment>& experiments, const std::vector<std::string>& shared_parameters);
+
+    [[nodiscard]] const std::vector<std::string>& parameter_names() const noexcept { return m_Names; }
+
+    [[nodiscard]] std::size_t number_of_parameters() const noexcept { return m_Names.size(); }
+
+    [[nodiscard]] std::size_t number_of_experiments() const noexcept { return m_Experiments.size(); }
+
+    [[nodiscard]] const Experiment& experiment(std::size_t idx) const noexcept { return m_Experiments[idx]; }
+
+    /**
+     * @brief Returns the global index of every local parameter of an experiment.
+     */
+    [[nodiscard]] std::span<const int> global_indices(std::size_t idx) const noexcept { return m_States[idx].indices; }
+
+    /**
+     * @brief Returns the likelihood of an experiment at the last call.
+     */
+    [[nodiscard]] double value(std::size_t idx) const noexcept { return m_States[idx].value; }
+
+    /**
+     * @brief Returns how often an experiment was evaluated, the other calls used its last value.
+     */
+    [[nodiscard]] std::uint64_t evaluations(std::size_t idx) const noexcept { return m_States[idx].evaluations; }
+
+   private:
+    /**
+     * @brief The state of an experiment between the calls.
+     */
+    struct ExperimentState {
+      std::vector<int>    indices;              ///< The global index of every local parameter.
+      std::vector<double> parameters;           ///< The local parameters of the last evaluation.
+      double              value       = 0.0;    ///< The likelihood of the last evaluation.
+      bool                valid       = false;  ///< Whether the experiment was evaluated before.
+      std::uint64_t       evaluations = 0;      ///< The number of evaluations.
+    };
+
+    CompositeLikelihood(std::shared_ptr<io::Options> options, std::vector<std::string> names, std::vector<Experiment> experiments);
+
+    /**
+     * @brief Evaluates an experiment at its local parameters and stores the value.
+     */
+    void evaluate(std::size_t idx);
+
+    std::vector<Experiment>      m_Experiments;  ///< The experiments.
+    std::vector<std::string>     m_Names;        ///< The global names of the parameters.
+    std::vector<ExperimentState> m_States;       ///< The state of every experiment.
+    std::vector<std::size_t>     m_Changed;      ///< Scratch memory for the experiments evaluated in a call.
+  };
+
+}  // namespace ana
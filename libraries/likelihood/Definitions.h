@@ -1,10 +1,39 @@
 #pragma once
 
+// STL includes
+#include <array>
+
+// includes
+#include <DoubleChooz/Constants.h>
+
 #include <Eigen/Core>
 
 namespace ana::dc {
 
-  template <int nBins=44>
+  /**
+   * @brief The binning policy of the Double Chooz spectra.
+   *
+   * All sizes are compile-time constants, so the spectra are fixed-size arrays and the loops over them have a
+   * known trip count, which the compiler can unroll and vectorize. Another binning is another policy type with
+   * the same members.
+   */
+  struct DCBinning {
+    static constexpr int spectrum_bins = io::dc::Constants::number_of_spectrum_bins;  ///< The bins of the background and energy corrected spectra.
+    static constexpr int reactor_bins  = io::dc::Constants::number_of_reactor_bins;   ///< The bins of the oscillated and shape corrected reactor spectra.
+    static constexpr int energy_bins   = io::dc::Constants::number_of_energy_bins;    ///< The bins with an energy correction.
+
+    using spectrum_t         = std::array<double, spectrum_bins>;      ///< A background or energy corrected spectrum.
+    using reactor_spectrum_t = std::array<double, reactor_bins>;       ///< An oscillated or shape corrected reactor spectrum.
+    using edges_t            = std::array<double, spectrum_bins + 1>;  ///< The bin edges of a spectrum.
+    using array_t            = Eigen::Array<double, spectrum_bins, 1>; ///< A spectrum for the Eigen array arithmetic.
+  };
+
+  /**
+   * @brief The binning of the analysis, used by all spectrum components.
+   */
+  using Binning = DCBinning;
+
+  template <int nBins = Binning::spectrum_bins>
   using return_t = Eigen::Array<double, nBins, 1>;
 
-}
\ No newline at end of file
+}
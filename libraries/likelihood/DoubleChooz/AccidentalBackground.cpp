@@ -55,8 +55,21 @@ namespace ana::dc {
     return recalculate;
   }
 
+  void AccidentalBackground::register_parameters(params::ParameterRegistry& registry) const {
+    using enum params::dc::DetectorType;
+    using enum params::dc::Detector;
+    using Registry = params::ParameterRegistry;
+
+    std::vector<Registry::Block> blocks;
+    for (auto detector : {ND, FDI, FDII}) {
+      blocks.push_back(Registry::block(detector, AccShape01, AccShape38));
+      blocks.push_back(Registry::block(detector, BkgRAcc, BkgRAcc));
+    }
+    registry.add_component("AccidentalBackground", blocks);
+  }
+
   AccidentalBackground::AccidentalBackground(std::shared_ptr<io::Options> options)
-    : SpectrumBase(std::move(options)) {
+    : SpectrumBase(std::move(options), "AccidentalBackground") {
     using enum params::dc::DetectorType;
 
     const auto& db = m_Options->double_chooz().dataBase();
@@ -79,9 +92,9 @@ namespace ana::dc {
       h->Fill(E);
     }
 
-    std::array<double, 44> background_template{};
+    Binning::spectrum_t background_template{};
 
-    for (int i = 0; i < 44; ++i) {
+    for (int i = 0; i < Binning::spectrum_bins; ++i) {
       background_template[i] = h->GetBinContent(i + 1);
     }
 
@@ -92,9 +105,9 @@ namespace ana::dc {
     for (auto detector : {ND, FDI, FDII}) {
       const double lifeTime = m_Options->double_chooz().dataBase().on_lifetime(detector);
 
-      std::array<double, 44> background_spectrum;
+      Binning::spectrum_t background_spectrum;
 
-      for (int i = 0; i < 44; ++i) {
+      for (int i = 0; i < Binning::spectrum_bins; ++i) {
         background_spectrum[i] = (lifeTime / sum) * background_template[i];
       }
 
@@ -103,12 +116,16 @@ namespace ana::dc {
   }
 
   void AccidentalBackground::recalculate_spectra(const ParameterWrapper& parameter) {
+    PHYLINO_TIMELINE_SCOPE("AccidentalBackground", "component");
+
     // Recalculate the accidental background spectrum
 
     using enum params::dc::DetectorType;
     using namespace params::dc;
 
     for (const auto detector : {ND, FDI, FDII}) {
+      PHYLINO_PROFILE_SCOPE(detector_timer, m_Profile.data_set(params::get_index(detector)));
+
       using span_t = std::span<const double>;
 
       span_t background_template = get_background_template(detector);
@@ -121,21 +138,27 @@ namespace ana::dc {
       assert(m_CovMatrix[detector] != nullptr);
 
       const Eigen::MatrixXd&  covMatrix = *m_CovMatrix[detector];
-      std::array<double, 44>& result    = m_AccSpectrum[detector];
+      Binning::spectrum_t& result    = m_AccSpectrum[detector];
 
       calculate_spectrum(rate,
                          background_template,
                          shape_parameter,
                          covMatrix,
-                         result);
+                         result,
+                         m_Workspace,
+                         m_ComputeShapeResponse ? &m_ShapeResponse[detector] : nullptr);
     }
   }
 
   bool AccidentalBackground::check_and_recalculate(const ParameterWrapper& parameter) {
+    PHYLINO_PROFILE_SCOPE(timer, m_Profile.total());
+
     const bool recalculate = check_parameters(parameter);
     if (recalculate) {
       recalculate_spectra(parameter);
     }
+
+    PHYLINO_PROFILE_RECOMPUTED(timer, recalculate);
     return recalculate;
   }
 
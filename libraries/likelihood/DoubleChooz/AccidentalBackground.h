@@ -38,6 +38,11 @@ namespace ana::dc {
      */
     bool check_and_recalculate(const ParameterWrapper& parameter) override;
 
+    /**
+     * @brief Registers the rates and shape parameters of the accidental background of all detectors.
+     */
+    void register_parameters(params::ParameterRegistry& registry) const override;
+
     /**
      * @brief Retrieves the spectrum for a given detector type.
      *
@@ -55,8 +60,17 @@ namespace ana::dc {
       return m_BackgroundTemplate.at(detector);
     }
 
+    /**
+     * @brief Returns the derivative of the spectrum with respect to its shape parameters.
+     *
+     * The spectrum is linear in the shape parameters, the matrix belongs to the last recalculation.
+     */
+    [[nodiscard]] const Eigen::MatrixXd& shape_response(params::dc::DetectorType detector) const {
+      return m_ShapeResponse.at(detector);
+    }
+
    private:
-    using array_t = std::array<double, 44>;
+    using array_t = Binning::spectrum_t;
 
     template <typename T>
     using map_t = std::unordered_map<params::dc::DetectorType, T>;
@@ -66,6 +80,10 @@ namespace ana::dc {
 
     map_t<std::shared_ptr<Eigen::MatrixXd>> m_CovMatrix;
 
+    map_t<Eigen::MatrixXd> m_ShapeResponse;  ///< The derivative of the spectra with respect to the shape parameters.
+
+    SpectrumWorkspace m_Workspace;  ///< The scratch memory of the spectrum calculation.
+
     void fill_data(params::dc::DetectorType);
 
     void recalculate_spectra(const ParameterWrapper& parameter);
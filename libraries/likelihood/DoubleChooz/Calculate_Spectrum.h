@@ -7,7 +7,10 @@
 #include <Eigen/Eigenvalues>
 
 // STL include
+#include <algorithm>
+#include <cassert>
 #include <span>
+#include <utility>
 
 namespace ana::dc {
 
@@ -22,23 +25,60 @@ namespace ana::dc {
     }
   }  // namespace
 
-  inline void calculate_spectrum(double                  rate,
-                                 std::span<const double> shape,
-                                 std::span<const double> shape_parameter,
-                                 const Eigen::MatrixXd&  covMatrix,
-                                 std::span<double>       result) {
+  /**
+   * @class BasicSpectrumWorkspace
+   * @brief The scratch memory of calculate_spectrum.
+   *
+   * The matrices have a dynamic size bounded at compile time by the binning policy, i.e. their storage is part of
+   * the object. Each component keeps its own workspace, so the spectrum calculation does not allocate memory.
+   */
+  template <typename BinningPolicy>
+  struct BasicSpectrumWorkspace {
+    static constexpr int max_size = BinningPolicy::spectrum_bins;  ///< The maximum number of shape parameters.
+
+    using matrix_t = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor, max_size, max_size>;
+    using vector_t = Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, max_size, 1>;
+
+    Eigen::SelfAdjointEigenSolver<matrix_t> eigen_solver;      ///< The eigen decomposition of the covariance matrix.
+    matrix_t                                corrected_matrix;  ///< The covariance matrix with corrected eigenvalues.
+    Eigen::LLT<matrix_t>                    llt_solver;        ///< The Cholesky decomposition of the corrected matrix.
+    vector_t                                shifts;            ///< The shifts of the bins due to the shape parameters.
+  };
+
+  using SpectrumWorkspace = BasicSpectrumWorkspace<Binning>;
+
+  /**
+   * @brief Calculates a spectrum with correlated shape uncertainties.
+   *
+   * The result is the rate-scaled shape plus L * shape_parameter, where L is the Cholesky factor of the
+   * covariance matrix of the spectrum. The result is therefore linear in the shape parameters.
+   *
+   * @param workspace The scratch memory of the binning, the covariance matrix must not be larger than its max_size.
+   * @param response If not a nullptr, the Cholesky factor L, i.e. the derivative of the first covMatrix.rows()
+   *                 bins of the result with respect to the shape parameters, is stored here.
+   */
+  template <typename BinningPolicy>
+  inline void calculate_spectrum(double                                 rate,
+                                 std::span<const double>                shape,
+                                 std::span<const double>                shape_parameter,
+                                 const Eigen::MatrixXd&                 covMatrix,
+                                 std::span<double>                      result,
+                                 BasicSpectrumWorkspace<BinningPolicy>& workspace,
+                                 Eigen::MatrixXd*                       response = nullptr) {
+    assert(covMatrix.rows() <= BasicSpectrumWorkspace<BinningPolicy>::max_size);
+
     auto backgroundSpectrum = make_spectrum(shape);
 
     auto backgroundSpectrumSubset = backgroundSpectrum.head(covMatrix.rows());
 
-    auto backgroundOuterProduct = backgroundSpectrumSubset * backgroundSpectrumSubset.transpose();
+    // The lazy product is evaluated coefficient-wise, a regular product would be evaluated into a temporary
+    auto backgroundOuterProduct = backgroundSpectrumSubset.lazyProduct(backgroundSpectrumSubset.transpose());
 
     // Element-wise multiplication of the fractional covariance matrix with the outer product
     auto defracCovMatrix = pow_2(rate) * covMatrix.cwiseProduct(backgroundOuterProduct);
 
-    using matrix_t = Eigen::MatrixXd;
-
-    Eigen::SelfAdjointEigenSolver<matrix_t> eigen_solver(0.5 * (defracCovMatrix + defracCovMatrix.transpose()));
+    auto& eigen_solver = workspace.eigen_solver;
+    eigen_solver.compute(0.5 * (defracCovMatrix + defracCovMatrix.transpose()));
 
     // The correction value for the eigenvalue that is iteratively increased until success
     double eigenvalueCorrection = 4e-14;
@@ -51,13 +91,13 @@ namespace ana::dc {
     // Get the eigenvectors of the rescaled covariance matrix
     const auto& eigenvectors = eigen_solver.eigenvectors();
 
-    matrix_t             corrected_matrix;
-    Eigen::LLT<matrix_t> llt_solver;
+    auto& corrected_matrix = workspace.corrected_matrix;
+    auto& llt_solver       = workspace.llt_solver;
 
     // Iteratively increase the correction value until the matrix is positive definite
     // Compute the Cholesky decomposition of the corrected matrix
     while (true) {
-      corrected_matrix = eigenvectors * compute_corrected_eigenvalues(eigenvalueCorrection) * eigenvectors.transpose();
+      corrected_matrix.noalias() = eigenvectors * compute_corrected_eigenvalues(eigenvalueCorrection) * eigenvectors.transpose();
       llt_solver.compute(corrected_matrix);
       if (llt_solver.info() == Eigen::Success) {
         break;
@@ -67,7 +107,12 @@ namespace ana::dc {
 
     auto param_map = make_spectrum(shape_parameter);
 
-    Eigen::VectorXd shifts = llt_solver.matrixL() * param_map;
+    auto& shifts = workspace.shifts;
+    shifts.noalias() = llt_solver.matrixL() * param_map;
+
+    if (response != nullptr) {
+      *response = llt_solver.matrixL();
+    }
 
     // Copy the background spectrum to the result, scaled by the rate
     std::ranges::transform(std::as_const(backgroundSpectrum), result.begin(),
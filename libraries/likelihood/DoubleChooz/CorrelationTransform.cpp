@@ -0,0 +1,83 @@
+#include "CorrelationTransform.h"
+
+namespace ana::dc {
+
+  CorrelationTransform::CorrelationTransform(const io::dc::DataBase& dataBase) {
+    using enum params::dc::DetectorType;
+    using enum params::dc::Detector;
+    using params::index;
+
+    // EnergyA is fully correlated among all detectors
+    m_Energy.factor  = dataBase.energy_correlation_matrix();
+    m_Energy.indices = {params::General::EnergyA,
+                        index(FDI, EnergyB),
+                        index(ND, EnergyB),
+                        index(FDII, EnergyB),
+                        index(FDI, EnergyC),
+                        index(ND, EnergyC),
+                        index(FDII, EnergyC)};
+
+    m_MCNorm.factor  = dataBase.mcNorm_correlation_matrix();
+    m_MCNorm.indices = {index(FDI, MCNorm), index(ND, MCNorm), index(FDII, MCNorm)};
+
+    for (int i = 0; i < number_of_shape_parameters; ++i) {
+      m_Shape[i].factor  = dataBase.interDetector_correlation_matrix();
+      m_Shape[i].indices = {index(FDI, NuShape01 + i), index(ND, NuShape01 + i), index(FDII, NuShape01 + i)};
+    }
+  }
+
+  bool CorrelationTransform::correlated(const int index) noexcept {
+    using enum params::dc::DetectorType;
+    using enum params::dc::Detector;
+
+    if (index == params::General::EnergyA) {
+      return true;
+    }
+
+    for (const auto detector : {ND, FDI, FDII}) {
+      const int first_shape = params::index(detector, NuShape01);
+      if (index == params::index(detector, EnergyB) || index == params::index(detector, EnergyC) || index == params::index(detector, MCNorm) ||
+          (index >= first_shape && index < first_shape + number_of_shape_parameters)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool CorrelationTransform::tied(const int index) noexcept {
+    return index == params::index(params::dc::DetectorType::FDI, params::dc::Detector::BkgRLi);
+  }
+
+  template <int N>
+  void CorrelationTransform::Block<N>::apply(std::span<double> parameters) noexcept {
+    vector_t raw;
+    for (int i = 0; i < N; ++i) {
+      raw[i] = parameters[indices[i]];
+    }
+
+    // A minimizer mostly varies a single parameter, so most blocks keep their result
+    if (raw != input) {
+      input = raw;
+      output.noalias() = factor * raw;
+    }
+
+    for (int i = 0; i < N; ++i) {
+      parameters[indices[i]] = output[i];
+    }
+  }
+
+  void CorrelationTransform::operator()(std::span<double> parameters) noexcept {
+    using enum params::dc::DetectorType;
+    using enum params::dc::Detector;
+
+    // FDI and FDII lithium background rates are fully correlated
+    parameters[params::index(FDI, BkgRLi)] = parameters[params::index(FDII, BkgRLi)];
+
+    m_Energy.apply(parameters);
+    m_MCNorm.apply(parameters);
+    for (auto& block : m_Shape) {
+      block.apply(parameters);
+    }
+  }
+
+}  // namespace ana::dc
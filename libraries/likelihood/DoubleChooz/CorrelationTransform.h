@@ -0,0 +1,75 @@
+#pragma once
+
+// io includes
+#include <Options.h>
+
+// includes
+#include "../ParameterTransform.h"
+
+// Eigen includes
+#include <Eigen/Core>
+
+// STL includes
+#include <array>
+#include <limits>
+#include <span>
+
+namespace ana::dc {
+
+  /**
+   * @class CorrelationTransform
+   * @brief Correlates the Double Chooz nuisance parameters with the correlation factors of the data base.
+   *
+   * The FDI lithium rate is set to the FDII one. The energy parameters, the MC normalizations and every reactor shape
+   * parameter of the three detectors form blocks, whose raw values are multiplied with the factor L of their
+   * correlation matrix. A block is only multiplied again if one of its raw values changed, otherwise its last result
+   * is written back. Everything is kept in fixed size matrices, so the transform does not allocate.
+   */
+  class CorrelationTransform : public ParameterTransform {
+   public:
+    explicit CorrelationTransform(const io::dc::DataBase& dataBase);
+
+    void operator()(std::span<double> parameters) noexcept override;
+
+    /**
+     * @brief Checks if a parameter is part of a correlated block, i.e. its transformed value mixes several raw ones.
+     *
+     * The pulls of these parameters are evaluated on the raw values, which have unit correlation by construction.
+     */
+    [[nodiscard]] static bool correlated(int index) noexcept;
+
+    /**
+     * @brief Checks if a parameter is overwritten by another one, i.e. the FDI lithium rate.
+     *
+     * Its raw value does not change the likelihood, so it has to be fixed in the minimizer and has no pull.
+     */
+    [[nodiscard]] static bool tied(int index) noexcept;
+
+   private:
+    /**
+     * @brief A set of parameters which are correlated by a matrix.
+     */
+    template <int N>
+    struct Block {
+      using vector_t = Eigen::Matrix<double, N, 1>;
+
+      Eigen::Matrix<double, N, N> factor;   ///< The factor of the correlation matrix.
+      std::array<int, N>          indices;  ///< The indices of the parameters, in the order of the matrix.
+
+      vector_t input  = vector_t::Constant(std::numeric_limits<double>::quiet_NaN());  ///< The raw values of the last result, NaN never compares equal.
+      vector_t output = vector_t::Zero();                                                ///< The correlated values.
+
+      /**
+       * @brief Replaces the parameters of the block by their correlated values.
+       */
+      void apply(std::span<double> parameters) noexcept;
+    };
+
+    static constexpr int number_of_shape_parameters = params::dc::Detector::NuShape43 - params::dc::Detector::NuShape01 + 1;
+
+    Block<7>                                         m_Energy;  ///< EnergyA and EnergyB, EnergyC of all detectors.
+    Block<3>                                         m_MCNorm;  ///< The MC normalizations of all detectors.
+    std::array<Block<3>, number_of_shape_parameters> m_Shape;   ///< Every reactor shape parameter of all detectors.
+  };
+
+}  // namespace ana::dc
@@ -2,33 +2,20 @@
 
 namespace ana::dc {
 
+  /// The number of off-off bins of a detector in the likelihood.
+  constexpr std::size_t off_off_bins = Binning::spectrum_bins - DCLikelihood::off_off_first_bin;
+
+  /// The maximum number of bins of the Poisson reduction, the six reactor split data sets and the off-off data.
+  constexpr std::size_t max_poisson_bins = 6 * Binning::spectrum_bins + DCLikelihood::off_off_detectors.size() * off_off_bins;
+
   /**
-   * @brief Calculates the Poisson likelihood for given data, signal, and background.
-   *
-   * This function computes the Poisson likelihood for a given set of observed data,
-   * expected signal, and background. The likelihood is calculated using the formula:
-   *
-   * \f[
-   * \mathcal{L} = -2 \sum_{i} \left( data_i \log(model_i) - model_i \right)
-   * \f]
-   *
-   * where \f$ model_i = signal_i + bkg_i \f$.
-   *
-   * This assumes that the sum over background and signal prediction is larger than zero.
-   *
-   * @param data A span of observed data values.
-   * @param signal A span of expected signal values.
-   * @param bkg A span of expected background values.
-   * @return The calculated Poisson likelihood.
+   * @brief Returns the signed Poisson deviance residual of a bin, its square is -2 * (n * log(mu) - mu) up to a constant.
    */
-  inline double calculate_poisson_likelihood(std::span<const double> data, std::span<const double> signal, std::span<const double> bkg) noexcept {
-    double return_value = 0.0;
-    for (size_t i = 0; i < data.size(); ++i) {
-      const double model_i = signal[i] + bkg[i];
-      return_value += data[i] * std::log(model_i) - model_i;
-    }
+  inline double deviance_residual(const double n, const double mu) noexcept {
+    const double deviance = 2.0 * (mu - n + (n > 0.0 ? n * std::log(n / mu) : 0.0));
+    const double residual = std::copysign(std::sqrt(std::max(deviance, 0.0)), mu - n);
 
-    return -2.0 * return_value;
+    return std::isfinite(residual) ? residual : 1.0e12;
   }
 
   bool DCLikelihood::recalculate_spectra(const ParameterWrapper& parameter) noexcept {
@@ -84,7 +71,7 @@ namespace ana::dc {
 
     using enum params::dc::DetectorType;
 
-    constexpr int nBins = 44;
+    constexpr int nBins = Binning::spectrum_bins;
 
     for (auto detector : {ND, FDI, FDII}) {
       using map_t   = Eigen::Map<const Eigen::Array<double, nBins, 1>>;
@@ -106,7 +93,7 @@ namespace ana::dc {
       // Calculate the full spectrum prediction
       array_t prediction = (bkg + (mcNorm * reactor));
 
-      std::array<double, 44> array{};
+      Binning::spectrum_t array{};
       std::ranges::copy(prediction, array.begin());
       m_MeasurementData[detector] = array;
 
@@ -115,7 +102,7 @@ namespace ana::dc {
         const double on_lifetime  = m_Options->double_chooz().dataBase().on_lifetime(detector);
         const double off_lifetime = m_Options->double_chooz().dataBase().off_lifetime(detector);
 
-        std::array<double, 44> off_off_data{};
+        Binning::spectrum_t off_off_data{};
 
         const array_t off_off_bkg = (off_lifetime / on_lifetime) * bkg;
 
@@ -123,84 +110,157 @@ namespace ana::dc {
         m_OffOffData[detector] = off_off_data;
       }
     }
-  }
 
-  void correlate_parameters(const io::Options& options, std::span<double> parameters) {
-    using enum params::dc::DetectorType;
-    using enum params::dc::Detector;
-    using namespace params;
+    if (m_Options->inputOptions().double_chooz().reactor_split()) {
+      using params::dc::cast_to_B1_split;
+      using params::dc::cast_to_B2_split;
+
+      for (auto detector : {ND, FDI, FDII}) {
+        const auto b1 = m_Reactor.get_spectrum(cast_to_B1_split(detector));
+        const auto b2 = m_Reactor.get_spectrum(cast_to_B2_split(detector));
+
+        // The background of a detector is shared among the reactors like the Asimov reactor spectrum. The share
+        // stays fixed during the fit, so the split data sets sum up to the data set of the detector.
+        auto& b1_share = m_BackgroundShare[cast_to_B1_split(detector)];
+        auto& b2_share = m_BackgroundShare[cast_to_B2_split(detector)];
+        for (int i = 0; i < nBins; ++i) {
+          const double total = b1[i] + b2[i];
+          b1_share[i]        = (total > 0.0) ? b1[i] / total : 0.5;
+          b2_share[i]        = 1.0 - b1_share[i];
+        }
+
+        for (const auto type : {cast_to_B1_split(detector), cast_to_B2_split(detector)}) {
+          Binning::spectrum_t array{};
+          std::ranges::copy(calculate_prediction(m_Parameter, type), array.begin());
+          m_MeasurementData[type] = array;
+        }
+      }
+    }
+  }
 
-    // FDI and FDII lithium background rates are fully correlated
-    parameters[index(FDI, BkgRLi)] = parameters[index(FDII, BkgRLi)];
+  DCLikelihood::DCLikelihood(std::shared_ptr<io::Options> options, int nParameter, unsigned int coarse_bins)
+    : Likelihood(std::move(options), nParameter)
+    , m_Accidental(m_Options)
+    , m_Lithium(m_Options)
+    , m_FastN(m_Options)
+    , m_DNC(m_Options)
+    , m_Reactor(m_Options, coarse_bins) {
+    m_Components = {&m_Accidental, &m_Lithium, &m_FastN, &m_DNC, &m_Reactor};
+    setup_parameter_layout();
+    m_Parameter.set_transform(std::make_unique<CorrelationTransform>(m_Options->double_chooz().dataBase()));
+    initialize_measurement_data();
+    setup_poisson_reduction();
+    setup_pulls();
 
-    const auto& dco = options.double_chooz().dataBase();
+    // The counters should only contain the calls of the fit, not the ones of the Asimov data generation
+    reset_profiles();
+  }
 
-    {  // Correlate Energy Parameters
-      // EnergyA is fully correlated among all detectors
-      constexpr std::array<int, 7> energy_indices = {EnergyA,
-                                                     index(FDI, EnergyB),
-                                                     index(ND, EnergyB),
-                                                     index(FDII, EnergyB),
-                                                     index(FDI, EnergyC),
-                                                     index(ND, EnergyC),
-                                                     index(FDII, EnergyC)};
+  DCLikelihood::DCLikelihood(std::shared_ptr<io::Options> options, const DCLikelihood& other)
+    : Likelihood(std::move(options), static_cast<int>(other.m_Parameter.size()))
+    , m_Accidental(m_Options)
+    , m_Lithium(m_Options)
+    , m_FastN(m_Options)
+    , m_DNC(m_Options)
+    , m_Reactor(m_Options, other.m_Reactor)
+    , m_Pulls(other.m_Pulls)
+    , m_ShapeCV(other.m_ShapeCV)
+    , m_MeasurementData(other.m_MeasurementData)
+    , m_OffOffData(other.m_OffOffData)
+    , m_BackgroundShare(other.m_BackgroundShare) {
+    m_Components = {&m_Accidental, &m_Lithium, &m_FastN, &m_DNC, &m_Reactor};
+    setup_parameter_layout();
+    m_Parameter.set_transform(std::make_unique<CorrelationTransform>(m_Options->double_chooz().dataBase()));
+    setup_poisson_reduction();
 
-      TVectorD energy_correlations(7);
+    // No spectrum is calculated yet, so the first call recalculates all of them
+    m_Parameter.invalidate();
+  }
 
-      for (std::size_t i = 0; i < energy_indices.size(); ++i) {
-        energy_correlations[i] = parameters[energy_indices[i]];
-      }
+  DCLikelihood::HypothesisChain::HypothesisChain(const std::shared_ptr<io::Options>& options, const ReactorSpectrum& reactor)
+    : signal(options, reactor)
+    , parameter(params::number_of_parameters(), options) {
+    parameter.set_transform(std::make_unique<CorrelationTransform>(options->double_chooz().dataBase()));
 
-      energy_correlations *= dco.energy_correlation_matrix();
+    // No spectrum is calculated yet, so the first call recalculates all of them
+    parameter.invalidate();
+  }
 
-      for (std::size_t i = 0; i < energy_indices.size(); ++i) {
-        parameters[energy_indices[i]] = energy_correlations[i];
-      }
+  DCLikelihood::HypothesisChain& DCLikelihood::hypothesis_chain() {
+    if (!m_HypothesisChain) {
+      m_HypothesisChain = std::make_unique<HypothesisChain>(m_Options, m_Reactor);
     }
+    return *m_HypothesisChain;
+  }
 
-    {
-      constexpr std::array mcNorm_indices = {index(FDI, MCNorm),
-                                             index(ND, MCNorm),
-                                             index(FDII, MCNorm)};
+  void DCLikelihood::use_measurement_data(const DCLikelihood& other) {
+    m_MeasurementData = other.m_MeasurementData;
+    m_OffOffData      = other.m_OffOffData;
+    setup_poisson_reduction();
+  }
 
-      TVectorD mcNorm_correlations(3);
-      for (std::size_t i = 0; i < mcNorm_indices.size(); ++i) {
-        mcNorm_correlations[i] = parameters[mcNorm_indices[i]];
-      }
+  void DCLikelihood::setup_poisson_reduction() {
+    using enum params::dc::DetectorType;
 
-      mcNorm_correlations *= dco.mcNorm_correlation_matrix();
+    std::vector<double> data;
+    for (const auto data_set : data_sets()) {
+      const auto measurement = get_measurement_data(data_set);
+      data.insert(data.end(), measurement.begin(), measurement.end());
+    }
 
-      for (std::size_t i = 0; i < mcNorm_indices.size(); ++i) {
-        parameters[mcNorm_indices[i]] = mcNorm_correlations[i];
+    if (uses_off_off_data()) {
+      for (const auto detector : off_off_detectors) {
+        const auto off_off = get_off_off_data(detector);
+        data.insert(data.end(), off_off.begin() + off_off_first_bin, off_off.end());
       }
     }
-    {
-      const auto& covMatrix = dco.interDetector_correlation_matrix();
-      TVectorD    reactor_correlations(3);
-      for (int i = NuShape01; i <= NuShape43; ++i) {
-        reactor_correlations[0] = parameters[index(FDI, i)];
-        reactor_correlations[1] = parameters[index(ND, i)];
-        reactor_correlations[2] = parameters[index(FDII, i)];
 
-        reactor_correlations *= covMatrix;
+    m_PoissonReduction = PoissonReduction(data);
+  }
 
-        parameters[index(FDI, i)]  = reactor_correlations[0];
-        parameters[index(ND, i)]   = reactor_correlations[1];
-        parameters[index(FDII, i)] = reactor_correlations[2];
-      }
+  std::vector<const utilities::ComponentProfile*> DCLikelihood::collect_profiles() {
+    std::vector<utilities::ComponentProfile*> profiles;
+    for (auto* component : m_Components) {
+      component->collect_profiles(profiles);
     }
+
+    std::vector<const utilities::ComponentProfile*> result(profiles.begin(), profiles.end());
+    result.push_back(&m_LikelihoodProfile);
+    result.push_back(&m_PullProfile);
+    return result;
   }
 
-  DCLikelihood::DCLikelihood(std::shared_ptr<io::Options> options, int nParameter)
-    : Likelihood(std::move(options), nParameter)
-    , m_Accidental(m_Options)
-    , m_Lithium(m_Options)
-    , m_FastN(m_Options)
-    , m_DNC(m_Options)
-    , m_Reactor(m_Options) {
-    m_Components = {&m_Accidental, &m_Lithium, &m_FastN, &m_DNC, &m_Reactor};
-    initialize_measurement_data();
-    setup_pulls();
+  void DCLikelihood::reset_profiles() noexcept {
+    std::vector<utilities::ComponentProfile*> profiles;
+    for (auto* component : m_Components) {
+      component->collect_profiles(profiles);
+    }
+
+    for (auto* profile : profiles) {
+      profile->reset();
+    }
+    m_LikelihoodProfile.reset();
+    m_PullProfile.reset();
+  }
+
+  void DCLikelihood::setup_parameter_layout() {
+    using enum params::dc::DetectorType;
+    using enum params::dc::Detector;
+    using Registry = params::ParameterRegistry;
+
+    Registry registry(static_cast<int>(m_Parameter.size()));
+    for (const auto* component : m_Components) {
+      component->register_parameters(registry);
+    }
+
+    // The normalization is read by the likelihood itself
+    registry.add_component("Normalization", {Registry::block(params::Bugey4),
+                                             Registry::block(ND, MCNorm, MCNorm),
+                                             Registry::block(FDI, MCNorm, MCNorm),
+                                             Registry::block(FDII, MCNorm, MCNorm)});
+    registry.finalize();
+
+    m_Parameter.set_layout(registry);
   }
 
   void DCLikelihood::setup_pulls() {
@@ -211,10 +271,12 @@ namespace ana::dc {
     const auto& parameters  = input_parameters.parameters();
     const auto& constrained = input_parameters.constrained();
 
-    for (std::size_t i = 0, end = m_Components.size(); i < end; ++i) {
-      if (constrained[i]) {
+    for (std::size_t i = 0, end = parameters.size(); i < end; ++i) {
+      // The constraint of a tied parameter is the one of the parameter it is set to
+      if (constrained[i] && !CorrelationTransform::tied(static_cast<int>(i))) {
         std::cout << "Setup pull for parameter " << std::setw(8) << i << ":\t" << names[i] << '\n';
-        m_Pulls.emplace_back(i, parameters[i].value(), parameters[i].uncertainty());
+        // The priors of correlated parameters apply to the raw values, the correlations are part of the transform
+        m_Pulls.emplace_back(i, parameters[i].value(), parameters[i].uncertainty(), CorrelationTransform::correlated(static_cast<int>(i)));
       }
     }
     using enum params::dc::DetectorType;
@@ -227,15 +289,17 @@ namespace ana::dc {
   }
 
   double DCLikelihood::calculate_pulls(const ParameterWrapper& parameter) const noexcept {
-    double result = 0.0;
-    for (const auto [idx, CV, sig] : m_Pulls) {
-      result += pow_2((parameter[idx] - CV) / sig);
-    }
+    PHYLINO_PROFILE_SCOPE(timer, m_PullProfile.total());
 
     using span_t = std::span<const double>;
 
     span_t rawP = parameter.raw_parameters();
 
+    double result = 0.0;
+    for (const auto [idx, CV, sig, raw] : m_Pulls) {
+      result += pow_2(((raw ? rawP[idx] : parameter[idx]) - CV) / sig);
+    }
+
     using enum params::dc::DetectorType;
     using enum params::dc::Detector;
 
@@ -260,52 +324,109 @@ namespace ana::dc {
     return result;
   }
 
+  std::pair<double, double> DCLikelihood::gaussian_prior(const int idx) const noexcept {
+    double precision = 0.0;
+    double weighted  = 0.0;
+
+    // The prior of a correlated parameter is the one of its raw value, see calculate_pulls
+    for (const auto [pull_idx, CV, sig, raw] : m_Pulls) {
+      if (pull_idx == idx) {
+        precision += 1.0 / pow_2(sig);
+        weighted += CV / pow_2(sig);
+      }
+    }
+
+    using enum params::dc::DetectorType;
+    using enum params::dc::Detector;
+
+    // The reactor shape parameters always have a pull with unit width, see calculate_pulls
+    for (const auto detector : {ND, FDI, FDII}) {
+      const int offset = idx - params::index(detector, NuShape01);
+      if (offset >= 0 && offset <= NuShape43 - NuShape01) {
+        const auto [nd_CV, fd1_CV, fd2_CV] = m_ShapeCV[offset];
+
+        precision += 1.0;
+        weighted += (detector == ND) ? nd_CV : ((detector == FDI) ? fd1_CV : fd2_CV);
+      }
+    }
+
+    return {precision, precision > 0.0 ? weighted / precision : 0.0};
+  }
+
+  void DCLikelihood::set_profiled_parameters(const std::vector<int>& indices) {
+    if (!indices.empty() && m_Options->inputOptions().double_chooz().reactor_split()) {
+      throw std::invalid_argument("The profiling of nuisance parameters does not support the reactor split");
+    }
+    if (!indices.empty() && !m_Options->double_chooz().dataBase().interDetector_correlation_matrix().isIdentity()) {
+      throw std::invalid_argument("The profiling of nuisance parameters does not support inter-detector correlations of the reactor shape");
+    }
+
+    // Only the profiler reads the derivatives of the spectra, the next call recalculates all spectra with them
+    for (SpectrumBase* component : {static_cast<SpectrumBase*>(&m_Accidental),
+                                    static_cast<SpectrumBase*>(&m_Lithium),
+                                    static_cast<SpectrumBase*>(&m_FastN),
+                                    static_cast<SpectrumBase*>(m_Reactor.shape_correction().get())}) {
+      component->compute_shape_response(!indices.empty());
+    }
+    m_Parameter.invalidate();
+
+    if (indices.empty()) {
+      m_Profiler.reset();
+      return;
+    }
+    m_Profiler = std::make_unique<NuisanceProfiler>(*this, indices);
+  }
+
   void DCLikelihood::check_and_recalculate(const double* parameter) noexcept {
     m_Parameter.reset_parameter(parameter);
 
+    // The components only read the parameters and write their own spectra, so the reactor chain, which takes most
+    // of the time, runs as a task while the backgrounds are recalculated on this thread
+    utilities::TaskGroup components(m_Options->scheduler());
+    components.run([this] { m_Reactor.check_and_recalculate(m_Parameter); });
+
     for (auto* component : m_Components) {
-      component->check_and_recalculate(m_Parameter);
+      if (component != &m_Reactor) {
+        component->check_and_recalculate(m_Parameter);
+      }
     }
+    components.wait();
   }
 
   double DCLikelihood::calculate_likelihood(const double* parameter) {
-    check_and_recalculate(parameter);
-    if (m_Options->inputOptions().double_chooz().reactor_split()) {
-      return calculate_reactor_split_likelihood(m_Parameter);
-    }
-    return calculate_default_likelihood(m_Parameter);
-  }
-
-  double DCLikelihood::calculate_off_off_likelihood(const Eigen::Array<double, 44, 1>& bkg, params::dc::DetectorType detector) const {
-    constexpr int nBins = 44;
-    using map_t         = Eigen::Map<const Eigen::Array<double, 44, 1>>;
+    PHYLINO_TIMELINE_SCOPE("Likelihood", "likelihood");
 
-    // Get the off-off data
-    map_t off_off_data(get_off_off_data(detector).data(), nBins);
+    const double value = evaluate_likelihood(parameter);
 
-    // Get the on and off lifetimes
-    const double on_lifetime  = m_Options->double_chooz().dataBase().on_lifetime(detector);
-    const double off_lifetime = m_Options->double_chooz().dataBase().off_lifetime(detector);
+    if (m_Trace) {
+      m_Trace->record(parameter, value);
+    }
 
-    // Rescale the background to the off time
-    auto off_off_bkg = (off_lifetime / on_lifetime) * bkg;
+    return value;
+  }
 
-    // Exclude the bins up to 3 MeV due to residual neutrinos
-    constexpr std::size_t idx = std::distance(io::dc::Constants::EnergyBinXaxis.cbegin(),
-                                              std::ranges::lower_bound(io::dc::Constants::EnergyBinXaxis, 3.0));
+  double DCLikelihood::evaluate_likelihood(const double* parameter) {
+    PHYLINO_PROFILE_SCOPE(timer, m_LikelihoodProfile.total());
 
-    const Eigen::Array<double, 44, 1> off_off_llh = -2.0 * (off_off_data * off_off_bkg.log() - off_off_bkg);
+    if (m_Profiler) {
+      // Sets the spectra to the conditional minimum of the profiled parameters
+      m_Profiler->profile(parameter);
+      return calculate_default_likelihood(m_Parameter);
+    }
 
-    // Calculate Poisson Likelihood
-    return -2.0 * off_off_llh.tail(nBins - idx).sum();
+    check_and_recalculate(parameter);
+    return calculate_default_likelihood(m_Parameter);
   }
 
   double DCLikelihood::calculate_mcNorm(const ParameterWrapper& parameter, params::dc::DetectorType type) const noexcept {
     using namespace params::dc;
 
-    const auto [value, error] = m_Options->double_chooz().dataBase().mcNorm_central_values(type);
+    // The reactor split data sets share the normalization of their detector
+    const DetectorType detector = cast_to_no_reactor_split(type);
+
+    const auto [value, error] = m_Options->double_chooz().dataBase().mcNorm_central_values(detector);
 
-    const double norm = parameter[params::index(type, Detector::MCNorm)];
+    const double norm = parameter[params::index(detector, Detector::MCNorm)];
 
     const double result = value + error * norm;
 
@@ -314,49 +435,149 @@ namespace ana::dc {
     return result * bugey4;
   }
 
-  double DCLikelihood::calculate_default_likelihood(const ParameterWrapper& parameter) const noexcept {
-    using enum params::dc::DetectorType;
+  Binning::array_t DCLikelihood::calculate_prediction(const ParameterWrapper& parameter, params::dc::DetectorType type) const noexcept {
+    constexpr int nBins = Binning::spectrum_bins;
 
-    double likelihood = 0.0;
+    using map_t = Eigen::Map<const Eigen::Array<double, nBins, 1>>;
 
-    constexpr int nBins = 44;
+    // The backgrounds are only calculated per detector
+    const params::dc::DetectorType detector = params::dc::cast_to_no_reactor_split(type);
 
-    for (const auto detector : {ND, FDI, FDII}) {
-      using map_t   = Eigen::Map<const Eigen::Array<double, nBins, 1>>;
-      using array_t = Eigen::Array<double, nBins, 1>;
+    map_t reactor(m_Reactor.get_spectrum(type).data(), nBins);
 
-      // Get all spectrum components as Eigen::Map
-      map_t acc(m_Accidental.get_spectrum(detector).data(), nBins);
-      map_t li(m_Lithium.get_spectrum(detector).data(), nBins);
-      map_t fastN(m_FastN.get_spectrum(detector).data(), nBins);
-      map_t dnc(m_DNC.get_spectrum(detector).data(), nBins);
-      map_t reactor(m_Reactor.get_spectrum(detector).data(), nBins);
+    // Get the MC normalization parameter
+    const double mcNorm = calculate_mcNorm(parameter, detector);
 
-      // Add all background components to the full background contribution
-      const array_t bkg = acc + li + fastN + dnc;
+    if (params::dc::is_reactor_split(type)) {
+      map_t share(m_BackgroundShare.at(type).data(), nBins);
+      return share * calculate_background(detector) + (mcNorm * reactor);
+    }
 
-      // Get the measurement data as Eigen::Map
-      map_t data(get_measurement_data(detector).data(), nBins);
+    // Calculate the full spectrum prediction
+    return calculate_background(detector) + (mcNorm * reactor);
+  }
 
-      // Get the MC normalization parameter
-      const double mcNorm = calculate_mcNorm(parameter, detector);
+  Binning::array_t DCLikelihood::calculate_background(params::dc::DetectorType detector) const noexcept {
+    constexpr int nBins = Binning::spectrum_bins;
 
-      // Calculate the full spectrum prediction
-      array_t prediction = (bkg + (mcNorm * reactor));
+    using map_t = Eigen::Map<const Eigen::Array<double, nBins, 1>>;
+
+    // Get all spectrum components as Eigen::Map
+    map_t acc(m_Accidental.get_spectrum(detector).data(), nBins);
+    map_t li(m_Lithium.get_spectrum(detector).data(), nBins);
+    map_t fastN(m_FastN.get_spectrum(detector).data(), nBins);
+    map_t dnc(m_DNC.get_spectrum(detector).data(), nBins);
+
+    return acc + li + fastN + dnc;
+  }
+
+  std::span<const params::dc::DetectorType> DCLikelihood::data_sets() const noexcept {
+    using enum params::dc::DetectorType;
+
+    static constexpr std::array detectors      = {ND, FDI, FDII};
+    static constexpr std::array reactor_splits = {NDB1, NDB2, FDIB1, FDIB2, FDIIB1, FDIIB2};
+
+    if (m_Options->inputOptions().double_chooz().reactor_split()) {
+      return reactor_splits;
+    }
+    return detectors;
+  }
+
+  double DCLikelihood::calculate_default_likelihood(const ParameterWrapper& parameter) const noexcept {
+    using enum params::dc::DetectorType;
+
+    // The predictions in the order of the data of the Poisson reduction
+    std::array<double, max_poisson_bins> prediction;
+    auto                                 out = prediction.begin();
 
-      // Calculate Poisson Likelihood
-      likelihood += -2.0 * (data * prediction.log() - prediction).sum();
+    for (const auto data_set : data_sets()) {
+      PHYLINO_PROFILE_SCOPE(data_set_timer, m_LikelihoodProfile.data_set(params::get_index(data_set)));
 
-      // Calculate the off-off component of the likelihood
-      // if (detector == ND || detector == FDII) {
-      //   likelihood += calculate_off_off_likelihood(bkg, detector);
-      //   std::cout << params::dc::get_detector_name(detector) << "_off_off" << '\t' << likelihood << '\n';
-      // }
+      // Calculate the full spectrum prediction
+      const Binning::array_t spectrum = calculate_prediction(parameter, data_set);
+      out = std::copy(spectrum.begin(), spectrum.end(), out);
     }
 
+    if (uses_off_off_data()) {
+      for (const auto detector : off_off_detectors) {
+        const Binning::array_t off_off_bkg = calculate_off_off_prediction(detector);
+        out = std::copy(off_off_bkg.begin() + off_off_first_bin, off_off_bkg.end(), out);
+      }
+    }
+
+    // Calculate Poisson Likelihood of all bins in one pass
+    double likelihood = m_PoissonReduction(std::span<const double>(prediction.begin(), out));
+
     likelihood += calculate_pulls(parameter);
 
     // Return the likelihood parameter if it is finite, otherwise return a large number. This is to prevent the minimizer from crashing.
     return std::isfinite(likelihood) ? likelihood : 1.0e25;
   }
+
+  std::size_t DCLikelihood::number_of_residuals() const noexcept {
+    using enum params::dc::Detector;
+    constexpr std::size_t nShape = (NuShape43 - NuShape01) + 1;
+
+    const std::size_t off_off = uses_off_off_data() ? off_off_detectors.size() * off_off_bins : 0;
+
+    return data_sets().size() * Binning::spectrum_bins + off_off + m_Pulls.size() + 3 * nShape;
+  }
+
+  double DCLikelihood::off_off_scale(const params::dc::DetectorType detector) const noexcept {
+    const auto& dataBase = m_Options->double_chooz().dataBase();
+    return dataBase.off_lifetime(detector) / dataBase.on_lifetime(detector);
+  }
+
+  Binning::array_t DCLikelihood::calculate_off_off_prediction(const params::dc::DetectorType detector) const noexcept {
+    return off_off_scale(detector) * calculate_background(detector);
+  }
+
+  void DCLikelihood::calculate_residuals(const double* parameter, std::span<double> residuals) {
+    using enum params::dc::DetectorType;
+    using enum params::dc::Detector;
+
+    check_and_recalculate(parameter);
+
+    constexpr int nBins = Binning::spectrum_bins;
+
+    auto out = residuals.begin();
+
+    for (const auto data_set : data_sets()) {
+      const auto data = get_measurement_data(data_set);
+
+      const Eigen::Array<double, nBins, 1> prediction = calculate_prediction(m_Parameter, data_set);
+
+      for (int i = 0; i < nBins; ++i) {
+        *out++ = deviance_residual(data[i], prediction[i]);
+      }
+    }
+
+    if (uses_off_off_data()) {
+      for (const auto detector : off_off_detectors) {
+        const auto             data       = get_off_off_data(detector);
+        const Binning::array_t prediction = calculate_off_off_prediction(detector);
+
+        for (std::size_t i = off_off_first_bin; i < static_cast<std::size_t>(nBins); ++i) {
+          *out++ = deviance_residual(data[i], prediction[static_cast<Eigen::Index>(i)]);
+        }
+      }
+    }
+
+    const auto rawP = m_Parameter.raw_parameters();
+
+    for (const auto [idx, CV, sig, raw] : m_Pulls) {
+      *out++ = ((raw ? rawP[idx] : m_Parameter[idx]) - CV) / sig;
+    }
+
+    constexpr std::size_t nShape = (NuShape43 - NuShape01) + 1;
+    constexpr double      scale  = 1.0;
+
+    for (std::size_t i = 0; i < nShape; ++i) {
+      const auto [nd_CV, fd1_CV, fd2_CV] = m_ShapeCV[i];
+
+      *out++ = (rawP[params::index(ND, NuShape01) + i] - nd_CV) / scale;
+      *out++ = (rawP[params::index(FDI, NuShape01) + i] - fd1_CV) / scale;
+      *out++ = (rawP[params::index(FDII, NuShape01) + i] - fd2_CV) / scale;
+    }
+  }
 }  // namespace ana::dc
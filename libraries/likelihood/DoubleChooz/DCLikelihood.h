@@ -1,14 +1,17 @@
 #pragma once
 
 #include "../Likelihood.h"
+#include "../LikelihoodTrace.h"
+#include "../PoissonReduction.h"
 #include "Options.h"
 #include "ParameterWrapper.h"
-#include "TVectorD.h"
 
 #include "AccidentalBackground.h"
+#include "CorrelationTransform.h"
 #include "DNCBackground.h"
 #include "FastNBackground.h"
 #include "LithiumBackground.h"
+#include "NuisanceProfiler.h"
 #include "ReactorSpectrum.h"
 
 namespace ana::dc {
@@ -22,6 +25,13 @@ namespace ana::dc {
    */
   class DCLikelihood : public Likelihood {
    public:
+    /// The first bin of the off-off data in the likelihood, the bins up to 3 MeV are excluded due to residual neutrinos.
+    static constexpr std::size_t off_off_first_bin = std::distance(io::dc::Constants::EnergyBinXaxis.cbegin(),
+                                                                   std::ranges::lower_bound(io::dc::Constants::EnergyBinXaxis, 3.0));
+
+    /// The detectors with off-off data.
+    static constexpr std::array<params::dc::DetectorType, 2> off_off_detectors = {params::dc::DetectorType::ND, params::dc::DetectorType::FDII};
+
     /**
      * @brief Constructs a DCLikelihood object.
      *
@@ -29,8 +39,21 @@ namespace ana::dc {
      * and sets the number of parameters.
      *
      * @param options A shared pointer to an io::Options object that contains the configuration options.
+     * @param coarse_bins The number of L/E bins per energy bin of a reduced reactor MC for a coarse fit level, 0
+     *                    to use every reactor event.
      */
-    explicit DCLikelihood(std::shared_ptr<io::Options> options, int nParameter);
+    explicit DCLikelihood(std::shared_ptr<io::Options> options, int nParameter, unsigned int coarse_bins = 0);
+
+    /**
+     * @brief Constructs a likelihood which shares the reactor events of another one, e.g. to evaluate it on another thread.
+     *
+     * The measurement and off-off data, the background shares and the pulls are copied from the other likelihood
+     * instead of generating the Asimov data set again. The nuisance profiling and the trace are not copied.
+     *
+     * @param options A shared pointer to an io::Options object that contains the configuration options.
+     * @param other The likelihood whose reactor events and data are used.
+     */
+    DCLikelihood(std::shared_ptr<io::Options> options, const DCLikelihood& other);
 
     /**
      * @brief Default destructor for DCLikelihood class.
@@ -49,6 +72,25 @@ namespace ana::dc {
      */
     [[nodiscard]] double calculate_likelihood(const double* parameter) override;
 
+    /**
+     * @brief Returns the number of residuals, i.e. the number of bins of all data sets and of the used off-off data
+     *        plus the number of pull terms.
+     */
+    [[nodiscard]] std::size_t number_of_residuals() const noexcept;
+
+    /**
+     * @brief Calculates the signed residuals of the likelihood for the given parameters.
+     *
+     * The bin residuals are the signed Poisson deviance residuals, the pull residuals are the normalized
+     * deviations from the central values. The sum of the squared residuals equals the likelihood up to a
+     * constant which does not depend on the parameters, which allows least-squares minimizers like Fumili
+     * to exploit the binned structure of the likelihood.
+     *
+     * @param parameter A pointer to the parameter values.
+     * @param residuals The output span, of size number_of_residuals().
+     */
+    void calculate_residuals(const double* parameter, std::span<double> residuals);
+
     /**
      * @brief Retrieves the measurement data for a specified detector type.
      *
@@ -67,16 +109,19 @@ namespace ana::dc {
     }
 
     /**
-     * @brief Calculates the off-off likelihood for the given background and detector type.
-     *
-     * This function computes the likelihood of the off-off state based on the provided
-     * background data and the specified detector type.
-     *
-     * @param bkg The background data used for the likelihood calculation.
-     * @param type The type of detector being used (as defined in params::dc::DetectorType).
-     * @return A double representing the calculated off-off likelihood.
+     * @brief Checks if the off-off data enters the likelihood, see the dc.offOff option.
      */
-    [[nodiscard]] double calculate_off_off_likelihood(const Eigen::Array<double, 44, 1>& bkg, params::dc::DetectorType type) const;
+    [[nodiscard]] bool uses_off_off_data() const noexcept { return m_Options->inputOptions().double_chooz().off_off(); }
+
+    /**
+     * @brief Returns the ratio of the off-off lifetime to the on lifetime of a detector.
+     */
+    [[nodiscard]] double off_off_scale(params::dc::DetectorType detector) const noexcept;
+
+    /**
+     * @brief Returns the off-off prediction of a detector, i.e. its background rescaled to the off-off lifetime.
+     */
+    [[nodiscard]] Binning::array_t calculate_off_off_prediction(params::dc::DetectorType detector) const noexcept;
 
     [[nodiscard]] AccidentalBackground& accidental_background() noexcept { return m_Accidental; }
 
@@ -92,12 +137,106 @@ namespace ana::dc {
 
     void check_and_recalculate(const double* parameter) noexcept;
 
+    /**
+     * @brief Calculates the full spectrum prediction, i.e. the sum of reactor and background spectra, for a detector.
+     *
+     * For a reactor split data set, e.g. NDB1, the reactor spectrum of this reactor is used. The background of the
+     * detector is shared among its reactor split data sets like the reactor spectrum of the Asimov data set.
+     */
+    [[nodiscard]] Binning::array_t calculate_prediction(const ParameterWrapper& parameter, params::dc::DetectorType detector) const noexcept;
+
+    /**
+     * @brief Returns the Gaussian prior of a parameter as it enters the pull terms.
+     *
+     * The prior of a parameter in a correlated block of the CorrelationTransform is the one of its raw value.
+     *
+     * @param idx The parameter index.
+     * @return The precision, i.e. the sum of the inverse variances of all pulls of the parameter, and the mean.
+     *         The precision is zero for parameters without pull.
+     */
+    [[nodiscard]] std::pair<double, double> gaussian_prior(int idx) const noexcept;
+
+    /**
+     * @brief Enables the analytic profiling of the given linear nuisance parameters.
+     *
+     * Afterward, calculate_likelihood() returns the likelihood with these parameters set to their conditional
+     * minimum, independent of the values handed over for them.
+     *
+     * @param indices The indices of the profiled parameters. An empty list disables the profiling.
+     * @throws std::invalid_argument if the reactor split is enabled or the reactor shape parameters are correlated
+     *         among the detectors, as the linear response of the profiler is calculated per detector.
+     */
+    void set_profiled_parameters(const std::vector<int>& indices);
+
+    /**
+     * @brief Returns the nuisance profiler, or a nullptr if the profiling is disabled.
+     */
+    [[nodiscard]] const NuisanceProfiler* nuisance_profiler() const noexcept { return m_Profiler.get(); }
+
+    /**
+     * @brief Returns the timing counters of all spectrum components and of the likelihood terms.
+     *
+     * The counters are only filled if the code is compiled with PHYLINO_PROFILING.
+     */
+    [[nodiscard]] std::vector<const utilities::ComponentProfile*> collect_profiles();
+
+    /**
+     * @brief Resets the timing counters of all spectrum components and of the likelihood terms.
+     */
+    void reset_profiles() noexcept;
+
+    /**
+     * @brief Records every call of calculate_likelihood() in the given trace, a nullptr disables the recording.
+     */
+    void set_trace(std::shared_ptr<LikelihoodTraceWriter> trace) noexcept { m_Trace = std::move(trace); }
+
+    /**
+     * @brief Returns the trace of the likelihood calls, or a nullptr if the recording is disabled.
+     */
+    [[nodiscard]] const std::shared_ptr<LikelihoodTraceWriter>& trace() const noexcept { return m_Trace; }
+
+    /**
+     * @brief A reactor chain with its own parameters, independent of the spectra of the likelihood.
+     */
+    struct HypothesisChain {
+      /**
+       * @param options The options of the analysis.
+       * @param reactor The reactor spectrum of the likelihood, whose events are shared.
+       */
+      HypothesisChain(const std::shared_ptr<io::Options>& options, const ReactorSpectrum& reactor);
+
+      ReactorSpectrum  signal;     ///< The reactor spectrum, its oscillator shares the events of the likelihood.
+      ParameterWrapper parameter;  ///< The parameters of the chain, with the transform of the likelihood.
+    };
+
+    /**
+     * @brief Returns the reactor chain for further hypotheses, e.g. the null hypothesis, which is created on the first call.
+     *
+     * The chain is reused by later calls, so only the steps whose parameters changed are recalculated. The first
+     * call has to be made before the chain is used on another thread.
+     */
+    [[nodiscard]] HypothesisChain& hypothesis_chain();
+
+    /**
+     * @brief Replaces the measurement and off-off data by the ones of another likelihood.
+     *
+     * A coarse fit level uses this to fit the data of the full likelihood instead of its own Asimov data.
+     */
+    void use_measurement_data(const DCLikelihood& other);
+
    private:
     /**
-     * @brief Calculates the default likelihood for the given parameter.
+     * @brief Calculates the likelihood, i.e. calculate_likelihood() without the trace recording.
+     */
+    [[nodiscard]] double evaluate_likelihood(const double* parameter);
+
+    /**
+     * @brief Calculates the likelihood for the given parameter.
      *
-     * This function calculates the likelihood for the default configuration of the
-     * Double Chooz experiment based on the provided parameters.
+     * The predictions of all data sets, see data_sets(), and of the off-off data, if enabled, are concatenated and
+     * reduced in a single pass of the Poisson reduction. For the reactor split, the reactor spectra of both data
+     * sets of a detector come from a single pass of the reactor chain, see calculate_prediction() for how the
+     * background of a detector is shared among them.
      *
      * @param parameter The parameter for which the likelihood is to be calculated.
      * @return The calculated likelihood as a double.
@@ -105,19 +244,14 @@ namespace ana::dc {
     [[nodiscard]] double calculate_default_likelihood(const ParameterWrapper& parameter) const noexcept;
 
     /**
-     * @brief Calculates the likelihood of the reactor split based on the given parameters.
-     *
-     * This function computes the likelihood of the reactor split configuration using the provided
-     * parameters encapsulated in the ParameterWrapper object.
-     *
-     * @param parameter A constant reference to a ParameterWrapper object containing
-     *                  the parameters required for the likelihood calculation.
-     * @return A double representing the calculated likelihood.
+     * @brief Returns the background spectrum of a detector, i.e. the sum of all background components.
      */
-    // TODO
-    [[nodiscard]] double calculate_reactor_split_likelihood(const ParameterWrapper& parameter) noexcept {
-      return 0.0;
-    }
+    [[nodiscard]] Binning::array_t calculate_background(params::dc::DetectorType detector) const noexcept;
+
+    /**
+     * @brief Returns the data sets of the Poisson terms, i.e. the detectors or the reactor split data sets.
+     */
+    [[nodiscard]] std::span<const params::dc::DetectorType> data_sets() const noexcept;
 
     /**
      * @brief Recalculates the spectra based on the provided parameters.
@@ -136,6 +270,16 @@ namespace ana::dc {
 
     void setup_pulls();
 
+    /**
+     * @brief Builds the Poisson reduction from the measurement data of all data sets and the off-off data.
+     */
+    void setup_poisson_reduction();
+
+    /**
+     * @brief Builds the parameter layout from the parameters of the components, so they are contiguous.
+     */
+    void setup_parameter_layout();
+
     double calculate_pulls(const ParameterWrapper& parameter) const noexcept;
 
     AccidentalBackground m_Accidental;  ///< The accidental background object.
@@ -146,11 +290,23 @@ namespace ana::dc {
 
     std::vector<SpectrumBase*> m_Components;
 
-    std::vector<std::tuple<int, double, double>>    m_Pulls;
-    std::vector<std::tuple<double, double, double>> m_ShapeCV;
+    std::vector<std::tuple<int, double, double, bool>> m_Pulls;  ///< The index, central value, width and whether the pull is on the raw value.
+    std::vector<std::tuple<double, double, double>>    m_ShapeCV;
+
+    std::unordered_map<params::dc::DetectorType, Binning::spectrum_t> m_MeasurementData;  ///< The measurement data for each detector type.
+    std::unordered_map<params::dc::DetectorType, Binning::spectrum_t> m_OffOffData;       ///< The off-off data for each detector type.
+    std::unordered_map<params::dc::DetectorType, Binning::spectrum_t> m_BackgroundShare;  ///< The share of the detector background per reactor split data set.
+
+    PoissonReduction m_PoissonReduction;  ///< The Poisson terms of all data sets, followed by the off-off terms if enabled.
+
+    std::unique_ptr<NuisanceProfiler> m_Profiler;  ///< The profiler of the linear nuisance parameters, if enabled.
+
+    std::shared_ptr<LikelihoodTraceWriter> m_Trace;  ///< The trace of the likelihood calls, if enabled.
+
+    std::unique_ptr<HypothesisChain> m_HypothesisChain;  ///< The reactor chain for further hypotheses, created on demand.
 
-    std::unordered_map<params::dc::DetectorType, std::array<double, 44>> m_MeasurementData;  ///< The measurement data for each detector type.
-    std::unordered_map<params::dc::DetectorType, std::array<double, 44>> m_OffOffData;       ///< The off-off data for each detector type.
+    mutable utilities::ComponentProfile m_LikelihoodProfile{"Likelihood"};  ///< The timing counters of the likelihood, per detector for the Poisson terms.
+    mutable utilities::ComponentProfile m_PullProfile{"Pulls"};             ///< The timing counters of the pull terms.
   };
 
 }  // namespace ana::dc
@@ -15,10 +15,20 @@ namespace ana::dc {
     return has_changed;
   }
 
+  void DNCBackground::register_parameters(params::ParameterRegistry& registry) const {
+    using enum params::dc::DetectorType;
+    using enum params::dc::Detector;
+    using Registry = params::ParameterRegistry;
+
+    registry.add_component("DNCBackground", {Registry::block(ND, BkgRDNCHy, BkgRDNCGd),
+                                             Registry::block(FDI, BkgRDNCHy, BkgRDNCGd),
+                                             Registry::block(FDII, BkgRDNCHy, BkgRDNCGd)});
+  }
+
   DNCBackground::DNCBackground(std::shared_ptr<io::Options> options)
-    : SpectrumBase(std::move(options)) {
+    : SpectrumBase(std::move(options), "DNCBackground") {
     using enum params::dc::DetectorType;
-      std::array<double, 44> null_shape{};
+      Binning::spectrum_t null_shape{};
       std::ranges::fill(null_shape, 0.0);
     for (auto detector : {ND, FDI, FDII}) {
       m_SpectrumTemplate_Gd[detector] = null_shape;
@@ -28,18 +38,26 @@ namespace ana::dc {
   }
 
   bool DNCBackground::check_and_recalculate(const ParameterWrapper& parameter) {
+    PHYLINO_PROFILE_SCOPE(timer, m_Profile.total());
+
     bool has_changed = parameter_changed(parameter);
     if (has_changed) {
       recalculate_spectra(parameter);
     }
+
+    PHYLINO_PROFILE_RECOMPUTED(timer, has_changed);
     return has_changed;
   }
 
   void DNCBackground::recalculate_spectra(const ParameterWrapper& parameter) noexcept {
+    PHYLINO_TIMELINE_SCOPE("DNCBackground", "component");
+
     using enum params::dc::DetectorType;
     using enum params::dc::Detector;
 
     for (auto detector : {ND, FDII}) {
+      PHYLINO_PROFILE_SCOPE(detector_timer, m_Profile.data_set(params::get_index(detector)));
+
       double gd_rate = parameter[params::index(detector, BkgRDNCGd)];
       double hy_rate = parameter[params::index(detector, BkgRDNCHy)];
 
@@ -49,7 +67,7 @@ namespace ana::dc {
       double lifetime = m_Options->double_chooz().dataBase().on_lifetime(detector);
 
       auto& result = m_Cache[detector];
-      for (int i = 0; i < 44; ++i) {
+      for (int i = 0; i < Binning::spectrum_bins; ++i) {
         result[i] = std::max(lifetime * ((gd_rate * gd_shape[i]) + (hy_rate * hy_shape[i])), 0.0);
       }
     }
@@ -16,12 +16,17 @@ namespace ana::dc {
 
     bool check_and_recalculate(const ParameterWrapper& parameter) override;
 
+    /**
+     * @brief Registers the rates of the DNC background of all detectors.
+     */
+    void register_parameters(params::ParameterRegistry& registry) const override;
+
     [[nodiscard]] std::span<const double> get_spectrum(params::dc::DetectorType type) const noexcept override;
 
    private:
     void recalculate_spectra(const ParameterWrapper& parameter) noexcept;
 
-    using array_t = std::array<double, 44>;
+    using array_t = Binning::spectrum_t;
     using uo_map_t = std::unordered_map<params::dc::DetectorType, array_t>;
 
     uo_map_t m_Cache;
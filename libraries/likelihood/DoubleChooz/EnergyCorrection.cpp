@@ -52,58 +52,26 @@ namespace ana::dc {
     return result;
   }
 
-  class SplineFunction {
-   public:
-    SplineFunction(Eigen::VectorXd const& x_vec,
-                   Eigen::VectorXd const& y_vec)
-      : x_min(x_vec.minCoeff())
-      , x_max(x_vec.maxCoeff())
-      ,
-      // Spline fitting here. X values are scaled down to [0, 1] for this.
-      spline_(Eigen::SplineFitting<Eigen::Spline<double, 1>>::Interpolate(
-          y_vec.transpose(),
-          // No more than cubic spline, but accept short vectors.
-
-          3,  // std::min<int>(x_vec.rows() - 1, 3),
-          scaled_values(x_vec))) {}
-
-    double operator()(double x) const {
-      // x values need to be scaled down in extraction as well.
-      const auto tmp = spline_(scaled_value(x))(0);
-      return (tmp < 0.0) ? 0.0 : tmp;
-      // return spline_(scaled_value(x))(0);
-    }
+  EnergyCorrection::EnergyCorrection(std::shared_ptr<io::Options> options, std::shared_ptr<ShapeCorrection> shape_correction)
+    : SpectrumBase(std::move(options), "EnergyCorrection")
+    , m_ShapeCorrection(std::move(shape_correction)) {
+    auto xpos_values = range(0.25, 20.25, 0.25);
+    m_XPos           = Eigen::Array<double, Binning::reactor_bins, 1>(xpos_values.data());
 
-    [[nodiscard]] double derivative(double x) const noexcept {
-      return spline_.derivatives(scaled_value(x - x_min), 1)(1);
-    }
+    // Interpolate the unit vectors once, every spline on these knots is a linear combination of them
+    const Eigen::RowVectorXd scaled_xpos = ((m_XPos - m_XPos.minCoeff()) / (m_XPos.maxCoeff() - m_XPos.minCoeff())).matrix().transpose();
 
-   private:
-    // Helpers to scale X values down to [0, 1]
-    [[nodiscard]] inline double scaled_value(double x) const noexcept {
-      return (x - x_min) / (x_max - x_min);
-    }
+    for (int k = 0; k < Binning::reactor_bins; ++k) {
+      const auto unit   = Eigen::RowVectorXd::Unit(Binning::reactor_bins, k);
+      const auto spline = Eigen::SplineFitting<Eigen::Spline<double, 1, 3>>::Interpolate(unit, 3, scaled_xpos);
 
-    [[nodiscard]] Eigen::RowVectorXd scaled_values(Eigen::VectorXd const& x_vec) const {
-      return x_vec.unaryExpr([this](double x) { return scaled_value(x); }).transpose();
+      m_Knots                     = spline.knots();
+      m_BasisControlPoints.col(k) = spline.ctrls().transpose();
     }
 
-    double x_min;
-    double x_max;
-
-    // Spline of one-dimensional "points."
-    Eigen::Spline<double, 1, 3> spline_;
-  };
-
-  EnergyCorrection::EnergyCorrection(std::shared_ptr<io::Options> options, std::shared_ptr<ShapeCorrection> shape_correction)
-    : SpectrumBase(std::move(options))
-    , m_ShapeCorrection(std::move(shape_correction)) {
-    auto xpos_values = range(0.25, 20.25, 0.25);
-    m_XPos           = Eigen::Array<double, 80, 1>(xpos_values.data());
-
     using enum params::dc::DetectorType;
     for (auto detector : {ND, FDI, FDII}) {
-      std::array<double, 44> empty{};
+      Binning::spectrum_t empty{};
       std::ranges::fill(empty, 0.0);
       m_Cache[detector] = empty;
     }
@@ -122,15 +90,32 @@ namespace ana::dc {
     return has_changed;
   }
 
+  void EnergyCorrection::register_parameters(params::ParameterRegistry& registry) const {
+    using enum params::dc::DetectorType;
+    using enum params::dc::Detector;
+    using Registry = params::ParameterRegistry;
+
+    registry.add_component("EnergyCorrection", {Registry::block(params::EnergyA),
+                                                Registry::block(ND, EnergyB, EnergyC),
+                                                Registry::block(FDI, EnergyB, EnergyC),
+                                                Registry::block(FDII, EnergyB, EnergyC)});
+  }
+
   bool EnergyCorrection::check_and_recalculate(const ParameterWrapper& parameter) noexcept {
     const bool previous_step = m_ShapeCorrection->check_and_recalculate(parameter);
-    const bool this_step     = parameter_changed(parameter);
-    const bool recalculate   = previous_step | this_step;
+
+    // Started after the previous step, which has its own counters
+    PHYLINO_PROFILE_SCOPE(timer, m_Profile.total());
+
+    const bool this_step   = parameter_changed(parameter);
+    const bool recalculate = previous_step | this_step;
 
     if (recalculate) {
       calculate_spectra(parameter);
     }
 
+    PHYLINO_PROFILE_RECOMPUTED(timer, recalculate);
+
     return recalculate;
   }
 
@@ -139,6 +124,8 @@ namespace ana::dc {
   }
 
   void EnergyCorrection::calculate_spectra(const ParameterWrapper& parameter) noexcept {
+    PHYLINO_TIMELINE_SCOPE("EnergyCorrection", "component");
+
     using namespace params;
     using namespace params::dc;
     using enum DetectorType;
@@ -150,17 +137,55 @@ namespace ana::dc {
     const auto [CVa, SIGa] = db.energy_central_values(EnergyA);
     const double parA      = CVa + SIGa * parameter[EnergyA];
 
-    for (const auto detector : {ND, FDI, FDII}) {
-      span_t oscillated_spectrum = m_ShapeCorrection->get_spectrum(detector);
+    const double x_min = m_XPos.minCoeff();
+    const double x_max = m_XPos.maxCoeff();
 
-      Eigen::Array<double, 80, 1> cumSum;  // Cumulative sum of the oscillated spectrum
+    using spline_t = Eigen::Spline<double, 1, 3>;
+
+    // Evaluates the spline with the control points m_ControlPoints, negative values are clipped. The x values are
+    // scaled to [0, 1] like for the interpolation.
+    auto spline = [this, x_min, x_max](double x) noexcept {
+      const double u    = (x - x_min) / (x_max - x_min);
+      const auto   span = spline_t::Span(u, 3, m_Knots);
+      const auto   N    = spline_t::BasisFunctions(u, 3, m_Knots);
+
+      const double value = N.matrix().dot(m_ControlPoints.segment<4>(span - 3).transpose());
+      return (value < 0.0) ? 0.0 : value;
+    };
+
+    // Get the edges for the energy bins
+    const auto& binning = io::dc::Constants::EnergyBinXaxis;
+
+    // The way the correction is implemented is that the bin edges are used to calculate the energy correction.
+    // The bin content is then calculated by integrating the spline function over the new bin edges.
+    auto correct_spectrum = [this, &spline](span_t                        oscillated_spectrum,
+                                            const Binning::edges_t& corrected_edges,
+                                            Binning::spectrum_t&    energy_corrected_spectrum) noexcept {
+      Eigen::Array<double, Binning::reactor_bins, 1> cumSum;  // Cumulative sum of the oscillated spectrum
 
       // Calculate the cumulative sum of the oscillated spectrum.
       // This makes the integral calculation easier later.
       std::partial_sum(oscillated_spectrum.begin(), oscillated_spectrum.end(), cumSum.begin());
 
-      // Create a spline function from the cumulative sum upper bin edges
-      SplineFunction spline(m_XPos, cumSum);
+      // Interpolate the cumulative sum at the upper bin edges. The spline is a linear combination of the splines
+      // interpolating the unit vectors, so no new spline has to be fitted.
+      m_ControlPoints.noalias() = m_BasisControlPoints * cumSum.matrix();
+
+      for (int i = 1; i < io::dc::Constants::number_of_energy_bins; ++i) {
+        // Calculate the bin content by "integrating" the spline function over the new bin edges.
+        // The bin content is the difference between the spline value at the upper and lower bin edges since this
+        // is the cumulative sum of the oscillated spectrum.
+        const double bin_content = spline(corrected_edges[i]) - spline(corrected_edges[i - 1]);
+
+        // Store the bin content in the cache and limit it to positive values.
+        energy_corrected_spectrum[i - 1] = std::max(0.0, bin_content);
+      }
+    };
+
+    const bool reactor_split = m_Options->inputOptions().double_chooz().reactor_split();
+
+    for (const auto detector : {ND, FDI, FDII}) {
+      PHYLINO_PROFILE_SCOPE(detector_timer, m_Profile.data_set(params::get_index(detector)));
 
       // Get the central values of the energy correction parameters.
       // The fit parameters are only a deviation from these parameters. This is mathematically equivalent to using
@@ -172,27 +197,58 @@ namespace ana::dc {
       const double parB = CVb + SIGb * parameter[index(detector, EnergyB)];
       const double parC = CVc + SIGc * parameter[index(detector, EnergyC)];
 
-      // Get the edges for the energy bins
-      const auto& binning = io::dc::Constants::EnergyBinXaxis;
+      auto& corrected_edges = m_CorrectedEdges[detector];
+      for (int i = 0; i < io::dc::Constants::number_of_energy_bins; ++i) {
+        corrected_edges[i] = energy_scale_correction(parA, parB, parC, binning[i]);
+      }
 
-      // Get the cache for the detector as reference
-      auto& energy_corrected_spectrum = m_Cache[detector];
+      correct_spectrum(m_ShapeCorrection->get_spectrum(detector), corrected_edges, m_Cache[detector]);
 
-      // The way the correction is implemented is that the bin edges are used to calculate the energy correction.
-      // The bin content is then calculated by integrating the spline function over the new bin edges.
-      for (int i = 1; i < io::dc::Constants::number_of_energy_bins; ++i) {
-        const double e_lower = energy_scale_correction(parA, parB, parC, binning[i - 1]);
-        const double e_upper = energy_scale_correction(parA, parB, parC, binning[i]);
+      // The reactors of a detector share its energy scale, so their spectra are corrected with the same edges
+      if (reactor_split) {
+        for (const auto type : {cast_to_B1_split(detector), cast_to_B2_split(detector)}) {
+          correct_spectrum(m_ShapeCorrection->get_spectrum(type), corrected_edges, m_Cache[type]);
+        }
+      }
+    }
+  }
 
-        // Calculate the bin content by "integrating" the spline function over the new bin edges.
-        // The bin content is the difference between the spline value at the upper and lower bin edges since this
-        // is the cumulative sum of the oscillated spectrum.
-        const double bin_content = spline(e_upper) - spline(e_lower);
+  Eigen::Matrix<double, Binning::spectrum_bins, Binning::reactor_bins> EnergyCorrection::linear_map(params::dc::DetectorType type) const {
+    const auto& edges = m_CorrectedEdges.at(type);
 
-        // Store the bin content in the cache and limit it to positive values.
-        energy_corrected_spectrum[i - 1] = std::max(0.0, bin_content);
+    const double x_min = m_XPos.minCoeff();
+    const double x_max = m_XPos.maxCoeff();
+
+    using matrix_t  = Eigen::Matrix<double, Binning::spectrum_bins, Binning::reactor_bins>;
+    matrix_t result = matrix_t::Zero();
+
+    using spline_t = Eigen::Spline<double, 1, 3>;
+
+    // Returns the values of the 80 unit vector splines at the energy x
+    auto basis_values = [&](double x) -> Eigen::Matrix<double, 1, Binning::reactor_bins> {
+      const double u    = (x - x_min) / (x_max - x_min);
+      const auto   span = spline_t::Span(u, 3, m_Knots);
+      const auto   N    = spline_t::BasisFunctions(u, 3, m_Knots);
+
+      return N.matrix() * m_BasisControlPoints.middleRows(span - 3, 4);
+    };
+
+    Eigen::Matrix<double, 1, Binning::reactor_bins> lower = basis_values(edges[0]);
+    for (int i = 1; i < io::dc::Constants::number_of_energy_bins; ++i) {
+      const Eigen::Matrix<double, 1, Binning::reactor_bins> upper = basis_values(edges[i]);
+
+      // The bin content is the difference of the cumulative spectrum at the bin edges. The transpose of the
+      // cumulative sum is the reverse cumulative sum, which maps the weights back onto the input bins.
+      double reverse_sum = 0.0;
+      for (int k = Binning::reactor_bins - 1; k >= 0; --k) {
+        reverse_sum += upper[k] - lower[k];
+        result(i - 1, k) = reverse_sum;
       }
+
+      lower = upper;
     }
+
+    return result;
   }
 
 }  // namespace ana::dc
@@ -10,6 +10,7 @@
 
 // Eigen includes
 #include <Eigen/Core>
+#include <unsupported/Eigen/Splines>
 
 namespace ana::dc {
 
@@ -21,13 +22,33 @@ namespace ana::dc {
 
     [[nodiscard]] bool check_and_recalculate(const ParameterWrapper& parameter) noexcept override;
 
+    /**
+     * @brief Registers the energy scale parameters of all detectors.
+     */
+    void register_parameters(params::ParameterRegistry& registry) const override;
+
     [[nodiscard]] std::span<const double> get_spectrum(params::dc::DetectorType type) const noexcept override;
 
+    /**
+     * @brief Returns the linear map from the shape corrected to the energy corrected spectrum of a detector.
+     *
+     * The energy correction is linear in its input spectrum for fixed energy parameters, apart from the clipping
+     * of negative values. The map belongs to the energy parameters of the last recalculation.
+     */
+    [[nodiscard]] Eigen::Matrix<double, Binning::spectrum_bins, Binning::reactor_bins> linear_map(params::dc::DetectorType type) const;
+
   private:
-    std::unordered_map<params::dc::DetectorType, std::array<double, 44>> m_Cache;
-    Eigen::Array<double, 80, 1> m_XPos;
+    std::unordered_map<params::dc::DetectorType, Binning::spectrum_t> m_Cache;
+    std::unordered_map<params::dc::DetectorType, Binning::edges_t>    m_CorrectedEdges;  // Bin edges after the energy correction
+    Eigen::Array<double, Binning::reactor_bins, 1> m_XPos;
     std::shared_ptr<ShapeCorrection> m_ShapeCorrection;
 
+    // The interpolating spline is linear in the interpolated values. These are the spline knots and the control
+    // points of the splines interpolating the reactor_bins unit vectors, one column per unit vector.
+    Eigen::Spline<double, 1, 3>::KnotVectorType                         m_Knots;
+    Eigen::Matrix<double, Binning::reactor_bins, Binning::reactor_bins> m_BasisControlPoints;
+    Eigen::Matrix<double, Binning::reactor_bins, 1>                     m_ControlPoints;  // Scratch memory for the control points of the current spectrum
+
     void calculate_spectra(const ParameterWrapper& parameter) noexcept;
   };
 } // namespace ana::dc
\ No newline at end of file
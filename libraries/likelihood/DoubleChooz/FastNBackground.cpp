@@ -19,15 +19,28 @@ namespace ana::dc {
     bool has_changed = false;
 
     for (auto detector : {ND, FDI, FDII}) {
-      has_changed |= parameter.check_parameter_changed(index(detector, FNSMShape01), index(detector, FNSMShape44) + 1);
+      has_changed |= parameter.check_parameter_changed(index(detector, FNSMShape01), index(detector, FNSMShape44));
       has_changed |= parameter.check_parameter_changed(index(detector, BkgRFNSM));
     }
 
     return has_changed;
   }
 
+  void FastNBackground::register_parameters(params::ParameterRegistry& registry) const {
+    using enum params::dc::DetectorType;
+    using enum params::dc::Detector;
+    using Registry = params::ParameterRegistry;
+
+    std::vector<Registry::Block> blocks;
+    for (auto detector : {ND, FDI, FDII}) {
+      blocks.push_back(Registry::block(detector, FNSMShape01, FNSMShape44));
+      blocks.push_back(Registry::block(detector, BkgRFNSM, BkgRFNSM));
+    }
+    registry.add_component("FastNBackground", blocks);
+  }
+
   FastNBackground::FastNBackground(std::shared_ptr<io::Options> options)
-    : SpectrumBase(std::move(options)) {
+    : SpectrumBase(std::move(options), "FastNBackground") {
     using enum params::dc::DetectorType;
 
     const auto& db = m_Options->double_chooz().dataBase();
@@ -41,19 +54,27 @@ namespace ana::dc {
   }
 
   bool FastNBackground::check_and_recalculate(const ParameterWrapper& parameter) {
+    PHYLINO_PROFILE_SCOPE(timer, m_Profile.total());
+
     bool has_changed = parameter_changed(parameter);
     if (has_changed) {
       recalculate_spectra(parameter);
     }
+
+    PHYLINO_PROFILE_RECOMPUTED(timer, has_changed);
     return has_changed;
   }
 
   void FastNBackground::recalculate_spectra(const ParameterWrapper& parameter) noexcept {
+    PHYLINO_TIMELINE_SCOPE("FastNBackground", "component");
+
     using enum params::dc::DetectorType;
     using enum params::dc::Detector;
     using namespace params;
 
     for (const auto detector : {ND, FDI, FDII}) {
+      PHYLINO_PROFILE_SCOPE(detector_timer, m_Profile.data_set(params::get_index(detector)));
+
       using span_t = std::span<const double>;
 
       span_t background_template = get_background_template(detector);
@@ -65,13 +86,15 @@ namespace ana::dc {
 
       const Eigen::MatrixXd& covMatrix = *m_CovMatrix[detector];
 
-      std::array<double, 44>& result = m_FastNSpectrum[detector];
+      Binning::spectrum_t& result = m_FastNSpectrum[detector];
 
       calculate_spectrum(rate,
                          background_template,
                          shape_parameter,
                          covMatrix,
-                         result);
+                         result,
+                         m_Workspace,
+                         m_ComputeShapeResponse ? &m_ShapeResponse[detector] : nullptr);
     }
   }
 
@@ -86,9 +109,9 @@ namespace ana::dc {
       h->Fill(E);
     }
 
-    std::array<double, 44> background_template{};
+    Binning::spectrum_t background_template{};
 
-    for (int i = 0; i < 44; ++i) {
+    for (int i = 0; i < Binning::spectrum_bins; ++i) {
       background_template[i] = h->GetBinContent(i + 1);
     }
 
@@ -99,9 +122,9 @@ namespace ana::dc {
     for (auto detector : {ND, FDI, FDII}) {
       const double lifeTime = m_Options->double_chooz().dataBase().on_lifetime(detector);
 
-      std::array<double, 44> background_spectrum;
+      Binning::spectrum_t background_spectrum;
 
-      for (int i = 0; i < 44; ++i) {
+      for (int i = 0; i < Binning::spectrum_bins; ++i) {
         background_spectrum[i] = (lifeTime / sum) * background_template[i];
       }
 
@@ -2,6 +2,7 @@
 
 #include "../Definitions.h"
 #include "../SpectrumBase.h"
+#include "Calculate_Spectrum.h"
 
 namespace ana::dc {
 
@@ -13,6 +14,11 @@ namespace ana::dc {
 
     [[nodiscard]] bool check_and_recalculate(const ParameterWrapper& parameter) override;
 
+    /**
+     * @brief Registers the rates and shape parameters of the fast neutron background of all detectors.
+     */
+    void register_parameters(params::ParameterRegistry& registry) const override;
+
     [[nodiscard]] std::span<const double> get_spectrum(params::dc::DetectorType detector) const override {
       return m_FastNSpectrum.at(detector);
     }
@@ -21,13 +27,19 @@ namespace ana::dc {
       return m_BackgroundTemplate.at(detector);
     }
 
+    [[nodiscard]] const Eigen::MatrixXd& shape_response(params::dc::DetectorType detector) const {
+      return m_ShapeResponse.at(detector);
+    }
+
    private:
     template <typename T>
     using map_t = std::unordered_map<params::dc::DetectorType, T>;
 
-    map_t<std::array<double, 44>>           m_BackgroundTemplate;
-    map_t<std::array<double, 44>>           m_FastNSpectrum;
+    map_t<Binning::spectrum_t>              m_BackgroundTemplate;
+    map_t<Binning::spectrum_t>              m_FastNSpectrum;
     map_t<std::shared_ptr<Eigen::MatrixXd>> m_CovMatrix;
+    map_t<Eigen::MatrixXd>                  m_ShapeResponse;  // Derivative of the spectra with respect to the shape parameters
+    SpectrumWorkspace                       m_Workspace;      // Scratch memory of the spectrum calculation
 
     void recalculate_spectra(const ParameterWrapper& parameter) noexcept;
 
@@ -0,0 +1,76 @@
+#include "FourFlavorOscillation.h"
+#include "SinglePrecision.h"
+
+#include <cmath>
+
+namespace ana::dc {
+
+  namespace {
+    // Returns cos^4(theta) for sin^2(2 theta)
+    inline double get_cos4(const double xt) noexcept {
+      return std::pow(std::cos(std::asin(std::sqrt(xt)) / 2.0), 4);
+    }
+
+    #pragma omp declare simd
+    inline double pow_2(const double x) noexcept {
+      return x * x;
+    }
+  }  // namespace
+
+  FourFlavorOscillation::FourFlavorOscillation(double t13, double dmee, double t12, double dm21, double t14, double dm41)
+    : m_t13(t13)
+    , m_dmee(dmee * 1.267)
+    , m_t12(t12)
+    , m_dm21(dm21 * 1.267)
+    , m_t14(t14)
+    , m_dm41(dm41 * 1.267)
+    , m_cos413(get_cos4(m_t13))
+    , m_cos414(get_cos4(m_t14)) {}
+
+  double FourFlavorOscillation::oscillate_events(const OscillationData& data) const noexcept {
+    using span_t = std::span<const double>;
+
+    const span_t loe = data.LoverE;
+    const span_t scl = data.scaling;
+
+    // The amplitudes are constant, so the loop body only contains the three sines
+    const double amp13 = m_cos414 * m_t13;
+    const double amp12 = m_cos414 * m_cos413 * m_t12;
+    const double amp14 = m_t14;
+
+    const std::size_t N = loe.size();
+
+    double result = 0.0;
+
+    #pragma omp simd reduction(+ : result)
+    for (std::size_t i = 0; i < N; ++i) {
+      const double t13Part = amp13 * pow_2(sin(m_dmee * loe[i]));
+      const double t12Part = amp12 * pow_2(sin(m_dm21 * loe[i]));
+      const double t14Part = amp14 * pow_2(sin(m_dm41 * loe[i]));
+      result += scl[i] * (1 - t13Part - t12Part - t14Part);
+    }
+
+    return result * get_MC_scaling_factor(params::dc::is_far_detector(data.type));
+  }
+
+  double FourFlavorOscillation::oscillate_events(const OscillationData& data, const FloatOscillationData& single) const noexcept {
+    const float* loe = single.LoverE.data();
+    const float* scl = single.scaling.data();
+
+    const auto amp13 = static_cast<float>(m_cos414 * m_t13);
+    const auto amp12 = static_cast<float>(m_cos414 * m_cos413 * m_t12);
+    const auto amp14 = static_cast<float>(m_t14);
+    const auto dmee  = static_cast<float>(m_dmee);
+    const auto dm21  = static_cast<float>(m_dm21);
+    const auto dm41  = static_cast<float>(m_dm41);
+
+    const double result = compensated_sum(single.LoverE.size(), [=](std::size_t i) noexcept {
+      const float t13Part = amp13 * fast_sin_sq(dmee * loe[i]);
+      const float t12Part = amp12 * fast_sin_sq(dm21 * loe[i]);
+      const float t14Part = amp14 * fast_sin_sq(dm41 * loe[i]);
+      return scl[i] * (1.0f - t13Part - t12Part - t14Part);
+    });
+
+    return result * get_MC_scaling_factor(params::dc::is_far_detector(data.type));
+  }
+}  // namespace ana::dc
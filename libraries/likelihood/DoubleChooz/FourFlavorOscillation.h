@@ -0,0 +1,38 @@
+#pragma once
+
+#include "OscillationData.h"
+#include "RangeOscillator.h"
+
+namespace ana::dc {
+
+  /**
+   * @brief The survival probability of the 3+1 model with one sterile neutrino.
+   *
+   * The three-flavor terms are damped by cos^4(theta14) and the sterile term oscillates with DeltaM41. All three
+   * terms are calculated in the same vectorized loop over the events.
+   */
+  class FourFlavorOscillation : public RangeOscillator {
+  public:
+    FourFlavorOscillation(double t13, double dmee, double t12, double dm21, double t14, double dm41);
+
+    ~FourFlavorOscillation() override = default;
+
+  protected:
+    [[nodiscard]] double oscillate_events(const OscillationData& data) const noexcept override;
+
+    [[nodiscard]] double oscillate_events(const OscillationData& data, const FloatOscillationData& single) const noexcept override;
+
+  private:
+    [[nodiscard]] static double get_MC_scaling_factor(bool is_far_detector) noexcept { return is_far_detector ? 0.01 : 0.1; }
+
+    double m_t13;
+    double m_dmee;
+    double m_t12;
+    double m_dm21;
+    double m_t14;
+    double m_dm41;
+    double m_cos413;
+    double m_cos414;
+  };
+
+}
@@ -24,8 +24,19 @@ namespace ana::dc {
     return recalculate;
   }
 
+  void LithiumBackground::register_parameters(params::ParameterRegistry& registry) const {
+    using enum params::dc::DetectorType;
+    using enum params::dc::Detector;
+    using Registry = params::ParameterRegistry;
+
+    registry.add_component("LithiumBackground", {{params::LiShape01, params::LiShape38 + 1},
+                                                 Registry::block(ND, BkgRLi, BkgRLi),
+                                                 Registry::block(FDI, BkgRLi, BkgRLi),
+                                                 Registry::block(FDII, BkgRLi, BkgRLi)});
+  }
+
   LithiumBackground::LithiumBackground(std::shared_ptr<io::Options> options)
-    : SpectrumBase(std::move(options)) {
+    : SpectrumBase(std::move(options), "LithiumBackground") {
     using enum params::dc::DetectorType;
     for (const auto detector : {ND, FDI, FDII}) {
       fill_data(detector);
@@ -33,14 +44,20 @@ namespace ana::dc {
   }
 
   bool LithiumBackground::check_and_recalculate(const ParameterWrapper& parameter) {
+    PHYLINO_PROFILE_SCOPE(timer, m_Profile.total());
+
     bool has_changed = check_parameters(parameter);
     if (has_changed) {
       recalculate_spectra(parameter);
     }
+
+    PHYLINO_PROFILE_RECOMPUTED(timer, has_changed);
     return has_changed;
   }
 
   void LithiumBackground::recalculate_spectra(const ParameterWrapper& parameter) {
+    PHYLINO_TIMELINE_SCOPE("LithiumBackground", "component");
+
     using enum params::dc::DetectorType;
     using namespace params::dc;
 
@@ -50,6 +67,8 @@ namespace ana::dc {
     span_t shape_parameter = parameter.sub_range(params::LiShape01, params::LiShape38 + 1);
 
     for (const auto detector : {ND, FDI, FDII}) {
+      PHYLINO_PROFILE_SCOPE(detector_timer, m_Profile.data_set(params::get_index(detector)));
+
       span_t background_template = get_background_template(detector);
 
       const double rate = parameter[params::index(detector, BkgRLi)];
@@ -64,7 +83,9 @@ namespace ana::dc {
                          background_template,
                          shape_parameter,
                          covMatrix,
-                         result);
+                         result,
+                         m_Workspace,
+                         m_ComputeShapeResponse ? &m_ShapeResponse[detector] : nullptr);
     }
   }
 
@@ -79,9 +100,9 @@ namespace ana::dc {
       h->Fill(E);
     }
 
-    std::array<double, 44> background_template{};
+    Binning::spectrum_t background_template{};
 
-    for (int i = 0; i < 44; ++i) {
+    for (int i = 0; i < Binning::spectrum_bins; ++i) {
       background_template[i] = h->GetBinContent(i + 1);
     }
 
@@ -89,17 +110,17 @@ namespace ana::dc {
 
     const double sum = std::accumulate(background_template.begin(), background_template.end(), 0.0);
 
-    std::array<double, 44> null_template{};
+    Binning::spectrum_t null_template{};
     std::ranges::fill(null_template, 0.0);
 
     for (auto detector : {ND, FDI, FDII}) {
       const double lifeTime = m_Options->double_chooz().dataBase().on_lifetime(detector);
 
-      std::array<double, 44> background_spectrum;
+      Binning::spectrum_t background_spectrum;
 
       const double scaling_factor = lifeTime / sum;
 
-      for (int i = 0; i < 44; ++i) {
+      for (int i = 0; i < Binning::spectrum_bins; ++i) {
         background_spectrum[i] = scaling_factor * background_template[i];
       }
 
@@ -2,6 +2,7 @@
 
 #include "../Definitions.h"
 #include "../SpectrumBase.h"
+#include "Calculate_Spectrum.h"
 #include "Options.h"
 
 namespace ana::dc {
@@ -14,6 +15,11 @@ namespace ana::dc {
 
     bool check_and_recalculate(const ParameterWrapper& parameter) override;
 
+    /**
+     * @brief Registers the shape parameters and the rates of the lithium background of all detectors.
+     */
+    void register_parameters(params::ParameterRegistry& registry) const override;
+
     [[nodiscard]] std::span<const double> get_spectrum(params::dc::DetectorType detector) const noexcept override {
       return m_LiSpectrum.at(detector);
     }
@@ -22,8 +28,12 @@ namespace ana::dc {
       return m_BackgroundTemplate.at(type);
     }
 
+    [[nodiscard]] const Eigen::MatrixXd& shape_response(params::dc::DetectorType detector) const {
+      return m_ShapeResponse.at(detector);
+    }
+
    private:
-    using array_t = std::array<double, 44>;
+    using array_t = Binning::spectrum_t;
 
     template <typename T>
     using map_t = std::unordered_map<params::dc::DetectorType, T>;
@@ -33,6 +43,10 @@ namespace ana::dc {
 
     map_t<std::shared_ptr<Eigen::MatrixXd>> m_CovMatrix;
 
+    map_t<Eigen::MatrixXd> m_ShapeResponse;  // Derivative of the spectra with respect to the shape parameters
+
+    SpectrumWorkspace m_Workspace;  // Scratch memory of the spectrum calculation
+
     void recalculate_spectra(const ParameterWrapper& parameter);
 
     void fill_data(params::dc::DetectorType);
@@ -0,0 +1,297 @@
+#include "NuisanceProfiler.h"
+#include "DCLikelihood.h"
+
+// STL includes
+#include <algorithm>
+#include <stdexcept>
+
+// Eigen includes
+#include <Eigen/Cholesky>
+
+namespace ana::dc {
+
+  namespace {
+    constexpr int nBins = Binning::spectrum_bins;
+
+    constexpr int max_newton_steps = 50;
+
+    // Convergence threshold for the Newton decrement, i.e. the expected decrease of the likelihood
+    constexpr double newton_decrement_limit = 1.0e-10;
+
+    constexpr std::array<params::dc::DetectorType, 3> detectors = {params::dc::DetectorType::ND,
+                                                                   params::dc::DetectorType::FDI,
+                                                                   params::dc::DetectorType::FDII};
+
+    /**
+     * @brief The spectrum component and local shape index a linear nuisance parameter belongs to.
+     */
+    struct NuisanceInfo {
+      enum class Component { None, Lithium, Accidental, FastN, Reactor } component = Component::None;
+
+      int detector = -1;  ///< The position of the detector in detectors, -1 for all detectors.
+      int shape    = -1;  ///< The index within the shape parameters of the component.
+    };
+
+    NuisanceInfo nuisance_info(const int idx) noexcept {
+      using namespace params;
+      using namespace params::dc;
+
+      NuisanceInfo info;
+
+      if (idx >= LiShape01 && idx <= LiShape38) {
+        info.component = NuisanceInfo::Component::Lithium;
+        info.shape     = idx - LiShape01;
+        return info;
+      }
+
+      if (idx < number_of_general_parameters() || idx >= number_of_parameters()) {
+        return info;
+      }
+
+      const int local = (idx - number_of_general_parameters()) % number_of_DoubleChooz_detector_parameters();
+
+      info.detector = (idx - number_of_general_parameters()) / number_of_DoubleChooz_detector_parameters();
+
+      if (local >= AccShape01 && local <= AccShape38) {
+        info.component = NuisanceInfo::Component::Accidental;
+        info.shape     = local - AccShape01;
+      } else if (local >= FNSMShape01 && local <= FNSMShape44) {
+        info.component = NuisanceInfo::Component::FastN;
+        info.shape     = local - FNSMShape01;
+      } else if (local >= NuShape01 && local <= NuShape43) {
+        info.component = NuisanceInfo::Component::Reactor;
+        info.shape     = local - NuShape01;
+      }
+
+      return info;
+    }
+  }  // namespace
+
+  NuisanceProfiler::NuisanceProfiler(DCLikelihood& likelihood, std::vector<int> indices)
+    : m_Likelihood(likelihood)
+    , m_Indices(std::move(indices))
+    , m_Precision(static_cast<Eigen::Index>(m_Indices.size()))
+    , m_Mean(static_cast<Eigen::Index>(m_Indices.size()))
+    , m_Solution(Eigen::VectorXd::Zero(static_cast<Eigen::Index>(m_Indices.size())))
+    , m_X(params::number_of_parameters(), 0.0)
+    , m_Terms(detectors.size() + (likelihood.uses_off_off_data() ? DCLikelihood::off_off_detectors.size() : 0))
+    , m_HasSolution(false) {
+    for (std::size_t j = 0; j < m_Indices.size(); ++j) {
+      const int idx = m_Indices[j];
+
+      if (!is_linear_nuisance(idx)) {
+        throw std::invalid_argument("Parameter " + std::to_string(idx) + " is not a linear nuisance parameter");
+      }
+
+      const auto [precision, mean] = m_Likelihood.gaussian_prior(idx);
+      if (!(precision > 0.0)) {
+        throw std::invalid_argument("Parameter " + std::to_string(idx) + " has no Gaussian prior and can not be profiled");
+      }
+
+      m_Precision[static_cast<Eigen::Index>(j)] = precision;
+      m_Mean[static_cast<Eigen::Index>(j)]      = mean;
+    }
+  }
+
+  bool NuisanceProfiler::is_linear_nuisance(const int idx) noexcept {
+    return nuisance_info(idx).component != NuisanceInfo::Component::None;
+  }
+
+  void NuisanceProfiler::calculate_response() {
+    using Component = NuisanceInfo::Component;
+
+    const auto n = static_cast<Eigen::Index>(m_Indices.size());
+
+    const auto& reactor = m_Likelihood.reactor_spectrum();
+
+    for (std::size_t d = 0; d < detectors.size(); ++d) {
+      const auto detector = detectors[d];
+
+      auto& response = m_Response[d];
+      response.setZero(nBins, n);
+
+      const Eigen::MatrixXd& acc = m_Likelihood.accidental_background().shape_response(detector);
+      const Eigen::MatrixXd& li  = m_Likelihood.lithium_background().shape_response(detector);
+      const Eigen::MatrixXd& fn  = m_Likelihood.fastn_background().shape_response(detector);
+      const Eigen::MatrixXd& nu  = reactor.shape_correction()->shape_response(detector);
+
+      // The reactor shape acts on the fine binned spectrum before the energy correction and the normalization
+      const double          mcNorm      = m_Likelihood.calculate_mcNorm(m_Likelihood.parameter(), detector);
+      const Eigen::MatrixXd nu_response = mcNorm * reactor.energy_correction()->linear_map(detector).leftCols(nu.rows()) * nu;
+
+      for (Eigen::Index j = 0; j < n; ++j) {
+        const auto info = nuisance_info(m_Indices[static_cast<std::size_t>(j)]);
+
+        if (info.detector >= 0 && info.detector != static_cast<int>(d)) {
+          continue;
+        }
+
+        switch (info.component) {
+          case Component::Lithium:
+            response.col(j).head(li.rows()) = li.col(info.shape);
+            break;
+          case Component::Accidental:
+            response.col(j).head(acc.rows()) = acc.col(info.shape);
+            break;
+          case Component::FastN:
+            response.col(j).head(fn.rows()) = fn.col(info.shape);
+            break;
+          case Component::Reactor:
+            response.col(j) = nu_response.col(info.shape);
+            break;
+          case Component::None:
+            break;
+        }
+      }
+    }
+  }
+
+  void NuisanceProfiler::calculate_off_off_response() {
+    using Component = NuisanceInfo::Component;
+
+    const auto n = static_cast<Eigen::Index>(m_Indices.size());
+
+    for (std::size_t t = detectors.size(); t < m_Terms; ++t) {
+      const auto detector = DCLikelihood::off_off_detectors[t - detectors.size()];
+      const auto d        = static_cast<std::size_t>(std::distance(detectors.begin(), std::ranges::find(detectors, detector)));
+
+      // The off-off prediction is the background rescaled to the off-off lifetime, above the threshold bin
+      auto& response = m_Response[t];
+      response       = m_Likelihood.off_off_scale(detector) * m_Response[d];
+      response.topRows(static_cast<Eigen::Index>(DCLikelihood::off_off_first_bin)).setZero();
+
+      for (Eigen::Index j = 0; j < n; ++j) {
+        if (nuisance_info(m_Indices[static_cast<std::size_t>(j)]).component == Component::Reactor) {
+          response.col(j).setZero();
+        }
+      }
+    }
+  }
+
+  void NuisanceProfiler::profile(const double* parameter) {
+    const auto n = static_cast<Eigen::Index>(m_Indices.size());
+
+    // Start from the previous solution, which is close to the new one for small changes of the other parameters
+    std::copy_n(parameter, m_X.size(), m_X.begin());
+    for (Eigen::Index j = 0; j < n; ++j) {
+      if (m_HasSolution) {
+        m_X[m_Indices[static_cast<std::size_t>(j)]] = m_Solution[j];
+      }
+      m_Solution[j] = m_X[m_Indices[static_cast<std::size_t>(j)]];
+    }
+
+    m_Likelihood.check_and_recalculate(m_X.data());
+    calculate_response();
+    calculate_off_off_response();
+
+    const Eigen::VectorXd p0 = m_Solution;
+
+    std::array<Eigen::Array<double, nBins, 1>, 5> data;
+    std::array<Eigen::Array<double, nBins, 1>, 5> mu0;
+    for (std::size_t d = 0; d < detectors.size(); ++d) {
+      const auto measurement = m_Likelihood.get_measurement_data(detectors[d]);
+      std::copy(measurement.begin(), measurement.end(), data[d].begin());
+
+      mu0[d] = m_Likelihood.calculate_prediction(m_Likelihood.parameter(), detectors[d]);
+
+      // The likelihood is not defined here, keep the current values
+      if ((mu0[d] <= 0.0).any()) {
+        return;
+      }
+    }
+
+    for (std::size_t t = detectors.size(); t < m_Terms; ++t) {
+      const auto detector    = DCLikelihood::off_off_detectors[t - detectors.size()];
+      const auto measurement = m_Likelihood.get_off_off_data(detector);
+      std::copy(measurement.begin(), measurement.end(), data[t].begin());
+
+      mu0[t] = m_Likelihood.calculate_off_off_prediction(detector);
+
+      // The bins below the threshold have no response, equal data and prediction remove them from the sums
+      const auto first = static_cast<Eigen::Index>(DCLikelihood::off_off_first_bin);
+      data[t].head(first).setOnes();
+      mu0[t].head(first).setOnes();
+
+      if ((mu0[t] <= 0.0).any()) {
+        return;
+      }
+    }
+
+    Eigen::VectorXd p = p0;
+    Eigen::VectorXd gradient(n);
+    Eigen::VectorXd step(n);
+
+    std::array<Eigen::Array<double, nBins, 1>, 5> mu;
+
+    Eigen::LLT<Eigen::MatrixXd> llt;
+
+    for (int iteration = 0; iteration < max_newton_steps; ++iteration) {
+      // Gradient and Hessian of -2 log L + pulls, which are exact for the linear model of the prediction
+      gradient  = 2.0 * m_Precision.cwiseProduct(p - m_Mean);
+      m_Hessian = (2.0 * m_Precision).asDiagonal();
+
+      for (std::size_t d = 0; d < m_Terms; ++d) {
+        mu[d] = mu0[d] + (m_Response[d] * (p - p0)).array();
+
+        const Eigen::VectorXd residual = (2.0 * (1.0 - data[d] / mu[d])).matrix();
+        const Eigen::VectorXd weight   = (2.0 * data[d] / mu[d].square()).matrix();
+
+        gradient.noalias() += m_Response[d].transpose() * residual;
+        m_Hessian.noalias() += m_Response[d].transpose() * weight.asDiagonal() * m_Response[d];
+      }
+
+      llt.compute(m_Hessian);
+      if (llt.info() != Eigen::Success) {
+        break;
+      }
+
+      step = -llt.solve(gradient);
+
+      const double decrement = -gradient.dot(step);
+
+      // Halve the step until the prediction stays positive in all bins
+      double length = 1.0;
+      for (int halving = 0; halving < 50; ++halving) {
+        bool positive = true;
+        for (std::size_t d = 0; d < m_Terms; ++d) {
+          positive &= ((mu[d] + length * (m_Response[d] * step).array()) > 0.0).all();
+        }
+        if (positive) {
+          break;
+        }
+        length *= 0.5;
+      }
+
+      p += length * step;
+
+      if (decrement < newton_decrement_limit) {
+        break;
+      }
+    }
+
+    m_Solution    = p;
+    m_HasSolution = true;
+
+    for (Eigen::Index j = 0; j < n; ++j) {
+      m_X[m_Indices[static_cast<std::size_t>(j)]] = p[j];
+    }
+
+    m_Likelihood.check_and_recalculate(m_X.data());
+  }
+
+  std::vector<double> NuisanceProfiler::conditional_errors() const {
+    std::vector<double> errors(m_Indices.size(), 0.0);
+    if (!m_HasSolution || m_Hessian.rows() != static_cast<Eigen::Index>(m_Indices.size())) {
+      return errors;
+    }
+
+    // The likelihood is a chi-square like quantity, hence the covariance is twice the inverse Hessian
+    const Eigen::MatrixXd covariance = 2.0 * m_Hessian.llt().solve(Eigen::MatrixXd::Identity(m_Hessian.rows(), m_Hessian.cols()));
+    for (std::size_t j = 0; j < errors.size(); ++j) {
+      errors[j] = std::sqrt(covariance(static_cast<Eigen::Index>(j), static_cast<Eigen::Index>(j)));
+    }
+
+    return errors;
+  }
+
+}  // namespace ana::dc
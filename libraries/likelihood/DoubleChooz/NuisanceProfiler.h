@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Parameter.h"
+
+// STL includes
+#include <array>
+#include <span>
+#include <vector>
+
+// Eigen includes
+#include <Eigen/Core>
+
+namespace ana::dc {
+
+  class DCLikelihood;
+
+  /**
+   * @class NuisanceProfiler
+   * @brief Profiles the linear shape nuisance parameters of the Double Chooz likelihood analytically.
+   *
+   * The NuShape, AccShape, LiShape and FNSMShape parameters enter the prediction linearly through the Cholesky
+   * factors of the shape covariance matrices and have Gaussian pulls. For fixed non-linear parameters the
+   * likelihood is therefore convex in them and its minimum is found by a few Newton steps, each an iteratively
+   * reweighted linear solve. The derivative of the prediction is calculated once per evaluation from the
+   * spectrum components, the Newton steps work on the linear model of the prediction, and the spectra are
+   * recalculated exactly at the solution. With the off-off data, the background shape parameters of ND and FDII
+   * also enter the off-off prediction, which is part of the Newton steps like the detector spectra.
+   */
+  class NuisanceProfiler {
+   public:
+    /**
+     * @brief Constructs the profiler.
+     *
+     * @param likelihood The likelihood whose parameters are profiled.
+     * @param indices The indices of the profiled parameters. They have to be linear nuisances with a Gaussian prior.
+     * @throws std::invalid_argument if a parameter is not a linear nuisance or has no Gaussian prior.
+     */
+    NuisanceProfiler(DCLikelihood& likelihood, std::vector<int> indices);
+
+    ~NuisanceProfiler() = default;
+
+    /**
+     * @brief Checks if the parameter with the given index enters the prediction linearly.
+     */
+    [[nodiscard]] static bool is_linear_nuisance(int idx) noexcept;
+
+    /**
+     * @brief Sets the profiled parameters to their conditional minimum for the given non-linear parameters.
+     *
+     * The spectra of the likelihood are recalculated at the full parameter vector afterward.
+     *
+     * @param parameter The full parameter vector, the values of the profiled parameters are ignored.
+     */
+    void profile(const double* parameter);
+
+    [[nodiscard]] const std::vector<int>& indices() const noexcept { return m_Indices; }
+
+    /**
+     * @brief Returns the full parameter vector of the last profiling, including the profiled parameters.
+     */
+    [[nodiscard]] std::span<const double> parameters() const noexcept { return m_X; }
+
+    /**
+     * @brief Returns the errors of the profiled parameters for fixed non-linear parameters at the last solution.
+     */
+    [[nodiscard]] std::vector<double> conditional_errors() const;
+
+   private:
+    /**
+     * @brief Calculates the derivative of the prediction of every detector with respect to the profiled parameters.
+     */
+    void calculate_response();
+
+    /**
+     * @brief Calculates the derivative of the off-off predictions from the responses of their detectors.
+     */
+    void calculate_off_off_response();
+
+    DCLikelihood& m_Likelihood;  ///< The likelihood whose parameters are profiled.
+
+    std::vector<int> m_Indices;  ///< The indices of the profiled parameters.
+
+    Eigen::VectorXd m_Precision;  ///< The precision of the Gaussian priors.
+    Eigen::VectorXd m_Mean;       ///< The mean of the Gaussian priors.
+    Eigen::VectorXd m_Solution;   ///< The last solution, used as start point of the next profiling.
+    Eigen::MatrixXd m_Hessian;    ///< The Hessian of the likelihood in the profiled parameters at the last solution.
+
+    std::vector<double> m_X;  ///< The full parameter vector handed to the spectrum components.
+
+    std::array<Eigen::MatrixXd, 5> m_Response;  ///< The derivative of the prediction per detector, followed by the off-off predictions of ND and FDII, spectrum bins x profiled parameters.
+    std::size_t                    m_Terms;     ///< The number of used responses, the off-off ones are only used with the off-off data.
+
+    bool m_HasSolution;  ///< Whether a previous solution exists.
+  };
+
+}  // namespace ana::dc
@@ -22,4 +22,12 @@ namespace ana::dc {
     const params::dc::DetectorType type; /**< The detector type. */
   };
 
+  /**
+   * @brief Single precision copies of the events of an OscillationData object for the float kernels.
+   */
+  struct FloatOscillationData {
+    std::span<const float> LoverE;  /**< The L over E data. */
+    std::span<const float> scaling; /**< The scaling data. */
+  };
+
 } // namespace ana::dc
\ No newline at end of file
@@ -1,6 +1,14 @@
 #include "Oscillator.h"
+#include "FourFlavorOscillation.h"
 #include "ThreeFlavorOscillation.h"
 
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+
 namespace ana::dc {
 
   inline std::vector<int> get_indices(std::span<const double> evis) {
@@ -20,37 +28,246 @@ namespace ana::dc {
     return indices;
   }
 
-  Oscillator::Oscillator(std::shared_ptr<io::Options> options)
-    : SpectrumBase(std::move(options)) {
+  /**
+   * @brief Returns the baseline which separates the two reactors, i.e. the center of the largest gap between the
+   *        baselines of the events.
+   */
+  inline double get_baseline_threshold(std::span<const double> distance) {
+    if (distance.size() < 2) {
+      throw std::invalid_argument("The reactor split requires at least two reactor events per detector");
+    }
+
+    std::vector<double> sorted(distance.begin(), distance.end());
+    std::ranges::sort(sorted);
+
+    std::size_t gap = 1;
+    for (std::size_t i = 2; i < sorted.size(); ++i) {
+      if (sorted[i] - sorted[i - 1] > sorted[gap] - sorted[gap - 1]) {
+        gap = i;
+      }
+    }
+
+    return 0.5 * (sorted[gap - 1] + sorted[gap]);
+  }
+
+  /**
+   * @brief Adds the events of one energy bin, pre-binned into equally wide L/E bins, to the reduced data.
+   *
+   * Every non-empty L/E bin becomes a single event with the summed scaling at the scaling weighted mean L/E, so
+   * the oscillated rate of the bin is exact as long as the probability is linear within the bin.
+   */
+  inline void pre_bin_events(std::span<const double> LoverE, std::span<const double> scaling, unsigned int bins,
+                             std::vector<double>& reduced_LoverE, std::vector<double>& reduced_scaling) {
+    if (LoverE.empty()) {
+      return;
+    }
+
+    const auto [min, max] = std::ranges::minmax(LoverE);
+    const double width    = (max - min) / bins;
+
+    std::vector<double> sum(bins, 0.0);
+    std::vector<double> weighted_sum(bins, 0.0);
+    std::vector<int>    count(bins, 0);
+
+    for (std::size_t i = 0; i < LoverE.size(); ++i) {
+      const auto bin = (width > 0.0) ? std::min(static_cast<unsigned int>((LoverE[i] - min) / width), bins - 1) : 0U;
+      sum[bin] += scaling[i];
+      weighted_sum[bin] += scaling[i] * LoverE[i];
+      ++count[bin];
+    }
+
+    for (unsigned int bin = 0; bin < bins; ++bin) {
+      if (count[bin] == 0) {
+        continue;
+      }
+      reduced_LoverE.push_back((sum[bin] != 0.0) ? weighted_sum[bin] / sum[bin] : min + (bin + 0.5) * width);
+      reduced_scaling.push_back(sum[bin]);
+    }
+  }
+
+  inline Oscillator::Precision get_precision(const std::string& precision) {
+    using enum Oscillator::Precision;
+    if (precision == "double") {
+      return Double;
+    }
+    if (precision == "float") {
+      return Float;
+    }
+    if (precision == "validate") {
+      return Validate;
+    }
+    throw std::invalid_argument("Unknown oscillation precision " + precision + ", use double, float or validate");
+  }
+
+  Oscillator::Oscillator(std::shared_ptr<io::Options> options, unsigned int coarse_bins)
+    : SpectrumBase(std::move(options), "Oscillator")
+    , m_ReactorSplit(m_Options->inputOptions().double_chooz().reactor_split())
+    , m_UseSterile(m_Options->inputOptions().double_chooz().use_sterile())
+    , m_CoarseBins(coarse_bins)
+    , m_Precision(get_precision(m_Options->inputOptions().double_chooz().oscillation_precision())) {
     using enum params::dc::DetectorType;
 
+    auto events = std::make_shared<EventData>();
     for (const auto detector : {ND, FDI, FDII}) {
       const auto& reactorData = m_Options->double_chooz().dataBase().reactor_data(detector);
-      add_reactor_data(reactorData, detector);
+      if (m_ReactorSplit) {
+        add_split_reactor_data(*events, reactorData, detector);
+      } else {
+        add_reactor_data(*events, reactorData.LoverE(), reactorData.evis(), reactorData.scaling(), detector);
+      }
+    }
+
+    place_event_data(*events, utilities::parse_memory_placement(m_Options->inputOptions().memory_placement()));
+    m_Events = std::move(events);
+
+    create_cache();
+  }
+
+  Oscillator::Oscillator(std::shared_ptr<io::Options> options, const Oscillator& other)
+    : SpectrumBase(std::move(options), "Oscillator")
+    , m_ReactorSplit(other.m_ReactorSplit)
+    , m_UseSterile(other.m_UseSterile)
+    , m_CoarseBins(other.m_CoarseBins)
+    , m_Precision(other.m_Precision)
+    , m_Events(other.m_Events) {
+    create_cache();
+  }
+
+  void Oscillator::create_cache() {
+    using enum params::dc::DetectorType;
+
+    // The spectra are created up front, the parallel oscillation only looks them up
+    for (const auto detector : {ND, FDI, FDII}) {
+      m_Cache[detector] = {};
+      if (m_ReactorSplit) {
+        m_Cache[params::dc::cast_to_B1_split(detector)] = {};
+        m_Cache[params::dc::cast_to_B2_split(detector)] = {};
+      }
+    }
+  }
+
+  void Oscillator::place_event_data(EventData& events, const utilities::MemoryPlacement placement) const {
+    const std::size_t N = events.calculation_data.size();
+
+    // The events of a bin follow the ones of the previous bin
+    std::vector<std::size_t> offsets(N + 1, 0);
+    for (std::size_t i = 0; i < N; ++i) {
+      offsets[i + 1] = offsets[i] + events.calculation_data[i].LoverE.size();
+    }
+
+    const bool place_double = placement != utilities::MemoryPlacement::Default;
+    const bool add_float    = m_Precision != Precision::Double;
+
+    utilities::PlacedArray<double> LoverE(place_double ? offsets[N] : 0, placement);
+    utilities::PlacedArray<double> scaling(place_double ? offsets[N] : 0, placement);
+    utilities::PlacedArray<float>  float_LoverE(add_float ? offsets[N] : 0, placement);
+    utilities::PlacedArray<float>  float_scaling(add_float ? offsets[N] : 0, placement);
+
+    // The same range and grain as in oscillate() give the same chunks on the same threads
+    m_Options->scheduler().parallel_for(N, sweep_grain, [&](const std::size_t begin, const std::size_t end) {
+      for (std::size_t i = begin; i < end; ++i) {
+        const auto& data = events.calculation_data[i];
+        if (place_double) {
+          std::ranges::copy(data.LoverE, LoverE.data() + offsets[i]);
+          std::ranges::copy(data.scaling, scaling.data() + offsets[i]);
+        }
+        if (add_float) {
+          std::ranges::copy(data.LoverE, float_LoverE.data() + offsets[i]);
+          std::ranges::copy(data.scaling, float_scaling.data() + offsets[i]);
+        }
+      }
+    });
+
+    if (place_double) {
+      std::vector<OscillationData> placed;
+      placed.reserve(N);
+      for (std::size_t i = 0; i < N; ++i) {
+        const auto& data = events.calculation_data[i];
+        placed.emplace_back(LoverE.span().subspan(offsets[i], offsets[i + 1] - offsets[i]),
+                            scaling.span().subspan(offsets[i], offsets[i + 1] - offsets[i]),
+                            data.target_bin,
+                            data.type);
+      }
+      events.calculation_data = std::move(placed);
+      events.placed_LoverE    = std::move(LoverE);
+      events.placed_scaling   = std::move(scaling);
+
+      // The split and pre-binned events are not referenced anymore
+      events.split_data.clear();
+      events.reduced_data.clear();
+    }
+
+    if (add_float) {
+      for (std::size_t i = 0; i < N; ++i) {
+        events.float_calculation_data.push_back({float_LoverE.span().subspan(offsets[i], offsets[i + 1] - offsets[i]),
+                                          float_scaling.span().subspan(offsets[i], offsets[i + 1] - offsets[i])});
+      }
+      events.float_LoverE  = std::move(float_LoverE);
+      events.float_scaling = std::move(float_scaling);
     }
   }
 
-  void Oscillator::add_reactor_data(const io::ReactorData& reactorData, params::dc::DetectorType type) {
-    // Get the L over E data
-    span_t LoverE = reactorData.LoverE();
+  void Oscillator::add_split_reactor_data(EventData& events, const io::ReactorData& reactorData, params::dc::DetectorType detector) const {
+    using params::dc::cast_to_B1_split;
+    using params::dc::cast_to_B2_split;
+
+    const span_t distance  = reactorData.distance();
+    const double threshold = get_baseline_threshold(distance);
 
-    // Get the visual energy data
-    span_t evis = reactorData.evis();
+    SplitReactorData& b1 = events.split_data[cast_to_B1_split(detector)];
+    SplitReactorData& b2 = events.split_data[cast_to_B2_split(detector)];
 
-    // Get the scaling data
-    span_t scaling = reactorData.scaling();
+    // The events of the reactor with the shorter baseline form the B1 data set. The events keep their order, so
+    // both parts stay sorted by the visual energy.
+    for (std::size_t i = 0, N = distance.size(); i < N; ++i) {
+      SplitReactorData& part = (distance[i] < threshold) ? b1 : b2;
+      part.LoverE.push_back(reactorData.LoverE()[i]);
+      part.evis.push_back(reactorData.evis()[i]);
+      part.scaling.push_back(reactorData.scaling()[i]);
+    }
+
+    // Every event is oscillated once in its split data set, the detector spectrum is the sum of both
+    add_reactor_data(events, b1.LoverE, b1.evis, b1.scaling, cast_to_B1_split(detector));
+    add_reactor_data(events, b2.LoverE, b2.evis, b2.scaling, cast_to_B2_split(detector));
+  }
 
+  void Oscillator::add_reactor_data(EventData& events, span_t LoverE, span_t evis, span_t scaling, params::dc::DetectorType type) const {
     // Get the target bin indices
     const std::vector<int> indices = get_indices(evis);
 
+    if (m_CoarseBins > 0) {
+      add_reduced_reactor_data(events, LoverE, scaling, indices, type);
+      return;
+    }
+
     for (unsigned int i = 1, N = indices.size(); i < N; ++i) {
-      m_CalculationData.emplace_back(std::span(&LoverE[indices[i - 1]], indices[i] - indices[i - 1]),
+      events.calculation_data.emplace_back(std::span(&LoverE[indices[i - 1]], indices[i] - indices[i - 1]),
                                      std::span(&scaling[indices[i - 1]], indices[i] - indices[i - 1]),
                                      i,
                                      type);
     }
   }
 
+  void Oscillator::add_reduced_reactor_data(EventData& events, span_t LoverE, span_t scaling, const std::vector<int>& indices,
+                                            params::dc::DetectorType type) const {
+    ReducedReactorData& reduced = events.reduced_data[type];
+
+    // The reduced events are referenced by spans, so they are added only after all energy bins are pre-binned
+    std::vector<std::size_t> offsets = {0};
+    for (unsigned int i = 1, N = indices.size(); i < N; ++i) {
+      const auto size = static_cast<std::size_t>(indices[i] - indices[i - 1]);
+      pre_bin_events(LoverE.subspan(indices[i - 1], size), scaling.subspan(indices[i - 1], size), m_CoarseBins, reduced.LoverE, reduced.scaling);
+      offsets.push_back(reduced.LoverE.size());
+    }
+
+    for (unsigned int i = 1, N = indices.size(); i < N; ++i) {
+      events.calculation_data.emplace_back(span_t(reduced.LoverE).subspan(offsets[i - 1], offsets[i] - offsets[i - 1]),
+                                     span_t(reduced.scaling).subspan(offsets[i - 1], offsets[i] - offsets[i - 1]),
+                                     i,
+                                     type);
+    }
+  }
+
   inline bool check_parameter(const ParameterWrapper& parameter) noexcept {
     using enum params::General;
 
@@ -59,36 +276,100 @@ namespace ana::dc {
     return recalculate;
   }
 
+  void Oscillator::register_parameters(params::ParameterRegistry& registry) const {
+    using enum params::General;
+
+    registry.add_component("Oscillator", {{SinSqT13, DeltaM41 + 1}});
+  }
+
   void Oscillator::recalculate_spectra(const ParameterWrapper& parameter) noexcept {
+    PHYLINO_TIMELINE_SCOPE("Oscillator", "component");
     perform_cpu_oscillation(parameter);
   }
 
   bool Oscillator::check_and_recalculate(const ParameterWrapper& parameter) noexcept {
+    // The events of all detectors are oscillated in one loop, so there are no counters per detector
+    PHYLINO_PROFILE_SCOPE(timer, m_Profile.total());
+
     const bool recalculate = check_parameter(parameter);
 
     if (recalculate) {
       recalculate_spectra(parameter);
     }
 
+    PHYLINO_PROFILE_RECOMPUTED(timer, recalculate);
+
     return recalculate;
   }
 
   void Oscillator::perform_cpu_oscillation(const ParameterWrapper& parameter) noexcept {
-    const std::size_t N = m_CalculationData.size();
+    using enum params::General;
+
+    // The sterile search uses the four-flavor probability, which calculates all terms in the same loop
+    if (m_UseSterile) {
+      oscillate(FourFlavorOscillation(parameter[SinSqT13],
+                                      parameter[DeltaMee],
+                                      parameter[SinSqT12],
+                                      parameter[DeltaM21],
+                                      parameter[SinSqT14],
+                                      parameter[DeltaM41]));
+    } else {
+      oscillate(ThreeFlavorOscillation(parameter[SinSqT13],
+                                       parameter[DeltaMee],
+                                       parameter[SinSqT12],
+                                       parameter[DeltaM21]));
+    }
+  }
+
+  void Oscillator::oscillate(const RangeOscillator& osci) noexcept {
+    const auto&       calculation_data = m_Events->calculation_data;
+    const std::size_t N                = calculation_data.size();
 
     for (auto& [_, spectra] : m_Cache) {
       std::ranges::fill(spectra, 0.0);
     }
 
-    const ThreeFlavorOscillation osci(parameter[params::General::SinSqT13],
-                                      parameter[params::General::DeltaMee],
-                                      parameter[params::General::SinSqT12],
-                                      parameter[params::General::DeltaM21]);
+    std::mutex deviation_mutex;
+
+    // The bins are independent and every bin has its own slot in the cache, the cache is only searched with find,
+    // which does not modify the map, so chunks of bins are oscillated in parallel
+    m_Options->scheduler().parallel_for(N, sweep_grain, [&](const std::size_t begin, const std::size_t end) {
+      double max_deviation = 0.0;
+
+      for (std::size_t i = begin; i < end; ++i) {
+        const auto& data  = calculation_data[i];
+        auto&       cache = m_Cache.find(data.type)->second;
+
+        if (m_Precision == Precision::Double) {
+          cache[data.target_bin] = osci(data);
+          continue;
+        }
+
+        const double value = osci(data, m_Events->float_calculation_data[i]);
+        if (m_Precision == Precision::Validate) {
+          const double reference = osci(data);
+          if (reference != 0.0) {
+            max_deviation = std::max(max_deviation, std::abs(value - reference) / std::abs(reference));
+          }
+        }
+        cache[data.target_bin] = value;
+      }
 
-    // #pragma omp parallel for
-    for (std::size_t i = 0UL; i < N; ++i) {
-      const auto& data                    = m_CalculationData[i];
-      m_Cache[data.type][data.target_bin] = osci(data);
+      if (m_Precision == Precision::Validate) {
+        const std::scoped_lock lock(deviation_mutex);
+        m_MaxRelativeDeviation = std::max(m_MaxRelativeDeviation, max_deviation);
+      }
+    });
+
+    if (m_ReactorSplit) {
+      using enum params::dc::DetectorType;
+
+      for (const auto detector : {ND, FDI, FDII}) {
+        const auto& b1 = m_Cache[params::dc::cast_to_B1_split(detector)];
+        const auto& b2 = m_Cache[params::dc::cast_to_B2_split(detector)];
+
+        std::ranges::transform(b1, b2, m_Cache[detector].begin(), std::plus<>{});
+      }
     }
   }
 
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "MemoryPlacement.h"
 #include "Options.h"
 #include "OscillationData.h"
+#include "RangeOscillator.h"
 #include "../ParameterWrapper.h"
 #include "SpectrumBase.h"
 
@@ -13,12 +15,34 @@ namespace ana::dc {
    */
   class Oscillator : public SpectrumBase {
    public:
+    /**
+     * @brief The precision of the oscillation of the events.
+     */
+    enum class Precision {
+      Double,   ///< The events are oscillated in double precision.
+      Float,    ///< The events are oscillated in single precision with a compensated sum.
+      Validate  ///< The single precision result is used and compared with the double precision one.
+    };
+
     /**
      * @brief Constructs an Oscillator object with the given options.
      *
      * @param options The options for the Oscillator.
+     * @param coarse_bins The number of L/E bins per energy bin the events are pre-binned into, 0 to oscillate
+     *                    every event. The pre-binned events are a reduced reactor MC for a coarse fit level.
      */
-    explicit Oscillator(std::shared_ptr<io::Options> options);
+    explicit Oscillator(std::shared_ptr<io::Options> options, unsigned int coarse_bins = 0);
+
+    /**
+     * @brief Constructs an Oscillator which shares the events of another one.
+     *
+     * The events are not modified after the construction, so only the oscillated spectra are owned by the new
+     * Oscillator, e.g. for a copy of the likelihood which is evaluated on another thread.
+     *
+     * @param options The options for the Oscillator.
+     * @param other The Oscillator whose events are shared.
+     */
+    Oscillator(std::shared_ptr<io::Options> options, const Oscillator& other);
 
     /**
      * @brief Destructor for the Oscillator object.
@@ -27,9 +51,17 @@ namespace ana::dc {
 
     bool check_and_recalculate(const ParameterWrapper& parameter) noexcept override;
 
+    /**
+     * @brief Registers the oscillation parameters.
+     */
+    void register_parameters(params::ParameterRegistry& registry) const override;
+
     /**
      * @brief Returns the calculated spectra for the given detector type.
      *
+     * If the reactor split is enabled, the spectra of the split types, e.g. NDB1, are available as well and the
+     * spectrum of a detector is the sum of its two split spectra.
+     *
      * @param type The detector type.
      * @return The calculated spectra.
      */
@@ -37,17 +69,113 @@ namespace ana::dc {
       return m_Cache.at(type);
     }
 
+    /**
+     * @brief Checks whether the events are split by their baseline into the B1 and B2 data sets.
+     */
+    [[nodiscard]] bool reactor_split() const noexcept { return m_ReactorSplit; }
+
+    /**
+     * @brief Returns the number of L/E bins per energy bin of the pre-binned events, 0 if every event is oscillated.
+     */
+    [[nodiscard]] unsigned int coarse_bins() const noexcept { return m_CoarseBins; }
+
+    [[nodiscard]] Precision precision() const noexcept { return m_Precision; }
+
+    /**
+     * @brief Returns the maximal relative deviation of a single precision bin from the double precision one.
+     *
+     * The deviation is only calculated with the precision Validate, it is the maximum of all recalculations.
+     */
+    [[nodiscard]] double max_relative_deviation() const noexcept { return m_MaxRelativeDeviation; }
+
    private:
     using span_t = std::span<const double>;
 
-    std::vector<OscillationData> m_CalculationData; /**< The data used for the actual computations. */
+    static constexpr std::size_t sweep_grain = 8; /**< The minimal number of bins a task of the oscillation sweep oscillates. */
+
+    /**
+     * @brief The events of a detector with the baseline of one reactor.
+     */
+    struct SplitReactorData {
+      std::vector<double> LoverE;  /**< The L over E data. */
+      std::vector<double> evis;    /**< The visual energy data. */
+      std::vector<double> scaling; /**< The scaling data. */
+    };
+
+    /**
+     * @brief The events of a data set pre-binned in L/E, consecutive per energy bin.
+     */
+    struct ReducedReactorData {
+      std::vector<double> LoverE;  /**< The scaling weighted mean L over E per L/E bin. */
+      std::vector<double> scaling; /**< The summed scaling per L/E bin. */
+    };
+
+    /**
+     * @brief The events of all data sets, which are not modified after the construction of the Oscillator.
+     */
+    struct EventData {
+      std::vector<OscillationData> calculation_data; /**< The data used for the actual computations. */
+
+      std::vector<FloatOscillationData> float_calculation_data; /**< The single precision copies of calculation_data. */
+
+      utilities::PlacedArray<double> placed_LoverE;  /**< The L over E of all events with the memory placement, referenced by calculation_data. */
+      utilities::PlacedArray<double> placed_scaling; /**< The scaling of all events with the memory placement, referenced by calculation_data. */
+
+      utilities::PlacedArray<float> float_LoverE;  /**< The single precision L over E of all events, referenced by float_calculation_data. */
+      utilities::PlacedArray<float> float_scaling; /**< The single precision scaling of all events, referenced by float_calculation_data. */
+
+      std::unordered_map<params::dc::DetectorType, SplitReactorData> split_data; /**< The events per reactor split type, referenced by calculation_data. */
 
-    std::unordered_map<params::dc::DetectorType, std::array<double, 80>> m_Cache; /**< The cache for the calculated spectra. */
+      std::unordered_map<params::dc::DetectorType, ReducedReactorData> reduced_data; /**< The pre-binned events per data set, referenced by calculation_data. */
+    };
+
+    bool         m_ReactorSplit; /**< Whether the events are split by their baseline. */
+    bool         m_UseSterile;   /**< Whether the four-flavor oscillation with a sterile neutrino is used. */
+    unsigned int m_CoarseBins;   /**< The number of L/E bins per energy bin of the pre-binned events, 0 for all events. */
+    Precision    m_Precision;    /**< The precision of the oscillation. */
+
+    double m_MaxRelativeDeviation = 0.0; /**< The maximal relative deviation of the single precision bins. */
+
+    std::shared_ptr<const EventData> m_Events; /**< The events, shared with the Oscillators constructed from this one. */
+
+    std::unordered_map<params::dc::DetectorType, Binning::reactor_spectrum_t> m_Cache; /**< The cache for the calculated spectra. */
+
+    /**
+     * @brief Creates the spectra of all data sets in the cache.
+     */
+    void create_cache();
 
-    void add_reactor_data(const io::ReactorData& reactorData, params::dc::DetectorType type);
+    void add_reactor_data(EventData& events, span_t LoverE, span_t evis, span_t scaling, params::dc::DetectorType type) const;
+
+    /**
+     * @brief Pre-bins the events of every energy bin into m_CoarseBins L/E bins and adds the bins as events.
+     *
+     * @param indices The indices of the first event of every energy bin.
+     */
+    void add_reduced_reactor_data(EventData& events, span_t LoverE, span_t scaling, const std::vector<int>& indices, params::dc::DetectorType type) const;
+
+    /**
+     * @brief Splits the events of a detector at the largest gap of their baselines and adds both parts.
+     */
+    void add_split_reactor_data(EventData& events, const io::ReactorData& reactorData, params::dc::DetectorType detector) const;
+
+    /**
+     * @brief Copies the events of all bins into consecutive arrays with the given placement, in the order of the sweep.
+     *
+     * Except for the default placement, the double precision events are copied and the calculation data references the
+     * copies. The single precision copies for the float kernels are created as well if they are used. The arrays are
+     * filled with the chunks of the oscillation sweep, so with the local placement the pages of a chunk are first
+     * touched, and therefore placed, by the pinned thread which oscillates the chunk later.
+     */
+    void place_event_data(EventData& events, utilities::MemoryPlacement placement) const;
 
     void perform_cpu_oscillation(const ParameterWrapper& parameter) noexcept;
 
+    /**
+     * @brief Fills the cache with the oscillated spectra of all data sets.
+     */
+    void oscillate(const RangeOscillator& osci) noexcept;
+
     void recalculate_spectra(const ParameterWrapper& parameter) noexcept;
   };
 }  // namespace ana::dc
@@ -14,8 +14,17 @@ namespace ana::dc {
       return oscillate_events(data);
     }
 
+    /**
+     * @brief Oscillates the single precision copies of the events, the result is accumulated with compensation.
+     */
+    [[nodiscard]] double operator()(const OscillationData& data, const FloatOscillationData& single) const noexcept {
+      return oscillate_events(data, single);
+    }
+
    protected:
     [[nodiscard]] virtual double oscillate_events(const OscillationData& data) const noexcept = 0;
+
+    [[nodiscard]] virtual double oscillate_events(const OscillationData& data, const FloatOscillationData& single) const noexcept = 0;
   };
 
 }  // namespace ana::dc
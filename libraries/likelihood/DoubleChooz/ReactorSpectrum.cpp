@@ -2,9 +2,16 @@
 
 namespace ana::dc {
 
-  ReactorSpectrum::ReactorSpectrum(std::shared_ptr<io::Options> options)
-    : SpectrumBase(std::move(options)) {
-    m_Oscillator = std::make_shared<Oscillator>(m_Options);
+  ReactorSpectrum::ReactorSpectrum(std::shared_ptr<io::Options> options, unsigned int coarse_bins)
+    : SpectrumBase(std::move(options), "ReactorSpectrum") {
+    m_Oscillator = std::make_shared<Oscillator>(m_Options, coarse_bins);
+    m_ShapeCorrection = std::make_shared<ShapeCorrection>(m_Options, m_Oscillator);
+    m_EnergyCorrection = std::make_shared<EnergyCorrection>(m_Options, m_ShapeCorrection);
+  }
+
+  ReactorSpectrum::ReactorSpectrum(std::shared_ptr<io::Options> options, const ReactorSpectrum& other)
+    : SpectrumBase(std::move(options), "ReactorSpectrum") {
+    m_Oscillator = std::make_shared<Oscillator>(m_Options, *other.m_Oscillator);
     m_ShapeCorrection = std::make_shared<ShapeCorrection>(m_Options, m_Oscillator);
     m_EnergyCorrection = std::make_shared<EnergyCorrection>(m_Options, m_ShapeCorrection);
   }
@@ -13,6 +20,19 @@ namespace ana::dc {
     return m_EnergyCorrection->check_and_recalculate(parameter);
   }
 
+  void ReactorSpectrum::collect_profiles(std::vector<utilities::ComponentProfile*>& profiles) {
+    // The reactor spectrum itself only forwards to the energy correction, so it has no counters of its own
+    m_Oscillator->collect_profiles(profiles);
+    m_ShapeCorrection->collect_profiles(profiles);
+    m_EnergyCorrection->collect_profiles(profiles);
+  }
+
+  void ReactorSpectrum::register_parameters(params::ParameterRegistry& registry) const {
+    m_Oscillator->register_parameters(registry);
+    m_ShapeCorrection->register_parameters(registry);
+    m_EnergyCorrection->register_parameters(registry);
+  }
+
   std::span<const double> ReactorSpectrum::get_spectrum(params::dc::DetectorType type) const noexcept {
     return m_EnergyCorrection->get_spectrum(type);
   }
@@ -8,7 +8,19 @@ namespace ana::dc {
 
   class ReactorSpectrum : public SpectrumBase {
   public:
-    explicit ReactorSpectrum(std::shared_ptr<io::Options> options);
+    /**
+     * @param options The options of the analysis.
+     * @param coarse_bins The number of L/E bins per energy bin of the reduced reactor MC, 0 for the full one.
+     */
+    explicit ReactorSpectrum(std::shared_ptr<io::Options> options, unsigned int coarse_bins = 0);
+
+    /**
+     * @brief Constructs a reactor spectrum whose oscillator shares the events of another one, see Oscillator.
+     *
+     * @param options The options of the analysis.
+     * @param other The reactor spectrum whose events are shared.
+     */
+    ReactorSpectrum(std::shared_ptr<io::Options> options, const ReactorSpectrum& other);
 
     bool check_and_recalculate(const ParameterWrapper& parameter) override;
 
@@ -20,6 +32,16 @@ namespace ana::dc {
 
     [[nodiscard]] const auto& energy_correction() const noexcept { return m_EnergyCorrection; }
 
+    /**
+     * @brief Collects the timing counters of the oscillation, shape and energy correction steps.
+     */
+    void collect_profiles(std::vector<utilities::ComponentProfile*>& profiles) override;
+
+    /**
+     * @brief Registers the parameters of the oscillation, shape and energy correction steps.
+     */
+    void register_parameters(params::ParameterRegistry& registry) const override;
+
   private:
     std::shared_ptr<Oscillator> m_Oscillator;
     std::shared_ptr<ShapeCorrection> m_ShapeCorrection;
@@ -26,8 +26,18 @@ namespace ana::dc {
     return parameter_changed;
   }
 
+  void ShapeCorrection::register_parameters(params::ParameterRegistry& registry) const {
+    using enum params::dc::DetectorType;
+    using enum params::dc::Detector;
+    using Registry = params::ParameterRegistry;
+
+    registry.add_component("ShapeCorrection", {Registry::block(ND, NuShape01, NuShape43),
+                                               Registry::block(FDI, NuShape01, NuShape43),
+                                               Registry::block(FDII, NuShape01, NuShape43)});
+  }
+
   ShapeCorrection::ShapeCorrection(std::shared_ptr<io::Options> options, std::shared_ptr<Oscillator> oscillator)
-    : SpectrumBase(std::move(options))
+    : SpectrumBase(std::move(options), "ShapeCorrection")
     , m_Oscillator(std::move(oscillator)) {
     using enum params::dc::DetectorType;
 
@@ -41,17 +51,25 @@ namespace ana::dc {
 
   bool ShapeCorrection::check_and_recalculate(const ParameterWrapper& parameter) noexcept {
     const bool previous_step = m_Oscillator->check_and_recalculate(parameter);
-    const bool this_step     = parameter_changed(parameter);
-    const bool recalculate   = previous_step | this_step;
+
+    // Started after the previous step, which has its own counters
+    PHYLINO_PROFILE_SCOPE(timer, m_Profile.total());
+
+    const bool this_step   = parameter_changed(parameter);
+    const bool recalculate = previous_step | this_step;
 
     if (recalculate) {
       recalculate_spectra(parameter);
     }
 
+    PHYLINO_PROFILE_RECOMPUTED(timer, recalculate);
+
     return recalculate;
   }
 
   void ShapeCorrection::recalculate_spectra(const ParameterWrapper& parameter) noexcept {
+    PHYLINO_TIMELINE_SCOPE("ShapeCorrection", "component");
+
     using enum params::dc::DetectorType;
     using namespace params::dc;
 
@@ -60,6 +78,8 @@ namespace ana::dc {
     const double rate = 1.0;
 
     for (const auto detector : {ND, FDI, FDII}) {
+      PHYLINO_PROFILE_SCOPE(detector_timer, m_Profile.data_set(params::get_index(detector)));
+
       const std::span<const double> oscillated_spectrum = m_Oscillator->get_spectrum(detector);
 
       const auto shape_parameter = parameter.sub_range(params::index(detector, NuShape01),
@@ -69,13 +89,28 @@ namespace ana::dc {
 
       const Eigen::MatrixXd& covMatrix = *m_CovMatrix[detector];
 
-      std::array<double, 80>& result = m_Cache[detector];
+      Binning::reactor_spectrum_t& result = m_Cache[detector];
 
       calculate_spectrum(rate,
                          oscillated_spectrum,
                          shape_parameter,
                          covMatrix,
-                         result);
+                         result,
+                         m_Workspace,
+                         m_ComputeShapeResponse ? &m_ShapeResponse[detector] : nullptr);
+
+      if (m_Oscillator->reactor_split()) {
+        // The shape correction is relative per bin, so it is shared by the reactors in proportion to their
+        // contribution to the oscillated spectrum
+        for (const auto type : {cast_to_B1_split(detector), cast_to_B2_split(detector)}) {
+          const std::span<const double> split_spectrum = m_Oscillator->get_spectrum(type);
+
+          Binning::reactor_spectrum_t& split_result = m_Cache[type];
+          for (std::size_t i = 0; i < split_result.size(); ++i) {
+            split_result[i] = (oscillated_spectrum[i] > 0.0) ? result[i] * split_spectrum[i] / oscillated_spectrum[i] : 0.0;
+          }
+        }
+      }
     }
   }
 
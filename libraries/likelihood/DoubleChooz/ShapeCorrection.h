@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Calculate_Spectrum.h"
 #include "Oscillator.h"
 
 namespace ana::dc {
@@ -12,18 +13,29 @@ namespace ana::dc {
 
     bool check_and_recalculate(const ParameterWrapper& parameter) noexcept override;
 
+    /**
+     * @brief Registers the shape parameters of the reactor spectra of all detectors.
+     */
+    void register_parameters(params::ParameterRegistry& registry) const override;
+
     [[nodiscard]] std::span<const double> get_spectrum(params::dc::DetectorType type) const noexcept override {
       return m_Cache.at(type);
     }
 
+    [[nodiscard]] const Eigen::MatrixXd& shape_response(params::dc::DetectorType detector) const {
+      return m_ShapeResponse.at(detector);
+    }
+
    private:
     std::shared_ptr<Oscillator> m_Oscillator;
 
     template <typename T>
     using uo_map = std::unordered_map<params::dc::DetectorType, T>;
 
-    uo_map<std::array<double, 80>>           m_Cache;
+    uo_map<Binning::reactor_spectrum_t>      m_Cache;
     uo_map<std::shared_ptr<Eigen::MatrixXd>> m_CovMatrix;
+    uo_map<Eigen::MatrixXd>                  m_ShapeResponse;  // Derivative of the spectra with respect to the shape parameters
+    SpectrumWorkspace                        m_Workspace;      // Scratch memory of the spectrum calculation
 
     void recalculate_spectra(const ParameterWrapper& parameter) noexcept;
   };
@@ -0,0 +1,78 @@
+#pragma once
+
+// STL includes
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace ana::dc {
+
+  /**
+   * @brief Returns sin^2(x) in single precision.
+   *
+   * The argument is reduced to [-pi/2, pi/2] with a four part representation of pi, the sign of the sine does not
+   * matter for the square. The function has no branches and no calls, so it is vectorized with the loop it is
+   * used in. The relative error is a few ulp as long as x * 1/pi fits into an int.
+   */
+  #pragma omp declare simd
+  inline float fast_sin_sq(float x) noexcept {
+    constexpr float inv_pi = 0.318309886183790671537767526745f;
+    constexpr float pi_a   = 3.140625f;
+    constexpr float pi_b   = 0.0009670257568359375f;
+    constexpr float pi_c   = 6.2771141529083251953e-07f;
+    constexpr float pi_d   = 1.2154201256553420762e-10f;
+
+    x = std::abs(x);
+
+    const float k = static_cast<float>(static_cast<int>(x * inv_pi + 0.5f));
+    const float r = (((x - k * pi_a) - k * pi_b) - k * pi_c) - k * pi_d;
+
+    // Minimax polynomial of the sine on [-pi/2, pi/2]
+    const float r2 = r * r;
+    float       s  = 2.6083159809786593541503e-06f;
+    s              = s * r2 - 0.0001981069071916863322258f;
+    s              = s * r2 + 0.00833307858556509017944336f;
+    s              = s * r2 - 0.166666597127914428710938f;
+    s              = r + r * r2 * s;
+
+    return s * s;
+  }
+
+  /**
+   * @brief Sums term(i) for i < N in single precision with a Kahan compensated sum per SIMD lane.
+   *
+   * Every lane keeps its own sum and compensation, so the loop is vectorized, and the lanes are added in double
+   * precision at the end. The terms which do not fill a complete set of lanes are added in double precision.
+   *
+   * @param N The number of terms.
+   * @param term A function returning the float term of an index, it should be inlined into the loop.
+   */
+  template <typename Term>
+  [[nodiscard]] double compensated_sum(std::size_t N, Term term) noexcept {
+    constexpr std::size_t lanes = 16;
+
+    std::array<float, lanes> sum{};
+    std::array<float, lanes> compensation{};
+
+    std::size_t i = 0;
+    for (; i + lanes <= N; i += lanes) {
+      #pragma omp simd
+      for (std::size_t j = 0; j < lanes; ++j) {
+        const float y   = term(i + j) - compensation[j];
+        const float t   = sum[j] + y;
+        compensation[j] = (t - sum[j]) - y;
+        sum[j]          = t;
+      }
+    }
+
+    double result = 0.0;
+    for (; i < N; ++i) {
+      result += term(i);
+    }
+    for (std::size_t j = 0; j < lanes; ++j) {
+      result += static_cast<double>(sum[j]) - static_cast<double>(compensation[j]);
+    }
+    return result;
+  }
+
+}  // namespace ana::dc
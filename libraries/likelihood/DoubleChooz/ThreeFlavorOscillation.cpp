@@ -1,4 +1,5 @@
 #include "ThreeFlavorOscillation.h"
+#include "SinglePrecision.h"
 #include <iostream>
 
 namespace ana::dc {
@@ -40,4 +41,20 @@ namespace ana::dc {
 
     return result * get_MC_scaling_factor(params::dc::is_far_detector(data.type));
   }
+
+  double ThreeFlavorOscillation::oscillate_events(const OscillationData& data, const FloatOscillationData& single) const noexcept {
+    const float* loe = single.LoverE.data();
+    const float* scl = single.scaling.data();
+
+    const auto t13  = static_cast<float>(m_t13);
+    const auto dmee = static_cast<float>(m_dmee);
+    const auto cos4 = static_cast<float>(m_cos413 * m_t12);
+    const auto dm21 = static_cast<float>(m_dm21);
+
+    const double result = compensated_sum(single.LoverE.size(), [=](std::size_t i) noexcept {
+      return scl[i] * (1.0f - t13 * fast_sin_sq(dmee * loe[i]) - cos4 * fast_sin_sq(dm21 * loe[i]));
+    });
+
+    return result * get_MC_scaling_factor(params::dc::is_far_detector(data.type));
+  }
 }  // namespace ana::dc
@@ -14,6 +14,8 @@ namespace ana::dc {
   protected:
     [[nodiscard]] double oscillate_events(const OscillationData& data) const noexcept override;
 
+    [[nodiscard]] double oscillate_events(const OscillationData& data, const FloatOscillationData& single) const noexcept override;
+
   private:
     [[nodiscard]] static double get_MC_scaling_factor(bool is_far_detector) noexcept { return is_far_detector ? 0.01 : 0.1; }
 
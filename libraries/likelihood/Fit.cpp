@@ -1,30 +1,123 @@
 #include "Fit.h"
 
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ranges>
+#include <sstream>
+
+// includes
+#include "Timeline.h"
+
+// ROOT includes
+#include <Minuit2/MinimumState.h>
+#include <Minuit2/Minuit2Minimizer.h>
+
 namespace ana {
 
-  Fit::Fit(std::shared_ptr<io::Options> options)
+  namespace {
+    /**
+     * @brief Records the time between two iterations of a Minuit2 minimizer in the timeline.
+     */
+    class TimelineIterationTrace : public ROOT::Minuit2::MnTraceObject {
+     public:
+      void Init(const ROOT::Minuit2::MnUserParameterState&) override { m_Last = utilities::timeline_now(); }
+
+      void operator()(int, const ROOT::Minuit2::MinimumState&) override {
+        const auto now = utilities::timeline_now();
+        utilities::record_timeline_event("MigradIteration", "minimizer", m_Last, now);
+        m_Last = now;
+      }
+
+     private:
+      std::int64_t m_Last = 0;  ///< The time of the previous iteration.
+    };
+
+    // The oscillation parameters shared by all experiments. The atmospheric mass splitting is not shared, as
+    // Double Chooz fits the effective Delta m^2_ee and the medium-baseline setup Delta m^2_31.
+    const std::vector<std::string> shared_parameters = {"SinSqT13", "SinSqT12", "DeltaM21"};
+
+    /**
+     * @brief Returns the experiments selected in the options without their likelihoods, Double Chooz first.
+     */
+    std::vector<CompositeLikelihood::Experiment> describe_experiments(const io::Options& options) {
+      const auto& inputOptions = options.inputOptions();
+
+      std::vector<CompositeLikelihood::Experiment> experiments = {{"DoubleChooz", nullptr, inputOptions.input_parameters().names(), ""}};
+
+      std::stringstream ss(inputOptions.experiments());
+      for (std::string name; std::getline(ss, name, ',');) {
+        if (name == "DoubleChooz") {
+          continue;
+        }
+        if (name != "JUNO") {
+          throw std::invalid_argument("Unknown experiment " + name + ", use DoubleChooz or JUNO");
+        }
+        experiments.push_back({name, nullptr, juno::parameter_names(juno::MediumBaselineSetup::juno_like()), name + "/"});
+      }
+
+      return experiments;
+    }
+  }  // namespace
+
+  std::vector<std::string> Fit::parameter_names(const io::Options& options) {
+    return CompositeLikelihood::global_names(describe_experiments(options), shared_parameters);
+  }
+
+  Fit::Fit(std::shared_ptr<io::Options> options, std::shared_ptr<Checkpoint> checkpoint)
     : m_Options(std::move(options))
+    , m_ParameterNames(parameter_names(*m_Options))
+    , m_StartValues(m_ParameterNames.size(), 0.0)
+    , m_StepSizes(m_ParameterNames.size(), 0.0)
     , m_FitDuration(0)
     , m_Converged(false)
-    , m_FitPerformed(false) {
+    , m_FitPerformed(false)
+    , m_Checkpoint(std::move(checkpoint))
+    , m_NCalls(0)
+    , m_BestValue(std::numeric_limits<double>::max())
+    , m_BestParameters(m_ParameterNames.size(), 0.0)
+    , m_Parameters(m_ParameterNames.size(), 0.0)
+    , m_Errors(m_ParameterNames.size(), 0.0) {
     // Lock the mutex to ensure that the minimizer is not created in parallel due to ROOT limitations
     static std::mutex mutex;
     std::unique_lock  lock{mutex};
 
-    // Initialize Likelihood
-    // TODO Make this dynamic
-    m_DCLikelihood = std::make_shared<dc::DCLikelihood>(m_Options, params::number_of_parameters());
+    // Initialize the likelihoods of all experiments
+    create_likelihoods();
 
-    // Initialize the minimizer object
-    m_Minimizer = std::shared_ptr<ROOT::Math::Minimizer>(ROOT::Math::Factory::CreateMinimizer("Minuit2", "Migrad"));
+    // Initialize the minimizer object and the function to be minimized
+    create_minimizer();
 
-    // Initialize the functor object
-    m_Functor = std::make_shared<ROOT::Math::Functor>(m_DCLikelihood.get(),
-                                                      &dc::Likelihood::calculate_likelihood,
-                                                      params::number_of_parameters());
+    // Initialize the coarse level on a reduced reactor MC. It shares the data base of the options and fits the
+    // measurement data of the full likelihood.
+    if (const auto coarse_bins = m_Options->inputOptions().coarse_bins(); coarse_bins > 0) {
+      if (m_PoissonFunction) {
+        throw std::invalid_argument("The coarse fit level is not supported by the Fumili backend");
+      }
+      if (m_Composite) {
+        throw std::invalid_argument("The coarse fit level is not supported for combined experiments");
+      }
+      m_CoarseLikelihood = std::make_shared<dc::DCLikelihood>(m_Options, params::number_of_parameters(), coarse_bins);
+      m_CoarseLikelihood->use_measurement_data(*m_DCLikelihood);
+    }
 
-    // Set the function to be minimized
-    m_Minimizer->SetFunction(*m_Functor);
+    // Initialize the likelihood copies of the parallel gradient
+    create_gradient_likelihoods();
+
+    // Initialize the checkpoint of this fit, if no campaign checkpoint is handed over
+    const auto& inputOptions = m_Options->inputOptions();
+    if (!m_Checkpoint && !inputOptions.checkpoint_file().empty()) {
+      m_Checkpoint = std::make_shared<Checkpoint>(inputOptions.checkpoint_file(), inputOptions.checkpoint_interval());
+      if (inputOptions.resume() && m_Checkpoint->exists()) {
+        m_Checkpoint->load();
+      }
+    }
+
+    // Initialize the warm-start store
+    if (!inputOptions.warm_start_directory().empty()) {
+      m_WarmStartStore = std::make_shared<WarmStartStore>(inputOptions.warm_start_directory(), inputOptions);
+    }
 
     // Set the fit tolerance
     m_Minimizer->SetTolerance(m_Options->inputOptions().tolerance());
@@ -33,6 +126,128 @@ namespace ana {
     setup_minimizer();
   }
 
+  void Fit::create_likelihoods() {
+    const auto& parameters = m_Options->inputOptions().input_parameters().parameters();
+
+    m_DCLikelihood     = std::make_shared<dc::DCLikelihood>(m_Options, params::number_of_parameters());
+    m_ActiveLikelihood = m_DCLikelihood.get();
+
+    for (std::size_t i = 0; i < parameters.size(); ++i) {
+      m_StartValues[i] = parameters[i].value();
+      m_StepSizes[i]   = parameters[i].uncertainty();
+    }
+
+    auto experiments = describe_experiments(*m_Options);
+    if (experiments.size() == 1) {
+      return;
+    }
+
+    // Every further experiment starts at its nominal parameters, the shared ones start at the Double Chooz values
+    std::vector<std::vector<double>> nominal = {{}};
+    experiments.front().likelihood           = m_DCLikelihood;
+    for (auto& experiment : experiments | std::views::drop(1)) {
+      const auto setup      = juno::MediumBaselineSetup::juno_like();
+      experiment.likelihood = std::make_shared<juno::JUNOLikelihood>(m_Options, setup);
+      nominal.push_back(juno::nominal_parameters(setup));
+    }
+
+    m_Composite        = std::make_shared<CompositeLikelihood>(m_Options, std::move(experiments), shared_parameters);
+    m_ActiveLikelihood = m_Composite.get();
+
+    for (std::size_t e = 1; e < m_Composite->number_of_experiments(); ++e) {
+      const auto indices = m_Composite->global_indices(e);
+      for (std::size_t j = 0; j < indices.size(); ++j) {
+        if (static_cast<std::size_t>(indices[j]) < parameters.size()) {
+          continue;
+        }
+        // The nuisance parameters are given in units of their uncertainty
+        m_StartValues[indices[j]] = nominal[e][j];
+        m_StepSizes[indices[j]]   = (nominal[e][j] != 0.0) ? 0.01 * std::abs(nominal[e][j]) : 1.0;
+      }
+    }
+
+    if (!m_Options->inputOptions().silent()) {
+      std::cout << "Combining " << m_Composite->number_of_experiments() << " experiments with " << m_ParameterNames.size()
+                << " parameters\n";
+    }
+  }
+
+  void Fit::create_minimizer() {
+    const auto& backend = m_Options->inputOptions().minimizer();
+
+    const auto nParameter = static_cast<unsigned int>(m_ParameterNames.size());
+
+    if (backend == "Migrad") {
+      m_Minimizer = std::shared_ptr<ROOT::Math::Minimizer>(ROOT::Math::Factory::CreateMinimizer("Minuit2", "Migrad"));
+    } else if (backend == "Fumili") {
+      m_Minimizer = std::shared_ptr<ROOT::Math::Minimizer>(ROOT::Math::Factory::CreateMinimizer("Minuit2", "Fumili"));
+    } else if (backend == "LBFGS") {
+      m_Minimizer = std::make_shared<LBFGSMinimizer>();
+    } else {
+      throw std::invalid_argument("Unknown minimizer backend " + backend + ", use Migrad, Fumili or LBFGS");
+    }
+
+    if (backend == "Fumili" && m_Composite) {
+      throw std::invalid_argument("The Fumili backend is not supported for combined experiments");
+    }
+
+    if (backend == "Fumili") {
+      // Fumili needs the residuals of the likelihood instead of its value
+      m_PoissonFunction = std::make_shared<PoissonFitFunction>(m_DCLikelihood, nParameter);
+      m_PoissonFunction->set_observer([this](const double* parameter, const double value) { record_call(parameter, value); });
+      m_Function = m_PoissonFunction;
+    } else {
+      m_Function = std::make_shared<ROOT::Math::Functor>([this](const double* parameter) { return evaluate(parameter); },
+                                                         nParameter);
+    }
+
+    // Set the function to be minimized
+    m_Minimizer->SetFunction(*m_Function);
+  }
+
+  void Fit::create_gradient_likelihoods() {
+    auto& scheduler = m_Options->scheduler();
+    if (!scheduler.parallel() || m_Composite || !std::dynamic_pointer_cast<LBFGSMinimizer>(m_Minimizer)) {
+      return;
+    }
+
+    // The copies share the reactor events and the data of the likelihoods, only the spectra are their own
+    for (unsigned int t = 0; t < scheduler.concurrency(); ++t) {
+      m_GradientLikelihoods.push_back(std::make_shared<dc::DCLikelihood>(m_Options, *m_DCLikelihood));
+      if (m_CoarseLikelihood) {
+        m_CoarseGradientLikelihoods.push_back(std::make_shared<dc::DCLikelihood>(m_Options, *m_CoarseLikelihood));
+      }
+    }
+    m_GradientCalls.resize(m_GradientLikelihoods.size());
+
+    use_gradient_likelihoods(false);
+  }
+
+  void Fit::use_gradient_likelihoods(const bool coarse) {
+    auto minimizer = std::dynamic_pointer_cast<LBFGSMinimizer>(m_Minimizer);
+    if (!minimizer || m_GradientLikelihoods.empty()) {
+      return;
+    }
+
+    const auto nParameter = static_cast<unsigned int>(m_ParameterNames.size());
+
+    const auto& likelihoods = coarse ? m_CoarseGradientLikelihoods : m_GradientLikelihoods;
+
+    std::vector<std::shared_ptr<ROOT::Math::IMultiGenFunction>> functions;
+    for (std::size_t t = 0; t < likelihoods.size(); ++t) {
+      auto function = [this, likelihood = likelihoods[t], &calls = m_GradientCalls[t], nParameter](const double* parameter) {
+        const double value = likelihood->calculate_likelihood(parameter);
+        if (m_Checkpoint || m_DCLikelihood->trace()) {
+          calls.insert(calls.end(), parameter, parameter + nParameter);
+          calls.push_back(value);
+        }
+        return value;
+      };
+      functions.push_back(std::make_shared<ROOT::Math::Functor>(std::move(function), nParameter));
+    }
+    minimizer->SetGradientFunctions(m_Options->scheduler(), std::move(functions));
+  }
+
   void Fit::setup_minimizer() {
     using namespace params;
     using namespace params::dc;
@@ -41,18 +256,18 @@ namespace ana {
 
     const auto& input_parameters = m_Options->inputOptions().input_parameters();
 
-    const auto& names      = input_parameters.names();
+    const auto& names      = m_ParameterNames;
     const auto& fixed      = input_parameters.fixed();
     const auto& parameters = input_parameters.parameters();
 
-    for (std::size_t i = 0; i < parameters.size(); ++i) {
+    for (std::size_t i = 0; i < names.size(); ++i) {
       if (!silent) {
         std::cout << "Set up parameter " << std::setw(5) << i << ": " << std::setw(18) << names[i]
-                  << " with value " << std::setw(10) << parameters[i].value()
-                  << " and uncertainty " << parameters[i].uncertainty() << '\n';
+                  << " with value " << std::setw(10) << m_StartValues[i]
+                  << " and uncertainty " << m_StepSizes[i] << '\n';
       }
 
-      m_Minimizer->SetVariable(i, names[i], parameters[i].value(), parameters[i].uncertainty());
+      m_Minimizer->SetVariable(i, names[i], m_StartValues[i], m_StepSizes[i]);
     }
 
     const bool use_sterile = m_Options->inputOptions().double_chooz().use_sterile();
@@ -65,13 +280,437 @@ namespace ana {
       if (use_sterile && (i == DeltaM41 || i == SinSqT14))
         continue;
 
-      if (fixed[i]) {
+      // A tied parameter is overwritten by the correlation transform, so it is a flat direction of the likelihood
+      if (fixed[i] || dc::CorrelationTransform::tied(static_cast<int>(i))) {
         if (!silent) {
           std::cout << "Fixing parameter " << std::setw(5) << i << " " << names[i] << '\n';
         }
         m_Minimizer->FixVariable(i);
       }
     }
+    m_Configured = fixed_variables();
+
+    std::ranges::copy(m_StartValues, m_BestParameters.begin());
+
+    // Continue an interrupted fit from the state stored in the checkpoint
+    if (m_Checkpoint && !m_Checkpoint->fit_state().empty()) {
+      seed_minimizer(m_Checkpoint->fit_state());
+      m_NCalls = m_Checkpoint->fit_state().n_calls;
+      return;
+    }
+
+    // Otherwise start from the last best-fit point of the same configuration
+    if (m_WarmStartStore) {
+      if (const auto state = m_WarmStartStore->load(); state && !state->empty() && state->names == names) {
+        seed_minimizer(*state);
+      }
+    }
+  }
+
+  std::vector<bool> Fit::fixed_variables() const {
+    std::vector<bool> fixed(m_ParameterNames.size(), false);
+    for (std::size_t i = 0; i < fixed.size(); ++i) {
+      // The profiled parameters are fixed in the minimizer, but not in the fit
+      fixed[i] = m_Minimizer->IsFixedVariable(i) && !(i < m_Profiled.size() && m_Profiled[i]);
+    }
+    return fixed;
+  }
+
+  void Fit::seed_minimizer(const FitState& state) {
+    if (state.names != m_ParameterNames) {
+      throw std::runtime_error("The stored fit state does not match the configured parameters");
+    }
+
+    for (std::size_t i = 0; i < state.parameters.size(); ++i) {
+      if (m_Minimizer->IsFixedVariable(i)) {
+        continue;
+      }
+
+      m_Minimizer->SetVariableValue(i, state.parameters[i]);
+      m_BestParameters[i] = state.parameters[i];
+
+      // Use the uncertainty of the stored state as initial step size, if it is available
+      const double error = state.has_covariance() ? std::sqrt(state.covariance_at(i, i))
+                                                  : (state.errors.empty() ? 0.0 : state.errors[i]);
+      if (std::isfinite(error) && error > 0.0) {
+        m_Minimizer->SetVariableStepSize(i, error);
+      }
+    }
+
+    if (!m_Options->inputOptions().silent()) {
+      std::cout << "Seeded the minimizer from a stored fit state with likelihood " << state.min_value << '\n';
+    }
+  }
+
+  void Fit::setup_profiling() {
+    const auto& inputOptions = m_Options->inputOptions();
+
+    if (m_PoissonFunction) {
+      throw std::invalid_argument("Profiling the nuisance parameters is not supported by the Fumili backend");
+    }
+    if (inputOptions.double_chooz().reactor_split()) {
+      throw std::invalid_argument("Profiling the nuisance parameters is not supported for the reactor split");
+    }
+
+    const auto& names = inputOptions.input_parameters().names();
+
+    m_Profiled.assign(names.size(), false);
+
+    std::vector<int> indices;
+    for (std::size_t i = 0; i < names.size(); ++i) {
+      const int idx = static_cast<int>(i);
+      if (m_Minimizer->IsFixedVariable(i) || !dc::NuisanceProfiler::is_linear_nuisance(idx)) {
+        continue;
+      }
+      if (!(m_DCLikelihood->gaussian_prior(idx).first > 0.0)) {
+        continue;
+      }
+
+      m_Profiled[i] = true;
+      indices.push_back(idx);
+      m_Minimizer->FixVariable(i);
+    }
+
+    m_DCLikelihood->set_profiled_parameters(indices);
+    if (m_CoarseLikelihood) {
+      m_CoarseLikelihood->set_profiled_parameters(indices);
+    }
+    for (const auto& likelihood : m_GradientLikelihoods) {
+      likelihood->set_profiled_parameters(indices);
+    }
+    for (const auto& likelihood : m_CoarseGradientLikelihoods) {
+      likelihood->set_profiled_parameters(indices);
+    }
+
+    if (!inputOptions.silent()) {
+      std::cout << "Profiling " << indices.size() << " linear nuisance parameters analytically, "
+                << m_Minimizer->NFree() << " parameters remain free in the minimizer\n";
+    }
+  }
+
+  void Fit::store_result() {
+    const std::size_t N = m_Parameters.size();
+
+    std::copy_n(m_Minimizer->X(), N, m_Parameters.begin());
+    if (m_Minimizer->Errors() != nullptr) {
+      std::copy_n(m_Minimizer->Errors(), N, m_Errors.begin());
+    }
+
+    const auto* profiler = m_DCLikelihood->nuisance_profiler();
+    if (profiler == nullptr) {
+      return;
+    }
+
+    // Profile at the minimum to reconstruct the full nuisance vector
+    static_cast<void>(m_DCLikelihood->calculate_likelihood(m_Parameters.data()));
+
+    const auto  profiled = profiler->parameters();
+    const auto  errors   = profiler->conditional_errors();
+    const auto& indices  = profiler->indices();
+    for (std::size_t j = 0; j < indices.size(); ++j) {
+      m_Parameters[indices[j]] = profiled[indices[j]];
+      m_Errors[indices[j]]     = errors[j];
+    }
+  }
+
+  void Fit::update_free_parameters() {
+    // The Jacobian of the residuals is only calculated for the parameters which are free at this point
+    if (!m_PoissonFunction) {
+      return;
+    }
+
+    const auto& parameters = m_Options->inputOptions().input_parameters().parameters();
+
+    std::vector<bool>   free(parameters.size());
+    std::vector<double> steps(parameters.size());
+    for (std::size_t i = 0; i < parameters.size(); ++i) {
+      free[i]  = !m_Minimizer->IsFixedVariable(i);
+      steps[i] = parameters[i].uncertainty();
+    }
+    m_PoissonFunction->set_free_parameters(std::move(free), std::move(steps));
+  }
+
+  namespace {
+    /**
+     * @brief Returns the stage group of a shape parameter, or -1 if the parameter is not a shape parameter.
+     *
+     * The component strategy releases the lithium, accidental, fast neutron and reactor shapes one after
+     * another. The detector strategy releases the shared lithium shape first and then all shapes per detector.
+     */
+    int shape_group(const int idx, const std::string& strategy) {
+      using namespace params;
+      using namespace params::dc;
+
+      if (idx >= LiShape01 && idx <= LiShape38) {
+        return 0;
+      }
+
+      if (idx < number_of_general_parameters() || idx >= number_of_parameters()) {
+        return -1;
+      }
+
+      const int detector = (idx - number_of_general_parameters()) / number_of_DoubleChooz_detector_parameters();
+      const int local    = (idx - number_of_general_parameters()) % number_of_DoubleChooz_detector_parameters();
+
+      int component = -1;
+      if (local >= AccShape01 && local <= AccShape38) {
+        component = 1;
+      } else if (local >= FNSMShape01 && local <= FNSMShape44) {
+        component = 2;
+      } else if (local >= NuShape01 && local <= NuShape43) {
+        component = 3;
+      }
+
+      if (component < 0) {
+        return -1;
+      }
+
+      if (strategy == "component") {
+        return component;
+      }
+      if (strategy == "detector") {
+        return 1 + detector;
+      }
+      throw std::invalid_argument("Unknown fit stage strategy " + strategy + ", use none, component or detector");
+    }
+  }  // namespace
+
+  bool Fit::minimize_in_stages(const std::string& strategy) {
+    const bool silent = m_Options->inputOptions().silent();
+
+    // Collect the free shape parameters of every group
+    std::vector<std::vector<unsigned int>> groups(4);
+    for (unsigned int i = 0; i < m_Minimizer->NDim(); ++i) {
+      if (m_Minimizer->IsFixedVariable(i)) {
+        continue;
+      }
+      if (const int group = shape_group(static_cast<int>(i), strategy); group >= 0) {
+        groups[group].push_back(i);
+      }
+    }
+    std::erase_if(groups, [](const auto& group) { return group.empty(); });
+
+    for (const auto& group : groups) {
+      for (const auto i : group) {
+        m_Minimizer->FixVariable(i);
+      }
+    }
+
+    const unsigned int N = m_Minimizer->NDim();
+
+    std::vector<double> covariance;  // The covariance matrix of the previous stage, empty if not available
+    std::vector<bool>   was_free(N);
+
+    bool converged = false;
+    for (std::size_t stage = 0; stage <= groups.size(); ++stage) {
+      if (stage > 0) {
+        for (const auto i : groups[stage - 1]) {
+          m_Minimizer->ReleaseVariable(i);
+        }
+
+        if (!covariance.empty() && !seed_covariance(covariance, was_free) && !silent) {
+          std::cout << "The minimizer does not accept a seed covariance matrix, stage " << stage << " starts from the step sizes\n";
+        }
+      }
+
+      update_free_parameters();
+
+      converged = m_Minimizer->Minimize();
+
+      if (!silent) {
+        std::cout << "Stage " << stage << " of " << groups.size() << " with " << m_Minimizer->NFree()
+                  << " free parameters finished: " << std::boolalpha << converged << ", likelihood "
+                  << m_Minimizer->MinValue() << " after " << m_Minimizer->NCalls() << " calls\n";
+      }
+
+      if (stage == groups.size()) {
+        break;
+      }
+
+      // Seed the next stage with the result of this one
+      covariance.assign(static_cast<std::size_t>(N) * N, 0.0);
+      if (!(m_Minimizer->ProvidesError() && m_Minimizer->GetCovMatrix(covariance.data()))) {
+        covariance.clear();
+      }
+      for (unsigned int i = 0; i < N; ++i) {
+        was_free[i] = !m_Minimizer->IsFixedVariable(i);
+      }
+      seed_from_minimum();
+    }
+
+    return converged;
+  }
+
+  bool Fit::seed_covariance(std::span<const double> covariance, const std::vector<bool>& was_free) {
+    const unsigned int N = m_Minimizer->NDim();
+
+    // The matrix covers the free parameters only, in the order of their indices
+    std::vector<unsigned int> free;
+    for (unsigned int i = 0; i < N; ++i) {
+      if (!m_Minimizer->IsFixedVariable(i)) {
+        free.push_back(i);
+      }
+    }
+
+    // Minuit2 takes the packed triangle of the symmetric matrix, element (a, b) with a <= b at a + b * (b + 1) / 2
+    const std::size_t   n = free.size();
+    std::vector<double> seed;
+    seed.reserve(n * (n + 1) / 2);
+    for (std::size_t b = 0; b < n; ++b) {
+      for (std::size_t a = 0; a <= b; ++a) {
+        const unsigned int i = free[a];
+        const unsigned int j = free[b];
+        if (was_free[i] && was_free[j]) {
+          seed.push_back(covariance[static_cast<std::size_t>(i) * N + j]);
+        } else {
+          seed.push_back((a == b) ? m_StepSizes[i] * m_StepSizes[i] : 0.0);
+        }
+      }
+    }
+
+    return m_Minimizer->SetCovariance(seed, static_cast<unsigned int>(n));
+  }
+
+  void Fit::seed_from_minimum() {
+    const double* X      = m_Minimizer->X();
+    const double* errors = m_Minimizer->Errors();
+    for (unsigned int i = 0; i < m_Minimizer->NDim(); ++i) {
+      if (m_Minimizer->IsFixedVariable(i)) {
+        continue;
+      }
+      m_Minimizer->SetVariableValue(i, X[i]);
+      if (errors != nullptr && std::isfinite(errors[i]) && errors[i] > 0.0) {
+        m_Minimizer->SetVariableStepSize(i, errors[i]);
+      }
+    }
+  }
+
+  bool Fit::minimize_coarse() {
+    PHYLINO_TIMELINE_SCOPE("CoarseFit", "fit");
+
+    const auto& inputOptions = m_Options->inputOptions();
+
+    // The coarse minimum only has to be close enough for the full level to converge in a few iterations
+    constexpr double coarse_tolerance_factor = 10.0;
+
+    m_ActiveLikelihood = m_CoarseLikelihood.get();
+    use_gradient_likelihoods(true);
+    m_Minimizer->SetTolerance(coarse_tolerance_factor * inputOptions.tolerance());
+
+    bool converged = false;
+    if (inputOptions.fit_stages() == "none") {
+      update_free_parameters();
+      converged = m_Minimizer->Minimize();
+    } else {
+      converged = minimize_in_stages(inputOptions.fit_stages());
+    }
+
+    if (!inputOptions.silent()) {
+      std::cout << "Coarse level with " << inputOptions.coarse_bins() << " L/E bins per energy bin finished: "
+                << std::boolalpha << converged << ", likelihood " << m_Minimizer->MinValue() << " after "
+                << m_Minimizer->NCalls() << " calls\n";
+    }
+
+    seed_from_minimum();
+    merge_gradient_calls();
+
+    m_Minimizer->SetTolerance(inputOptions.tolerance());
+    m_ActiveLikelihood = m_DCLikelihood.get();
+    use_gradient_likelihoods(false);
+
+    // The likelihood values of the coarse level are not comparable to the full ones
+    m_BestValue = std::numeric_limits<double>::max();
+
+    return converged;
+  }
+
+  void Fit::merge_gradient_calls() {
+    const std::size_t nParameter = m_BestParameters.size();
+
+    // Only the full likelihood is traced, like in calculate_likelihood()
+    const auto& trace  = m_DCLikelihood->trace();
+    const bool  traced = trace && m_ActiveLikelihood == m_DCLikelihood.get();
+
+    for (auto& calls : m_GradientCalls) {
+      for (std::size_t offset = 0; offset < calls.size(); offset += nParameter + 1) {
+        const double* parameter = calls.data() + offset;
+        const double  value     = parameter[nParameter];
+
+        if (traced) {
+          trace->record(parameter, value);
+        }
+        record_call(parameter, value);
+      }
+      calls.clear();
+    }
+  }
+
+  double Fit::evaluate(const double* parameter) {
+    // The gradient calls since the last call come first, so the trace keeps the order of the calls
+    merge_gradient_calls();
+
+    const double value = m_ActiveLikelihood->calculate_likelihood(parameter);
+    record_call(parameter, value);
+
+    return value;
+  }
+
+  void Fit::record_call(const double* parameter, const double value) {
+    ++m_NCalls;
+
+    if (m_Checkpoint) {
+      if (value < m_BestValue) {
+        m_BestValue = value;
+        std::copy_n(parameter, m_BestParameters.size(), m_BestParameters.begin());
+      }
+
+      if (m_Checkpoint->due()) {
+        write_checkpoint();
+      }
+    }
+  }
+
+  FitState Fit::current_state() const {
+    FitState state;
+
+    state.names    = m_ParameterNames;
+    state.n_calls  = m_NCalls;
+    state.finished = m_FitPerformed;
+
+    if (m_FitPerformed) {
+      const std::size_t N = m_Minimizer->NDim();
+
+      state.parameters = m_Parameters;
+      state.min_value  = m_Minimizer->MinValue();
+      state.errors     = m_Errors;
+
+      state.covariance.assign(N * N, 0.0);
+      if (!(m_Minimizer->ProvidesError() && m_Minimizer->GetCovMatrix(state.covariance.data()))) {
+        state.covariance.clear();
+      }
+    } else if (m_BestValue < std::numeric_limits<double>::max()) {
+      // During the minimization only the best point visited so far is known
+      state.parameters = m_BestParameters;
+      state.min_value  = m_BestValue;
+    }
+
+    return state;
+  }
+
+  void Fit::write_checkpoint() {
+    if (!m_Checkpoint) {
+      return;
+    }
+
+    FitState state = current_state();
+    if (state.empty()) {
+      // Keep the state of a resumed fit until this fit visited a point
+      state.parameters = m_Checkpoint->fit_state().parameters;
+      state.min_value  = m_Checkpoint->fit_state().min_value;
+    }
+
+    m_Checkpoint->fit_state() = std::move(state);
+    m_Checkpoint->save();
   }
 
   std::shared_ptr<dc::DCLikelihood> Fit::doublechooz_likelihood() const {
@@ -81,24 +720,101 @@ namespace ana {
   bool Fit::minimize() {
     using namespace std::chrono;
 
-    m_Minimizer->SetPrintLevel(m_Options->inputOptions().silent() ? 0 : 2);
+    const auto& inputOptions = m_Options->inputOptions();
+
+    m_Minimizer->SetPrintLevel(inputOptions.silent() ? 0 : 2);
+
+    if (inputOptions.profile_nuisances() && m_Profiled.empty()) {
+      setup_profiling();
+    }
+
+    // Record the likelihood calls for an offline replay, including the profiled parameters to reproduce the values
+    if (!inputOptions.trace_file().empty()) {
+      const auto* profiler = m_DCLikelihood->nuisance_profiler();
+      m_DCLikelihood->set_trace(std::make_shared<LikelihoodTraceWriter>(inputOptions.trace_file(),
+                                                                        inputOptions.input_parameters().names(),
+                                                                        profiler ? profiler->indices() : std::vector<int>{}));
+    }
+
+    // The counters are opened per thread on their first reading, enabling them checks if they are available
+    if (inputOptions.hardware_counters() && !utilities::hardware_counters_enabled()) {
+      utilities::enable_hardware_counters(true);
+    }
+
+    // Minuit2 reports its iterations to a trace object, the LBFGS backend records them itself
+    if (utilities::timeline_enabled()) {
+      if (auto* minuit = dynamic_cast<ROOT::Minuit2::Minuit2Minimizer*>(m_Minimizer.get()); minuit && !m_IterationTrace) {
+        m_IterationTrace = std::make_unique<TimelineIterationTrace>();
+        minuit->SetTraceObject(*m_IterationTrace);
+      }
+    }
+
+    PHYLINO_TIMELINE_SCOPE("Fit", "fit");
+
+    // The likelihood runs tasks on the workers of the scheduler, their counts are added to the ones of this thread
+    const utilities::ThreadCounters counters(m_Options->scheduler().thread_ids());
+    const auto                      begin = high_resolution_clock::now();
+
+    if (m_CoarseLikelihood) {
+      // The stages are run on the coarse level, the full level only refines its minimum with all parameters free
+      static_cast<void>(minimize_coarse());
 
-    const auto begin = high_resolution_clock::now();
-    m_Converged      = m_Minimizer->Minimize();
-    const auto end   = high_resolution_clock::now();
+      PHYLINO_TIMELINE_SCOPE("FineFit", "fit");
+      update_free_parameters();
+      m_Converged = m_Minimizer->Minimize();
+    } else if (inputOptions.fit_stages() == "none") {
+      update_free_parameters();
+      m_Converged = m_Minimizer->Minimize();
+    } else {
+      m_Converged = minimize_in_stages(inputOptions.fit_stages());
+    }
+
+    // Calculate the error matrix if the backend does not provide one or if it is requested explicitly
+    if (m_Converged && (inputOptions.hesse() || !m_Minimizer->ProvidesError())) {
+      PHYLINO_TIMELINE_SCOPE("Hesse", "fit");
+      if (!m_Minimizer->Hesse()) {
+        std::cout << "Hesse failed, the error matrix is not available\n";
+      }
+    }
+    const auto end = high_resolution_clock::now();
 
-    m_FitDuration = end - begin;
+    m_FitDuration    = end - begin;
+    m_HardwareCounts = counters.read();
 
     std::stringstream ss;
     ss << "Fit finished: " << std::boolalpha << m_Converged << '\n';
     ss << "It took: " << m_FitDuration.count() << " seconds\n";
     ss << "Likelihood: " << m_Minimizer->MinValue() << '\n';
     ss << "EDM: " << m_Minimizer->Edm() << '\n';
+    if (m_Composite) {
+      for (std::size_t e = 0; e < m_Composite->number_of_experiments(); ++e) {
+        ss << m_Composite->experiment(e).name << " likelihood: " << m_Composite->value(e) << " after "
+           << m_Composite->evaluations(e) << " evaluations\n";
+      }
+    }
+    if (const auto& oscillator = m_DCLikelihood->reactor_spectrum().oscillator(); oscillator->precision() == dc::Oscillator::Precision::Validate) {
+      ss << "Maximal relative deviation of the float oscillation: " << oscillator->max_relative_deviation() << '\n';
+    }
+    if (utilities::hardware_counters_enabled()) {
+      ss << "Cycles: " << m_HardwareCounts.cycles << ", instructions: " << m_HardwareCounts.instructions
+         << ", LLC misses: " << m_HardwareCounts.cache_misses << ", branch misses: " << m_HardwareCounts.branch_misses << '\n';
+    }
 
     std::cout << ss.rdbuf() << std::endl;
 
     m_FitPerformed = true;
 
+    merge_gradient_calls();
+    store_result();
+
+    write_checkpoint();
+
+    // Only converged fits are good seeds for later fits. The store key does not contain the fixed parameters, so a
+    // fit which fixed further ones after the setup, e.g. a scan point, is not stored for the configuration.
+    if (m_WarmStartStore && m_Converged && fixed_variables() == m_Configured) {
+      m_WarmStartStore->store(current_state());
+    }
+
     return m_Converged;
   }
 
@@ -1,58 +1,274 @@
 #pragma once
 
+#include "Checkpoint.h"
+#include "CompositeLikelihood.h"
+#include "HardwareCounters.h"
+#include "LBFGSMinimizer.h"
 #include "Likelihood.h"
 #include "Options.h"
+#include "PoissonFitFunction.h"
+#include "WarmStartStore.h"
 
 // STL includes
 #include <chrono>
 #include <memory>
+#include <span>
 #include <vector>
 
 // ROOT includes
 #include <Math/Factory.h>
 #include <Math/Functor.h>
 #include <Math/Minimizer.h>
+#include <Minuit2/MnTraceObject.h>
 
 #include "DoubleChooz/DCLikelihood.h"
+#include "JUNO/JUNOLikelihood.h"
 
 namespace ana {
   // TODO: Implementation & Documentation missing
 
   class Fit {
    public:
-    explicit Fit(std::shared_ptr<io::Options> options);
+    /**
+     * @brief Constructs the fit and sets up the minimizer.
+     *
+     * @param options The options of the fit.
+     * @param checkpoint The checkpoint of the surrounding campaign. If it is a nullptr, a checkpoint is created
+     *                   from the options if a checkpoint file is configured.
+     */
+    explicit Fit(std::shared_ptr<io::Options> options, std::shared_ptr<Checkpoint> checkpoint = nullptr);
 
     ~Fit() = default;
 
     [[nodiscard]] std::shared_ptr<dc::DCLikelihood> doublechooz_likelihood() const;
 
+    /**
+     * @brief Returns the combined likelihood of all experiments, or a nullptr if only Double Chooz is fitted.
+     */
+    [[nodiscard]] const std::shared_ptr<CompositeLikelihood>& composite_likelihood() const noexcept { return m_Composite; }
+
+    /**
+     * @brief Returns the names of the fit parameters for the experiments selected in the options.
+     *
+     * The Double Chooz parameters come first, in the order of the config file. They are followed by the
+     * parameters of the further experiments which are not shared with Double Chooz, e.g. JUNO/FluxNorm.
+     *
+     * @throws std::invalid_argument if an experiment is unknown.
+     */
+    [[nodiscard]] static std::vector<std::string> parameter_names(const io::Options& options);
+
+    [[nodiscard]] const std::vector<std::string>& parameter_names() const noexcept { return m_ParameterNames; }
+
     bool minimize();
 
     [[nodiscard]] double time_duration() const;
 
+    /**
+     * @brief Returns the hardware performance counts of the last minimization, zero if the counters are disabled.
+     *
+     * The counts of the calling thread and of all scheduler workers are summed, including the tasks of other fits
+     * which run on the workers at the same time.
+     */
+    [[nodiscard]] const utilities::HardwareCounts& hardware_counts() const noexcept { return m_HardwareCounts; }
+
     [[nodiscard]] bool converged() const;
 
     [[nodiscard]] const std::shared_ptr<io::Options>& options() const;
 
     auto get_minimizer() const { return m_Minimizer; }
 
-    bool use_double_chooz() const { return true; }  // TODO This should be initialized in the Constructor
+    /**
+     * @brief Returns the best-fit values of all parameters, including the analytically profiled ones.
+     */
+    [[nodiscard]] std::span<const double> parameters() const noexcept { return m_Parameters; }
+
+    /**
+     * @brief Returns the errors of all parameters. The errors of profiled parameters are conditional on the others.
+     */
+    [[nodiscard]] std::span<const double> errors() const noexcept { return m_Errors; }
+
+    /**
+     * @brief Checks if the parameter with the given index is profiled analytically instead of by the minimizer.
+     */
+    [[nodiscard]] bool profiled(std::size_t i) const noexcept { return i < m_Profiled.size() && m_Profiled[i]; }
+
+    bool use_double_chooz() const { return true; }  // Double Chooz is part of every fit, further experiments are combined with it
+
+    [[nodiscard]] const std::shared_ptr<Checkpoint>& checkpoint() const noexcept { return m_Checkpoint; }
+
+    /**
+     * @brief Writes the current state of the fit to the checkpoint, if checkpointing is enabled.
+     */
+    void write_checkpoint();
+
+    /**
+     * @brief Returns the current state of the fit, i.e. the result after the minimization or the best point so far.
+     */
+    [[nodiscard]] FitState current_state() const;
 
    private:
     std::shared_ptr<io::Options> m_Options;
 
+    std::vector<std::string> m_ParameterNames;  // Names of all fit parameters
+    std::vector<double>      m_StartValues;     // Start values of all fit parameters
+    std::vector<double>      m_StepSizes;       // Initial step sizes of all fit parameters
+
     std::chrono::duration<double, std::ratio<1>> m_FitDuration;
 
+    utilities::HardwareCounts m_HardwareCounts;  // Hardware performance counts of the last minimization
+
     bool m_Converged;
     bool m_FitPerformed;
 
+    std::unique_ptr<ROOT::Minuit2::MnTraceObject> m_IterationTrace;  // Records the Minuit2 iterations in the timeline
+
     std::shared_ptr<ROOT::Math::Minimizer> m_Minimizer;
 
-    std::shared_ptr<ROOT::Math::Functor> m_Functor;
+    std::shared_ptr<ROOT::Math::IMultiGenFunction> m_Function;  // The function handed to the minimizer
+
+    std::shared_ptr<PoissonFitFunction> m_PoissonFunction;  // The residual representation, only used by Fumili
 
     std::shared_ptr<dc::DCLikelihood> m_DCLikelihood;
 
+    std::shared_ptr<dc::DCLikelihood> m_CoarseLikelihood;  // The likelihood on the reduced reactor MC, if enabled
+
+    std::shared_ptr<CompositeLikelihood> m_Composite;  // The combination with further experiments, if enabled
+
+    dc::Likelihood* m_ActiveLikelihood;  // The likelihood currently minimized, i.e. the coarse, the full or the combined one
+
+    std::vector<std::shared_ptr<dc::DCLikelihood>> m_GradientLikelihoods;        // Copies of the likelihood evaluating the LBFGS gradient in parallel
+    std::vector<std::shared_ptr<dc::DCLikelihood>> m_CoarseGradientLikelihoods;  // Copies of the coarse likelihood for the gradient of the coarse level
+    std::vector<std::vector<double>>               m_GradientCalls;              // Parameters and value of every gradient call since the last merge, per copy
+
+    std::shared_ptr<Checkpoint> m_Checkpoint;
+
+    std::shared_ptr<WarmStartStore> m_WarmStartStore;
+
+    std::uint64_t       m_NCalls;          // Number of likelihood calls, including the ones of a resumed fit
+    double              m_BestValue;       // Smallest likelihood value seen so far
+    std::vector<double> m_BestParameters;  // Parameters of the smallest likelihood value seen so far
+
+    std::vector<bool>   m_Profiled;    // Flags for the analytically profiled parameters
+    std::vector<bool>   m_Configured;  // Flags for the parameters fixed by the configuration, see fixed_variables()
+    std::vector<double> m_Parameters;  // Best-fit values of all parameters
+    std::vector<double> m_Errors;      // Errors of all parameters
+
+    /**
+     * @brief Creates the likelihoods of all experiments selected in the options and their combination.
+     *
+     * @throws std::invalid_argument if an experiment is unknown.
+     */
+    void create_likelihoods();
+
+    /**
+     * @brief Creates the minimizer backend selected in the options and the matching function to be minimized.
+     *
+     * @throws std::invalid_argument if the backend is unknown.
+     */
+    void create_minimizer();
+
     void setup_minimizer();
+
+    /**
+     * @brief Creates a copy of the likelihood per scheduler thread, which evaluate the gradient of the LBFGS backend.
+     *
+     * The copies share the reactor events of the likelihoods, see DCLikelihood. They are only created for the LBFGS
+     * backend with more than one thread, they are not supported for combined experiments.
+     */
+    void create_gradient_likelihoods();
+
+    /**
+     * @brief Hands the gradient likelihoods of the full or of the coarse level to the LBFGS backend.
+     */
+    void use_gradient_likelihoods(bool coarse);
+
+    /**
+     * @brief Adds the calls of the gradient likelihoods to the call count, the best point and the trace.
+     *
+     * The gradient calls are only recorded with a checkpoint or a trace. They are merged on the calling thread
+     * after the gradient, in the order of the copies, as the trace is not thread-safe.
+     */
+    void merge_gradient_calls();
+
+    /**
+     * @brief Hides the free linear nuisance parameters with Gaussian prior from the minimizer and profiles them.
+     *
+     * @throws std::invalid_argument if the profiling is not supported in the configuration.
+     */
+    void setup_profiling();
+
+    /**
+     * @brief Stores the best-fit values and errors, reconstructing the profiled parameters at the minimum.
+     */
+    void store_result();
+
+    /**
+     * @brief Hands the currently free parameters to the function of the Fumili backend.
+     */
+    void update_free_parameters();
+
+    /**
+     * @brief Returns the flags of the parameters fixed in the minimizer, except for the analytically profiled ones.
+     */
+    [[nodiscard]] std::vector<bool> fixed_variables() const;
+
+    /**
+     * @brief Minimizes with the shape parameters fixed first and releases them group-wise in further stages.
+     *
+     * Each stage starts from the parameters of the previous one, with step sizes from its errors. Releasing a
+     * parameter invalidates the covariance matrix of Minuit2, so the covariance matrix of the previous stage is set
+     * explicitly as seed of the next one, see seed_covariance().
+     *
+     * @param strategy The grouping of the shape parameters, i.e. component or detector.
+     * @return Whether the last stage, with all parameters released, converged.
+     * @throws std::invalid_argument if the strategy is unknown.
+     */
+    bool minimize_in_stages(const std::string& strategy);
+
+    /**
+     * @brief Sets the seed covariance matrix of the free parameters from the one of the previous stage.
+     *
+     * The block of the parameters which were free in the previous stage is copied, the released parameters are
+     * uncorrelated with their squared step size as variance.
+     *
+     * @param covariance The row-major covariance matrix of all parameters of the previous stage.
+     * @param was_free Whether a parameter was free in the previous stage.
+     * @return Whether the backend accepted the covariance matrix.
+     */
+    bool seed_covariance(std::span<const double> covariance, const std::vector<bool>& was_free);
+
+    /**
+     * @brief Minimizes the likelihood on the reduced reactor MC with a looser tolerance.
+     *
+     * Afterward, the minimizer is seeded with its result and the full likelihood is active again.
+     *
+     * @return Whether the coarse level converged.
+     */
+    bool minimize_coarse();
+
+    /**
+     * @brief Sets the start values and step sizes of the free parameters from the result of the last minimization.
+     */
+    void seed_from_minimum();
+
+    /**
+     * @brief Sets the start values and step sizes of the free parameters from a stored fit state.
+     *
+     * @param state The stored fit state. Its parameter names have to match the configured ones.
+     */
+    void seed_minimizer(const FitState& state);
+
+    /**
+     * @brief Evaluates the likelihood for the minimizer and keeps track of the best point for checkpointing.
+     */
+    double evaluate(const double* parameter);
+
+    /**
+     * @brief Counts a likelihood call and keeps track of the best point, used for all calls which bypass evaluate().
+     *
+     * The Fumili backend reports the sum of its squared residuals instead, which orders the points like the likelihood.
+     */
+    void record_call(const double* parameter, double value);
   };
 
 }  // namespace ana
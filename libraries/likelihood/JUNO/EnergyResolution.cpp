@@ -0,0 +1,76 @@
+#include "EnergyResolution.h"
+
+// includes
+#include "../../utilities/Timeline.h"
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+
+namespace ana::juno {
+
+  EnergyResolution::EnergyResolution(const MediumBaselineSetup& setup, std::shared_ptr<FineOscillator> oscillator)
+    : m_Oscillator(std::move(oscillator)) {
+    const double width = setup.bin_width();
+
+    const auto true_energies = m_Oscillator->true_energies();
+
+    m_First.reserve(true_energies.size());
+    m_Offset.reserve(true_energies.size() + 1);
+    m_Offset.push_back(0);
+
+    for (const double energy : true_energies) {
+      const double sigma = energy * std::sqrt(std::pow(setup.resolution_a, 2) / energy + std::pow(setup.resolution_b, 2) + std::pow(setup.resolution_c / energy, 2));
+
+      const int first = std::clamp(static_cast<int>(std::floor((energy - 6.0 * sigma - setup.energy_min) / width)), 0, setup.n_bins);
+      const int last  = std::clamp(static_cast<int>(std::ceil((energy + 6.0 * sigma - setup.energy_min) / width)), first, setup.n_bins);
+
+      // The Gaussian integrated over every reconstructed bin of the band
+      for (int i = first; i < last; ++i) {
+        const double lower = setup.energy_min + i * width;
+        const double upper = lower + width;
+        m_Weights.push_back(0.5 * (std::erf((upper - energy) / (std::sqrt(2.0) * sigma)) - std::erf((lower - energy) / (std::sqrt(2.0) * sigma))));
+      }
+
+      m_First.push_back(first);
+      m_Offset.push_back(static_cast<int>(m_Weights.size()));
+    }
+
+    m_Spectrum.assign(setup.n_bins, 0.0);
+  }
+
+  bool EnergyResolution::check_and_recalculate(const dc::ParameterWrapper& parameter) noexcept {
+    const bool recalculate = m_Oscillator->check_and_recalculate(parameter);
+
+    // Started after the previous step, which has its own counters
+    PHYLINO_PROFILE_SCOPE(timer, m_Profile.total());
+
+    if (recalculate) {
+      fold_spectrum();
+    }
+
+    PHYLINO_PROFILE_RECOMPUTED(timer, recalculate);
+
+    return recalculate;
+  }
+
+  void EnergyResolution::fold_spectrum() noexcept {
+    PHYLINO_TIMELINE_SCOPE("JUNO/EnergyResolution", "component");
+
+    const auto true_spectrum = m_Oscillator->get_spectrum();
+
+    std::ranges::fill(m_Spectrum, 0.0);
+
+    for (std::size_t j = 0; j < true_spectrum.size(); ++j) {
+      const double  content = true_spectrum[j];
+      const double* weights = m_Weights.data() + m_Offset[j];
+      double*       target  = m_Spectrum.data() + m_First[j];
+
+      #pragma omp simd
+      for (int k = 0; k < m_Offset[j + 1] - m_Offset[j]; ++k) {
+        target[k] += content * weights[k];
+      }
+    }
+  }
+
+}  // namespace ana::juno
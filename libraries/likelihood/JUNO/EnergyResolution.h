@@ -0,0 +1,47 @@
+#pragma once
+
+// includes
+#include "FineOscillator.h"
+
+// STL includes
+#include <memory>
+
+namespace ana::juno {
+
+  /**
+   * @class EnergyResolution
+   * @brief Folds the oscillated true spectrum with the energy resolution of the detector.
+   *
+   * The response of a true energy bin is a Gaussian integrated over the reconstructed bins. It is cut at six
+   * standard deviations, so the response matrix is banded and only the band is stored. The folding costs the
+   * number of true bins times the band width instead of the full matrix product.
+   */
+  class EnergyResolution {
+   public:
+    EnergyResolution(const MediumBaselineSetup& setup, std::shared_ptr<FineOscillator> oscillator);
+
+    /**
+     * @brief Recalculates the oscillation if necessary and folds the spectrum if it changed.
+     */
+    bool check_and_recalculate(const dc::ParameterWrapper& parameter) noexcept;
+
+    [[nodiscard]] std::span<const double> get_spectrum() const noexcept { return m_Spectrum; }
+
+    [[nodiscard]] const std::shared_ptr<FineOscillator>& oscillator() const noexcept { return m_Oscillator; }
+
+    [[nodiscard]] utilities::ComponentProfile& profile() noexcept { return m_Profile; }
+
+   private:
+    std::shared_ptr<FineOscillator> m_Oscillator;
+
+    std::vector<int>    m_First;     ///< The first reconstructed bin of the band of every true bin.
+    std::vector<int>    m_Offset;    ///< The offset of the band of every true bin in m_Weights, one more entry than true bins.
+    std::vector<double> m_Weights;   ///< The bands of the response matrix, true bin after true bin.
+    std::vector<double> m_Spectrum;  ///< The folded spectrum per reconstructed bin.
+
+    utilities::ComponentProfile m_Profile{"JUNO/EnergyResolution"};  ///< The timing counters.
+
+    void fold_spectrum() noexcept;
+  };
+
+}  // namespace ana::juno
@@ -0,0 +1,65 @@
+#include "EnergyScaleCorrection.h"
+
+// includes
+#include "../../utilities/Timeline.h"
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace ana::juno {
+
+  EnergyScaleCorrection::EnergyScaleCorrection(const MediumBaselineSetup& setup, std::shared_ptr<ShapeUncertainty> shape)
+    : m_Shape(std::move(shape))
+    , m_EnergyMin(setup.energy_min)
+    , m_BinWidth(setup.bin_width())
+    , m_Uncertainty(setup.energy_scale_uncertainty)
+    , m_Cumulative(setup.n_bins + 1, 0.0)
+    , m_Spectrum(setup.n_bins, 0.0) {}
+
+  bool EnergyScaleCorrection::check_and_recalculate(const dc::ParameterWrapper& parameter) noexcept {
+    const bool previous_step = m_Shape->check_and_recalculate(parameter);
+
+    // Started after the previous step, which has its own counters
+    PHYLINO_PROFILE_SCOPE(timer, m_Profile.total());
+
+    const bool this_step   = parameter.check_parameter_changed(EnergyScale);
+    const bool recalculate = previous_step | this_step;
+
+    if (recalculate) {
+      apply_scale(parameter);
+    }
+
+    PHYLINO_PROFILE_RECOMPUTED(timer, recalculate);
+
+    return recalculate;
+  }
+
+  void EnergyScaleCorrection::apply_scale(const dc::ParameterWrapper& parameter) noexcept {
+    PHYLINO_TIMELINE_SCOPE("JUNO/EnergyScaleCorrection", "component");
+
+    const auto spectrum = m_Shape->get_spectrum();
+    const auto n_bins   = static_cast<int>(spectrum.size());
+
+    m_Cumulative[0] = 0.0;
+    std::partial_sum(spectrum.begin(), spectrum.end(), m_Cumulative.begin() + 1);
+
+    const double scale = 1.0 + m_Uncertainty * parameter[EnergyScale];
+
+    // The cumulative spectrum at an energy, linear within the bins and constant outside the analysis range
+    auto cumulative = [this, n_bins](double energy) noexcept {
+      const double x = std::clamp((energy - m_EnergyMin) / m_BinWidth, 0.0, static_cast<double>(n_bins));
+      const int    i = std::min(static_cast<int>(x), n_bins - 1);
+      return m_Cumulative[i] + (x - i) * (m_Cumulative[i + 1] - m_Cumulative[i]);
+    };
+
+    double lower = cumulative(m_EnergyMin / scale);
+    for (int i = 0; i < n_bins; ++i) {
+      const double upper = cumulative((m_EnergyMin + (i + 1) * m_BinWidth) / scale);
+      m_Spectrum[i]      = upper - lower;
+      lower              = upper;
+    }
+  }
+
+}  // namespace ana::juno
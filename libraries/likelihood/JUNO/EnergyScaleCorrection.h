@@ -0,0 +1,46 @@
+#pragma once
+
+// includes
+#include "ShapeUncertainty.h"
+
+namespace ana::juno {
+
+  /**
+   * @class EnergyScaleCorrection
+   * @brief Applies the uncertainty of the linear energy scale to the reconstructed spectrum.
+   *
+   * A reconstructed energy E is measured as (1 + alpha) E. The content of a bin is the integral of the spectrum
+   * between its edges divided by (1 + alpha), taken from the piecewise linear cumulative spectrum, so a shift
+   * costs a pass over the bins.
+   */
+  class EnergyScaleCorrection {
+   public:
+    EnergyScaleCorrection(const MediumBaselineSetup& setup, std::shared_ptr<ShapeUncertainty> shape);
+
+    /**
+     * @brief Recalculates the previous steps if necessary and applies the energy scale if anything changed.
+     */
+    bool check_and_recalculate(const dc::ParameterWrapper& parameter) noexcept;
+
+    [[nodiscard]] std::span<const double> get_spectrum() const noexcept { return m_Spectrum; }
+
+    [[nodiscard]] const std::shared_ptr<ShapeUncertainty>& shape() const noexcept { return m_Shape; }
+
+    [[nodiscard]] utilities::ComponentProfile& profile() noexcept { return m_Profile; }
+
+   private:
+    std::shared_ptr<ShapeUncertainty> m_Shape;
+
+    double m_EnergyMin;    ///< The lower edge of the analysis range in MeV.
+    double m_BinWidth;     ///< The width of the reconstructed bins in MeV.
+    double m_Uncertainty;  ///< The relative uncertainty of the energy scale.
+
+    std::vector<double> m_Cumulative;  ///< Scratch memory for the cumulative spectrum at the bin edges.
+    std::vector<double> m_Spectrum;    ///< The spectrum with the energy scale applied.
+
+    utilities::ComponentProfile m_Profile{"JUNO/EnergyScaleCorrection"};  ///< The timing counters.
+
+    void apply_scale(const dc::ParameterWrapper& parameter) noexcept;
+  };
+
+}  // namespace ana::juno
@@ -0,0 +1,125 @@
+#include "FineOscillator.h"
+
+// includes
+#include "../../utilities/Timeline.h"
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace ana::juno {
+
+  namespace {
+    constexpr double neutron_proton_mass_difference = 1.293;  // MeV
+    constexpr double electron_mass                  = 0.511;  // MeV
+    constexpr double prompt_energy_offset           = 0.782;  // Neutrino energy minus prompt energy in MeV
+
+    /**
+     * @brief The product of a typical reactor flux and the inverse beta decay cross section, up to a constant.
+     */
+    double flux_times_cross_section(double neutrino_energy) noexcept {
+      const double positron_energy = neutrino_energy - neutron_proton_mass_difference;
+      if (positron_energy <= electron_mass) {
+        return 0.0;
+      }
+      const double flux          = std::exp(0.870 - 0.160 * neutrino_energy - 0.0910 * neutrino_energy * neutrino_energy);
+      const double cross_section = positron_energy * std::sqrt(positron_energy * positron_energy - electron_mass * electron_mass);
+      return flux * cross_section;
+    }
+
+    #pragma omp declare simd
+    inline double pow_2(const double x) noexcept {
+      return x * x;
+    }
+  }  // namespace
+
+  FineOscillator::FineOscillator(const MediumBaselineSetup& setup)
+    : m_NCores(setup.cores.size())
+    , m_TrueBinWidth(setup.bin_width() / setup.oversampling) {
+    setup.validate();
+
+    const double true_min = std::max(0.0, setup.energy_min - setup.true_margin);
+    const double true_max = setup.energy_max + setup.true_margin;
+    const auto   n_true   = static_cast<std::size_t>(std::ceil((true_max - true_min) / m_TrueBinWidth));
+
+    m_TrueEnergies.resize(n_true);
+    for (std::size_t j = 0; j < n_true; ++j) {
+      m_TrueEnergies[j] = true_min + (static_cast<double>(j) + 0.5) * m_TrueBinWidth;
+    }
+
+    m_LoverE.reserve(m_NCores * n_true);
+    m_Rate.reserve(m_NCores * n_true);
+    for (const auto& core : setup.cores) {
+      const double baseline = core.baseline * 1.0e3;
+      const double flux     = core.power / (core.baseline * core.baseline);
+
+      for (const double energy : m_TrueEnergies) {
+        const double neutrino_energy = energy + prompt_energy_offset;
+        m_LoverE.push_back(baseline / neutrino_energy);
+        m_Rate.push_back(flux * flux_times_cross_section(neutrino_energy));
+      }
+    }
+
+    // The spectrum is normalized to one event without oscillation
+    const double total = std::accumulate(m_Rate.begin(), m_Rate.end(), 0.0);
+    for (double& rate : m_Rate) {
+      rate /= total;
+    }
+
+    m_Spectrum.assign(n_true, 0.0);
+  }
+
+  bool FineOscillator::check_and_recalculate(const dc::ParameterWrapper& parameter) noexcept {
+    PHYLINO_PROFILE_SCOPE(timer, m_Profile.total());
+
+    const bool recalculate = parameter.check_parameter_changed(SinSqT13, DeltaM21);
+
+    if (recalculate) {
+      recalculate_spectrum(parameter);
+    }
+
+    PHYLINO_PROFILE_RECOMPUTED(timer, recalculate);
+
+    return recalculate;
+  }
+
+  void FineOscillator::recalculate_spectrum(const dc::ParameterWrapper& parameter) noexcept {
+    PHYLINO_TIMELINE_SCOPE("JUNO/Oscillator", "component");
+
+    const double s13 = parameter[SinSqT13];
+    const double s12 = parameter[SinSqT12];
+
+    // cos^4(theta13) and cos^2(theta12) from sin^2(2 theta)
+    const double cos4_13 = pow_2(0.5 * (1.0 + std::sqrt(std::max(0.0, 1.0 - s13))));
+    const double cos2_12 = 0.5 * (1.0 + std::sqrt(std::max(0.0, 1.0 - s12)));
+
+    // The amplitudes of the three terms, the 31 and 32 terms share the theta13 amplitude
+    const double amp21 = cos4_13 * s12;
+    const double amp31 = s13 * cos2_12;
+    const double amp32 = s13 * (1.0 - cos2_12);
+
+    const double dm21 = 1.267 * parameter[DeltaM21];
+    const double dm31 = 1.267 * parameter[DeltaM31];
+    const double dm32 = dm31 - dm21;
+
+    const std::size_t n_true   = m_Spectrum.size();
+    double*           spectrum = m_Spectrum.data();
+
+    std::ranges::fill(m_Spectrum, 0.0);
+
+    for (std::size_t core = 0; core < m_NCores; ++core) {
+      const double* loe  = m_LoverE.data() + core * n_true;
+      const double* rate = m_Rate.data() + core * n_true;
+
+      #pragma omp simd
+      for (std::size_t j = 0; j < n_true; ++j) {
+        const double t21 = amp21 * pow_2(sin(dm21 * loe[j]));
+        const double t31 = amp31 * pow_2(sin(dm31 * loe[j]));
+        const double t32 = amp32 * pow_2(sin(dm32 * loe[j]));
+        spectrum[j] += rate[j] * (1.0 - t21 - t31 - t32);
+      }
+    }
+  }
+
+}  // namespace ana::juno
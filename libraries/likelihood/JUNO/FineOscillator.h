@@ -0,0 +1,58 @@
+#pragma once
+
+// includes
+#include "MediumBaselineSetup.h"
+#include "../ParameterWrapper.h"
+#include "../../utilities/Profiling.h"
+
+// STL includes
+#include <span>
+#include <vector>
+
+namespace ana::juno {
+
+  /**
+   * @class FineOscillator
+   * @brief Calculates the oscillated reactor spectrum on the fine true energy grid.
+   *
+   * The unoscillated rate of every core and true energy bin, i.e. flux, cross section and 1/L^2, is tabulated at
+   * construction together with L/E. The recalculation is a single vectorized loop per core which evaluates all
+   * three oscillation terms and accumulates the cores into one spectrum, normalized to one event without
+   * oscillation.
+   */
+  class FineOscillator {
+   public:
+    explicit FineOscillator(const MediumBaselineSetup& setup);
+
+    /**
+     * @brief Recalculates the spectrum if an oscillation parameter changed.
+     *
+     * @return Whether the spectrum was recalculated.
+     */
+    bool check_and_recalculate(const dc::ParameterWrapper& parameter) noexcept;
+
+    [[nodiscard]] std::span<const double> get_spectrum() const noexcept { return m_Spectrum; }
+
+    /**
+     * @brief Returns the centers of the true energy bins in prompt energy.
+     */
+    [[nodiscard]] std::span<const double> true_energies() const noexcept { return m_TrueEnergies; }
+
+    [[nodiscard]] double true_bin_width() const noexcept { return m_TrueBinWidth; }
+
+    [[nodiscard]] utilities::ComponentProfile& profile() noexcept { return m_Profile; }
+
+   private:
+    std::size_t         m_NCores;        ///< The number of reactor cores.
+    double              m_TrueBinWidth;  ///< The width of the true energy bins in MeV.
+    std::vector<double> m_TrueEnergies;  ///< The centers of the true energy bins in prompt energy.
+    std::vector<double> m_LoverE;        ///< L/E in m/MeV, core after core.
+    std::vector<double> m_Rate;          ///< The unoscillated rate, core after core.
+    std::vector<double> m_Spectrum;      ///< The oscillated spectrum per true energy bin.
+
+    utilities::ComponentProfile m_Profile{"JUNO/Oscillator"};  ///< The timing counters.
+
+    void recalculate_spectrum(const dc::ParameterWrapper& parameter) noexcept;
+  };
+
+}  // namespace ana::juno
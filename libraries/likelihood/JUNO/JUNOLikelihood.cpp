@@ -0,0 +1,110 @@
+#include "JUNOLikelihood.h"
+
+// includes
+#include "../../utilities/Timeline.h"
+
+// STL includes
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
+namespace ana::juno {
+
+  namespace {
+    /**
+     * @brief Creates the chain of the reactor spectrum steps.
+     */
+    std::shared_ptr<EnergyScaleCorrection> make_reactor_spectrum(const MediumBaselineSetup& setup) {
+      setup.validate();
+
+      auto oscillator = std::make_shared<FineOscillator>(setup);
+      auto resolution = std::make_shared<EnergyResolution>(setup, std::move(oscillator));
+      auto shape      = std::make_shared<ShapeUncertainty>(setup, std::move(resolution));
+      return std::make_shared<EnergyScaleCorrection>(setup, std::move(shape));
+    }
+  }  // namespace
+
+  JUNOLikelihood::JUNOLikelihood(std::shared_ptr<io::Options> options, MediumBaselineSetup setup)
+    : Likelihood(std::move(options), juno::number_of_parameters(setup))
+    , m_Setup(std::move(setup))
+    , m_Reactor(make_reactor_spectrum(m_Setup))
+    , m_Background(m_Setup.n_bins, 0.0)
+    , m_MeasurementData(m_Setup.n_bins, 0.0)
+    , m_Prediction(m_Setup.n_bins, 0.0) {
+    // The background falls off exponentially on top of a flat component, normalized to its fraction of the
+    // reactor events
+    for (int i = 0; i < m_Setup.n_bins; ++i) {
+      const double energy = m_Setup.energy_min + (i + 0.5) * m_Setup.bin_width();
+      m_Background[i]     = std::exp(-energy / 1.5) + 0.05;
+    }
+    const double background_total = std::accumulate(m_Background.begin(), m_Background.end(), 0.0);
+    for (double& bin : m_Background) {
+      bin *= m_Setup.background_fraction * m_Setup.signal_events / background_total;
+    }
+
+    std::cout << "Calculate the medium-baseline spectrum for the Asimov data set generation!\n";
+    const std::vector<double> nominal = nominal_parameters(m_Setup);
+    calculate_prediction(nominal.data());
+    m_MeasurementData = m_Prediction;
+
+    // The counters should only contain the calls of the fit, not the ones of the Asimov data generation
+    reset_profiles();
+  }
+
+  void JUNOLikelihood::calculate_prediction(const double* parameter) noexcept {
+    m_Parameter.reset_parameter(parameter);
+    m_Reactor->check_and_recalculate(m_Parameter);
+
+    const double signal     = m_Setup.signal_events * (1.0 + m_Setup.flux_uncertainty * m_Parameter[FluxNorm]);
+    const double background = 1.0 + m_Setup.background_uncertainty * m_Parameter[BkgNorm];
+
+    const auto reactor = m_Reactor->get_spectrum();
+    for (std::size_t i = 0; i < m_Prediction.size(); ++i) {
+      m_Prediction[i] = signal * reactor[i] + background * m_Background[i];
+    }
+  }
+
+  double JUNOLikelihood::calculate_likelihood(const double* parameter) {
+    PHYLINO_TIMELINE_SCOPE("JUNO/Likelihood", "likelihood");
+
+    calculate_prediction(parameter);
+
+    PHYLINO_PROFILE_SCOPE(timer, m_LikelihoodProfile.total());
+
+    double likelihood = 0.0;
+
+    #pragma omp simd reduction(+ : likelihood)
+    for (std::size_t i = 0; i < m_Prediction.size(); ++i) {
+      likelihood += m_MeasurementData[i] * std::log(m_Prediction[i]) - m_Prediction[i];
+    }
+    likelihood *= -2.0;
+
+    // The nuisance parameters are given in units of their uncertainty, so every pull has unit width
+    for (int i = FluxNorm; i < number_of_parameters(); ++i) {
+      likelihood += m_Parameter[i] * m_Parameter[i];
+    }
+
+    // Return the likelihood parameter if it is finite, otherwise return a large number. This is to prevent the minimizer from crashing.
+    return std::isfinite(likelihood) ? likelihood : 1.0e25;
+  }
+
+  std::vector<const utilities::ComponentProfile*> JUNOLikelihood::collect_profiles() {
+    auto& shape      = *m_Reactor->shape();
+    auto& resolution = *shape.resolution();
+    auto& oscillator = *resolution.oscillator();
+
+    return {&oscillator.profile(), &resolution.profile(), &shape.profile(), &m_Reactor->profile(), &m_LikelihoodProfile};
+  }
+
+  void JUNOLikelihood::reset_profiles() noexcept {
+    auto& shape      = *m_Reactor->shape();
+    auto& resolution = *shape.resolution();
+
+    resolution.oscillator()->profile().reset();
+    resolution.profile().reset();
+    shape.profile().reset();
+    m_Reactor->profile().reset();
+    m_LikelihoodProfile.reset();
+  }
+
+}  // namespace ana::juno
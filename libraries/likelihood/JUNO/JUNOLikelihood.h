@@ -0,0 +1,84 @@
+#pragma once
+
+// includes
+#include "EnergyScaleCorrection.h"
+#include "../Likelihood.h"
+
+namespace ana::juno {
+
+  /**
+   * @class JUNOLikelihood
+   * @brief The likelihood of a medium-baseline reactor experiment with a single detector, similar to JUNO.
+   *
+   * The reactor spectrum is calculated by a chain of steps like the Double Chooz reactor spectrum: the oscillation
+   * on the fine true energy grid, the energy resolution, the shape uncertainty and the energy scale. Every step
+   * is only recalculated if one of its parameters or a previous step changed. The prediction adds a background
+   * of fixed shape, the measurement is the Asimov data set of the nominal parameters.
+   *
+   * The parameters are given by juno::Parameter and are independent of the Double Chooz parameters.
+   */
+  class JUNOLikelihood : public dc::Likelihood {
+   public:
+    /**
+     * @brief Constructs the likelihood and generates the Asimov data set.
+     *
+     * @param options The options of the framework, only used for the parameter wrapper.
+     * @param setup The configuration of the experiment.
+     * @throws std::invalid_argument if the setup is inconsistent.
+     */
+    explicit JUNOLikelihood(std::shared_ptr<io::Options> options, MediumBaselineSetup setup = MediumBaselineSetup::juno_like());
+
+    ~JUNOLikelihood() override = default;
+
+    /**
+     * @brief Calculates -2 log L of the Poisson terms of all bins plus the pull terms of the nuisance parameters.
+     *
+     * @param parameter The values of all parameters, see juno::Parameter.
+     */
+    [[nodiscard]] double calculate_likelihood(const double* parameter) override;
+
+    [[nodiscard]] const MediumBaselineSetup& setup() const noexcept { return m_Setup; }
+
+    [[nodiscard]] int number_of_parameters() const noexcept { return juno::number_of_parameters(m_Setup); }
+
+    [[nodiscard]] std::span<const double> get_measurement_data() const noexcept { return m_MeasurementData; }
+
+    /**
+     * @brief Returns the prediction of the last likelihood call.
+     */
+    [[nodiscard]] std::span<const double> get_prediction() const noexcept { return m_Prediction; }
+
+    [[nodiscard]] std::span<const double> get_background() const noexcept { return m_Background; }
+
+    [[nodiscard]] const std::shared_ptr<EnergyScaleCorrection>& reactor_spectrum() const noexcept { return m_Reactor; }
+
+    /**
+     * @brief Returns the timing counters of all steps of the reactor spectrum and of the likelihood terms.
+     *
+     * The counters are only filled if the code is compiled with PHYLINO_PROFILING.
+     */
+    [[nodiscard]] std::vector<const utilities::ComponentProfile*> collect_profiles();
+
+    /**
+     * @brief Resets the timing counters of all steps and of the likelihood terms.
+     */
+    void reset_profiles() noexcept;
+
+   private:
+    MediumBaselineSetup m_Setup;  ///< The configuration of the experiment.
+
+    std::shared_ptr<EnergyScaleCorrection> m_Reactor;  ///< The last step of the reactor spectrum chain.
+
+    std::vector<double> m_Background;       ///< The background spectrum for the nominal background rate.
+    std::vector<double> m_MeasurementData;  ///< The Asimov data set.
+    std::vector<double> m_Prediction;       ///< The prediction of the last call.
+
+    utilities::ComponentProfile m_LikelihoodProfile{"JUNO/Likelihood"};  ///< The timing counters of the Poisson and pull terms.
+
+    /**
+     * @brief Recalculates the reactor spectrum if necessary and fills m_Prediction.
+     */
+    void calculate_prediction(const double* parameter) noexcept;
+  };
+
+}  // namespace ana::juno
@@ -0,0 +1,61 @@
+#include "MediumBaselineSetup.h"
+
+// STL includes
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace ana::juno {
+
+  MediumBaselineSetup MediumBaselineSetup::juno_like() {
+    MediumBaselineSetup setup;
+    setup.cores = {{"Taishan1", 52.77, 4.6},
+                   {"Taishan2", 52.64, 4.6},
+                   {"Yangjiang1", 52.74, 2.9},
+                   {"Yangjiang2", 52.82, 2.9},
+                   {"Yangjiang3", 52.41, 2.9},
+                   {"Yangjiang4", 52.49, 2.9},
+                   {"Yangjiang5", 52.11, 2.9},
+                   {"Yangjiang6", 52.19, 2.9},
+                   {"DayaBay", 215.0, 17.4},
+                   {"Huizhou", 265.0, 17.4}};
+    return setup;
+  }
+
+  void MediumBaselineSetup::validate() const {
+    if (cores.empty()) {
+      throw std::invalid_argument("The medium-baseline setup needs at least one reactor core");
+    }
+    for (const auto& core : cores) {
+      if (core.baseline <= 0.0 || core.power <= 0.0) {
+        throw std::invalid_argument("The reactor core " + core.name + " needs a positive baseline and power");
+      }
+    }
+    if (energy_min <= 0.0 || energy_max <= energy_min || n_bins <= 0 || oversampling <= 0 || true_margin < 0.0) {
+      throw std::invalid_argument("Invalid energy binning of the medium-baseline setup");
+    }
+    if (shape_modes < 0 || shape_modes > n_bins) {
+      throw std::invalid_argument("The number of shape modes must be between 0 and the number of bins");
+    }
+  }
+
+  std::vector<std::string> parameter_names(const MediumBaselineSetup& setup) {
+    std::vector<std::string> names = {"SinSqT13", "DeltaM31", "SinSqT12", "DeltaM21", "FluxNorm", "EnergyScale", "BkgNorm"};
+    for (int i = 0; i < setup.shape_modes; ++i) {
+      std::stringstream ss;
+      ss << "ShapeMode" << std::setw(2) << std::setfill('0') << i + 1;
+      names.push_back(ss.str());
+    }
+    return names;
+  }
+
+  std::vector<double> nominal_parameters(const MediumBaselineSetup& setup) {
+    std::vector<double> parameters(number_of_parameters(setup), 0.0);
+    parameters[SinSqT13] = 0.085;
+    parameters[DeltaM31] = 2.53e-3;
+    parameters[SinSqT12] = 0.851;
+    parameters[DeltaM21] = 7.53e-5;
+    return parameters;
+  }
+
+}  // namespace ana::juno
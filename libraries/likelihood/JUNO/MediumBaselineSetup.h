@@ -0,0 +1,98 @@
+#pragma once
+
+// STL includes
+#include <string>
+#include <vector>
+
+namespace ana::juno {
+
+  /**
+   * @brief A reactor core seen by the detector.
+   */
+  struct ReactorCore {
+    std::string name;      ///< The name of the core.
+    double      baseline;  ///< The distance to the detector in km.
+    double      power;     ///< The thermal power in GW.
+  };
+
+  /**
+   * @brief The configuration of a medium-baseline reactor experiment with a single detector.
+   *
+   * The reconstructed spectrum is binned finely in the prompt energy. The oscillation is calculated on a true
+   * energy grid which is oversampled with respect to the reconstructed bins and extends beyond them, so the
+   * energy resolution can move events across the edges of the analysis range.
+   */
+  struct MediumBaselineSetup {
+    std::vector<ReactorCore> cores;  ///< The reactor cores.
+
+    double energy_min   = 0.8;  ///< The lower edge of the analysis range in MeV.
+    double energy_max   = 8.8;  ///< The upper edge of the analysis range in MeV.
+    int    n_bins       = 400;  ///< The number of reconstructed energy bins.
+    int    oversampling = 4;    ///< The number of true energy bins per reconstructed bin.
+    double true_margin  = 1.0;  ///< The extension of the true energy grid beyond the analysis range in MeV.
+
+    double resolution_a = 0.0261;  ///< The stochastic term of the energy resolution in sqrt(MeV).
+    double resolution_b = 0.0082;  ///< The constant term of the energy resolution.
+    double resolution_c = 0.0123;  ///< The noise term of the energy resolution in MeV.
+
+    double signal_events       = 1.0e5;  ///< The expected number of reactor events without oscillation.
+    double background_fraction = 0.05;   ///< The number of background events relative to the reactor events.
+
+    double flux_uncertainty         = 0.02;  ///< The relative uncertainty of the reactor flux.
+    double energy_scale_uncertainty = 0.01;  ///< The relative uncertainty of the energy scale.
+    double background_uncertainty   = 0.1;   ///< The relative uncertainty of the background rate.
+
+    double shape_uncertainty        = 0.01;  ///< The relative bin-to-bin uncertainty of the reactor spectrum shape.
+    double shape_correlation_length = 0.5;   ///< The correlation length of the shape uncertainty in MeV.
+    int    shape_modes              = 20;    ///< The number of leading eigenmodes of the shape uncertainty.
+
+    /**
+     * @brief Returns a setup similar to JUNO, with the Taishan and Yangjiang cores close to 53 km and the distant
+     *        Daya Bay and Huizhou sites.
+     */
+    [[nodiscard]] static MediumBaselineSetup juno_like();
+
+    [[nodiscard]] double bin_width() const noexcept { return (energy_max - energy_min) / n_bins; }
+
+    /**
+     * @brief Checks the setup for consistency.
+     *
+     * @throws std::invalid_argument if the setup can not be used.
+     */
+    void validate() const;
+  };
+
+  /**
+   * @brief The parameters of the medium-baseline likelihood.
+   *
+   * The oscillation parameters are given by their physical values, sin^2(2 theta) and Delta m^2 in eV^2. The
+   * nuisance parameters are deviations from their central values in units of their uncertainty. The shape
+   * parameters follow after ShapeMode01, one per eigenmode of the shape uncertainty.
+   */
+  enum Parameter : int {
+    SinSqT13 = 0,
+    DeltaM31,
+    SinSqT12,
+    DeltaM21,
+    FluxNorm,
+    EnergyScale,
+    BkgNorm,
+    ShapeMode01
+  };
+
+  [[nodiscard]] inline int number_of_parameters(const MediumBaselineSetup& setup) noexcept {
+    return ShapeMode01 + setup.shape_modes;
+  }
+
+  /**
+   * @brief Returns the names of all parameters of the setup.
+   */
+  [[nodiscard]] std::vector<std::string> parameter_names(const MediumBaselineSetup& setup);
+
+  /**
+   * @brief Returns the nominal values of all parameters, i.e. global best-fit oscillation parameters and no shift
+   *        of the nuisance parameters.
+   */
+  [[nodiscard]] std::vector<double> nominal_parameters(const MediumBaselineSetup& setup);
+
+}  // namespace ana::juno
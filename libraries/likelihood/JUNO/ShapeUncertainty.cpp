@@ -0,0 +1,68 @@
+#include "ShapeUncertainty.h"
+
+// includes
+#include "../../utilities/Timeline.h"
+
+// STL includes
+#include <cmath>
+
+// Eigen includes
+#include <Eigen/Eigenvalues>
+
+namespace ana::juno {
+
+  ShapeUncertainty::ShapeUncertainty(const MediumBaselineSetup& setup, std::shared_ptr<EnergyResolution> resolution)
+    : m_Resolution(std::move(resolution))
+    , m_Relative(setup.n_bins)
+    , m_Spectrum(setup.n_bins) {
+    const int    n     = setup.n_bins;
+    const double width = setup.bin_width();
+
+    Eigen::MatrixXd covariance(n, n);
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j) {
+        covariance(i, j) = std::pow(setup.shape_uncertainty, 2) * std::exp(-std::abs(i - j) * width / setup.shape_correlation_length);
+      }
+    }
+
+    // The eigenvalues are sorted in increasing order, so the leading modes are the last columns
+    const Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(covariance);
+    const int                                            k = setup.shape_modes;
+
+    m_Modes = solver.eigenvectors().rightCols(k) * solver.eigenvalues().tail(k).cwiseMax(0.0).cwiseSqrt().asDiagonal();
+  }
+
+  bool ShapeUncertainty::check_and_recalculate(const dc::ParameterWrapper& parameter) noexcept {
+    const bool previous_step = m_Resolution->check_and_recalculate(parameter);
+
+    // Started after the previous step, which has its own counters
+    PHYLINO_PROFILE_SCOPE(timer, m_Profile.total());
+
+    const bool this_step   = m_Modes.cols() > 0 && parameter.check_parameter_changed(ShapeMode01, ShapeMode01 + static_cast<int>(m_Modes.cols()) - 1);
+    const bool recalculate = previous_step | this_step;
+
+    if (recalculate) {
+      apply_shape(parameter);
+    }
+
+    PHYLINO_PROFILE_RECOMPUTED(timer, recalculate);
+
+    return recalculate;
+  }
+
+  void ShapeUncertainty::apply_shape(const dc::ParameterWrapper& parameter) noexcept {
+    PHYLINO_TIMELINE_SCOPE("JUNO/ShapeUncertainty", "component");
+
+    const auto shape_parameter = parameter.sub_range(ShapeMode01, ShapeMode01 + static_cast<int>(m_Modes.cols()));
+    const auto spectrum        = m_Resolution->get_spectrum();
+
+    const Eigen::Map<const Eigen::VectorXd> p(shape_parameter.data(), static_cast<Eigen::Index>(shape_parameter.size()));
+    const Eigen::Map<const Eigen::VectorXd> s(spectrum.data(), static_cast<Eigen::Index>(spectrum.size()));
+
+    m_Relative.noalias() = m_Modes * p;
+
+    // Negative bin contents are clipped like in the Double Chooz shape correction
+    m_Spectrum = (s.array() * (1.0 + m_Relative.array())).cwiseMax(0.0).matrix();
+  }
+
+}  // namespace ana::juno
@@ -0,0 +1,52 @@
+#pragma once
+
+// includes
+#include "EnergyResolution.h"
+
+// Eigen includes
+#include <Eigen/Core>
+
+namespace ana::juno {
+
+  /**
+   * @class ShapeUncertainty
+   * @brief Applies the correlated uncertainty of the reactor spectrum shape.
+   *
+   * The relative covariance between two bins decays exponentially with their energy difference. Its leading
+   * eigenmodes, scaled by the square root of their eigenvalues, are calculated once at construction. A shape
+   * parameter shifts the spectrum by the relative amount of its mode, so the recalculation is a matrix-vector
+   * product with one column per mode instead of a decomposition of the full covariance matrix.
+   */
+  class ShapeUncertainty {
+   public:
+    ShapeUncertainty(const MediumBaselineSetup& setup, std::shared_ptr<EnergyResolution> resolution);
+
+    /**
+     * @brief Recalculates the previous steps if necessary and applies the shape parameters if anything changed.
+     */
+    bool check_and_recalculate(const dc::ParameterWrapper& parameter) noexcept;
+
+    [[nodiscard]] std::span<const double> get_spectrum() const noexcept { return {m_Spectrum.data(), static_cast<std::size_t>(m_Spectrum.size())}; }
+
+    /**
+     * @brief Returns the scaled eigenmodes, one column per shape parameter.
+     */
+    [[nodiscard]] const Eigen::MatrixXd& modes() const noexcept { return m_Modes; }
+
+    [[nodiscard]] const std::shared_ptr<EnergyResolution>& resolution() const noexcept { return m_Resolution; }
+
+    [[nodiscard]] utilities::ComponentProfile& profile() noexcept { return m_Profile; }
+
+   private:
+    std::shared_ptr<EnergyResolution> m_Resolution;
+
+    Eigen::MatrixXd m_Modes;     ///< The eigenmodes scaled by the square root of their eigenvalues.
+    Eigen::VectorXd m_Relative;  ///< Scratch memory for the relative shift per bin.
+    Eigen::VectorXd m_Spectrum;  ///< The spectrum with the shape correction.
+
+    utilities::ComponentProfile m_Profile{"JUNO/ShapeUncertainty"};  ///< The timing counters.
+
+    void apply_shape(const dc::ParameterWrapper& parameter) noexcept;
+  };
+
+}  // namespace ana::juno
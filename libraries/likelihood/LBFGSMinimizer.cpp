@@ -0,0 +1,433 @@
+#include "LBFGSMinimizer.h"
+
+// STL includes
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+// includes
+#include "Timeline.h"
+
+// ROOT includes
+#include <Math/Factory.h>
+
+namespace ana {
+
+  namespace {
+    // Fraction of the parameter step size used for the central differences
+    constexpr double derivative_step_fraction = 1.0e-4;
+
+    // Sufficient decrease constant of the Armijo condition
+    constexpr double armijo_constant = 1.0e-4;
+
+    constexpr int          max_line_search_steps  = 30;
+    constexpr unsigned int default_max_iterations = 10000;
+
+    /**
+     * @brief A correction pair of the limited-memory inverse Hessian.
+     */
+    struct Correction {
+      std::vector<double> s;    ///< The parameter difference.
+      std::vector<double> y;    ///< The gradient difference.
+      double              rho;  ///< 1 / (y * s)
+    };
+
+    /**
+     * @brief Replaces a non-finite function value by the largest double, so the line search backs off from it.
+     */
+    double finite_value(const double value) noexcept {
+      return std::isfinite(value) ? value : std::numeric_limits<double>::max();
+    }
+
+    double dot(const std::vector<double>& a, const std::vector<double>& b) {
+      return std::inner_product(a.begin(), a.end(), b.begin(), 0.0);
+    }
+  }  // namespace
+
+  LBFGSMinimizer::LBFGSMinimizer(const std::size_t history)
+    : m_History(history)
+    , m_MinValue(std::numeric_limits<double>::max())
+    , m_Edm(-1.0)
+    , m_NCalls(0) {
+    fValidError = false;
+    fStatus     = -1;
+  }
+
+  void LBFGSMinimizer::SetFunction(const ROOT::Math::IMultiGenFunction& func) {
+    m_Function.reset(func.Clone());
+  }
+
+  void LBFGSMinimizer::SetGradientFunctions(utilities::TaskScheduler& scheduler, std::vector<std::shared_ptr<ROOT::Math::IMultiGenFunction>> functions) {
+    m_Scheduler         = &scheduler;
+    m_GradientFunctions = std::move(functions);
+    m_GradientPoints.assign(m_GradientFunctions.size(), {});
+  }
+
+  bool LBFGSMinimizer::SetVariable(unsigned int ivar, const std::string& name, double val, double step) {
+    if (ivar > m_X.size()) {
+      std::cerr << "LBFGSMinimizer: variable " << ivar << " has to be added in order\n";
+      return false;
+    }
+
+    if (ivar == m_X.size()) {
+      m_Names.push_back(name);
+      m_X.push_back(val);
+      m_Steps.push_back(step);
+      m_Fixed.push_back(false);
+    } else {
+      m_Names[ivar] = name;
+      m_X[ivar]     = val;
+      m_Steps[ivar] = step;
+      m_Fixed[ivar] = false;
+    }
+
+    return true;
+  }
+
+  bool LBFGSMinimizer::SetVariableValue(unsigned int ivar, double val) {
+    if (ivar >= m_X.size()) {
+      return false;
+    }
+    m_X[ivar] = val;
+    return true;
+  }
+
+  bool LBFGSMinimizer::SetVariableStepSize(unsigned int ivar, double step) {
+    if (ivar >= m_Steps.size() || !(step > 0.0)) {
+      return false;
+    }
+    m_Steps[ivar] = step;
+    return true;
+  }
+
+  bool LBFGSMinimizer::FixVariable(unsigned int ivar) {
+    if (ivar >= m_Fixed.size()) {
+      return false;
+    }
+    m_Fixed[ivar] = true;
+    return true;
+  }
+
+  bool LBFGSMinimizer::ReleaseVariable(unsigned int ivar) {
+    if (ivar >= m_Fixed.size()) {
+      return false;
+    }
+    m_Fixed[ivar] = false;
+    return true;
+  }
+
+  bool LBFGSMinimizer::IsFixedVariable(unsigned int ivar) const {
+    return ivar < m_Fixed.size() && m_Fixed[ivar];
+  }
+
+  unsigned int LBFGSMinimizer::NFree() const {
+    return static_cast<unsigned int>(std::ranges::count(m_Fixed, false));
+  }
+
+  std::string LBFGSMinimizer::VariableName(unsigned int ivar) const {
+    return ivar < m_Names.size() ? m_Names[ivar] : std::string{};
+  }
+
+  int LBFGSMinimizer::VariableIndex(const std::string& name) const {
+    const auto it = std::ranges::find(m_Names, name);
+    return it == m_Names.end() ? -1 : static_cast<int>(std::distance(m_Names.begin(), it));
+  }
+
+  void LBFGSMinimizer::Clear() {
+    m_Names.clear();
+    m_X.clear();
+    m_Steps.clear();
+    m_Fixed.clear();
+    m_Errors.clear();
+    m_Covariance.clear();
+    m_MinValue  = std::numeric_limits<double>::max();
+    m_Edm       = -1.0;
+    m_NCalls    = 0;
+    fValidError = false;
+    fStatus     = -1;
+  }
+
+  double LBFGSMinimizer::CovMatrix(unsigned int i, unsigned int j) const {
+    return m_Covariance.empty() ? 0.0 : m_Covariance[i * m_X.size() + j];
+  }
+
+  bool LBFGSMinimizer::GetCovMatrix(double* cov) const {
+    if (m_Covariance.empty()) {
+      return false;
+    }
+    std::ranges::copy(m_Covariance, cov);
+    return true;
+  }
+
+  double LBFGSMinimizer::evaluate(const std::vector<double>& x) {
+    ++m_NCalls;
+    return finite_value((*m_Function)(x.data()));
+  }
+
+  double LBFGSMinimizer::derivative_step(const std::size_t i, const double xi) const noexcept {
+    return std::max(derivative_step_fraction * m_Steps[i], 1.0e-8 * std::max(std::abs(xi), 1.0));
+  }
+
+  void LBFGSMinimizer::gradient(std::vector<double>& x, const std::vector<std::size_t>& free, std::vector<double>& g) {
+    if (m_GradientFunctions.size() > 1) {
+      parallel_gradient(x, free, g);
+      return;
+    }
+
+    for (std::size_t k = 0; k < free.size(); ++k) {
+      const std::size_t i  = free[k];
+      const double      xi = x[i];
+      const double      h  = derivative_step(i, xi);
+
+      x[i]              = xi + h;
+      const double f_up = evaluate(x);
+      x[i]              = xi - h;
+      const double f_dn = evaluate(x);
+      x[i]              = xi;
+
+      g[k] = (f_up - f_dn) / (2.0 * h);
+    }
+  }
+
+  void LBFGSMinimizer::parallel_gradient(const std::vector<double>& x, const std::vector<std::size_t>& free, std::vector<double>& g) {
+    // Every task takes the next free parameter, so a slow evaluation does not hold back a whole chunk
+    std::atomic<std::size_t> next{0};
+
+    utilities::TaskGroup group(*m_Scheduler);
+    for (std::size_t t = 0; t < m_GradientFunctions.size(); ++t) {
+      group.run([this, t, &x, &free, &g, &next] {
+        auto& function = *m_GradientFunctions[t];
+        auto& point    = m_GradientPoints[t];
+        point          = x;
+
+        for (std::size_t k = next.fetch_add(1, std::memory_order_relaxed); k < free.size(); k = next.fetch_add(1, std::memory_order_relaxed)) {
+          const std::size_t i  = free[k];
+          const double      xi = x[i];
+          const double      h  = derivative_step(i, xi);
+
+          point[i]          = xi + h;
+          const double f_up = finite_value(function(point.data()));
+          point[i]          = xi - h;
+          const double f_dn = finite_value(function(point.data()));
+          point[i]          = xi;
+
+          g[k] = (f_up - f_dn) / (2.0 * h);
+        }
+      });
+    }
+    group.wait();
+
+    m_NCalls += static_cast<unsigned int>(2 * free.size());
+  }
+
+  bool LBFGSMinimizer::Minimize() {
+    if (!m_Function) {
+      std::cerr << "LBFGSMinimizer: no function set\n";
+      fStatus = 4;
+      return false;
+    }
+
+    m_Errors.clear();
+    m_Covariance.clear();
+    m_NCalls    = 0;
+    fValidError = false;
+
+    std::vector<std::size_t> free;
+    for (std::size_t i = 0; i < m_X.size(); ++i) {
+      if (!m_Fixed[i]) {
+        free.push_back(i);
+      }
+    }
+
+    const std::size_t n = free.size();
+
+    // Initial inverse Hessian of a chi-square like function with the step sizes as uncertainties
+    std::vector<double> diag(n);
+    for (std::size_t k = 0; k < n; ++k) {
+      diag[k] = 0.5 * m_Steps[free[k]] * m_Steps[free[k]] * ErrorDef();
+    }
+
+    const double       edm_limit      = 0.002 * Tolerance() * ErrorDef();
+    const unsigned int max_iterations = MaxIterations() > 0 ? MaxIterations() : default_max_iterations;
+    const unsigned int max_calls      = MaxFunctionCalls();
+
+    std::vector<double> x = m_X;
+    std::vector<double> g(n), d(n), alpha(m_History), g_new(n);
+
+    double fx = evaluate(x);
+    gradient(x, free, g);
+
+    std::deque<Correction> corrections;
+
+    fStatus = 1;  // Maximum number of iterations reached, unless converged below
+    for (unsigned int iteration = 0; iteration < max_iterations; ++iteration) {
+      PHYLINO_TIMELINE_SCOPE("LBFGSIteration", "minimizer");
+
+      // Two-loop recursion for d = -H * g
+      d = g;
+      for (std::size_t c = corrections.size(); c-- > 0;) {
+        alpha[c] = corrections[c].rho * dot(corrections[c].s, d);
+        for (std::size_t k = 0; k < n; ++k) {
+          d[k] -= alpha[c] * corrections[c].y[k];
+        }
+      }
+
+      double gamma = 1.0;
+      if (!corrections.empty()) {
+        const auto& last = corrections.back();
+
+        double yDy = 0.0;
+        for (std::size_t k = 0; k < n; ++k) {
+          yDy += last.y[k] * diag[k] * last.y[k];
+        }
+        gamma = 1.0 / (last.rho * yDy);
+      }
+
+      for (std::size_t k = 0; k < n; ++k) {
+        d[k] *= gamma * diag[k];
+      }
+
+      for (std::size_t c = 0; c < corrections.size(); ++c) {
+        const double beta = corrections[c].rho * dot(corrections[c].y, d);
+        for (std::size_t k = 0; k < n; ++k) {
+          d[k] += corrections[c].s[k] * (alpha[c] - beta);
+        }
+      }
+
+      for (auto& dk : d) {
+        dk = -dk;
+      }
+
+      double slope = dot(g, d);
+      if (!(slope < 0.0)) {
+        // The approximation is not positive definite anymore, restart from the diagonal
+        corrections.clear();
+        for (std::size_t k = 0; k < n; ++k) {
+          d[k] = -diag[k] * g[k];
+        }
+        slope = dot(g, d);
+      }
+
+      m_Edm = -0.5 * slope;
+
+      if (PrintLevel() > 0) {
+        std::cout << "LBFGS iteration " << std::setw(6) << iteration << "  FCN = " << std::setprecision(12) << fx
+                  << "  Edm = " << m_Edm << "  NCalls = " << m_NCalls << '\n';
+      }
+
+      if (m_Edm < edm_limit) {
+        fStatus = 0;
+        break;
+      }
+
+      if (max_calls > 0 && m_NCalls >= max_calls) {
+        fStatus = 1;
+        break;
+      }
+
+      // Backtracking line search with the Armijo condition, starting from the full quasi-Newton step
+      std::vector<double> x_new    = x;
+      double              f_new    = fx;
+      double              step     = 1.0;
+      bool                accepted = false;
+      for (int ls = 0; ls < max_line_search_steps; ++ls) {
+        for (std::size_t k = 0; k < n; ++k) {
+          x_new[free[k]] = x[free[k]] + step * d[k];
+        }
+        f_new = evaluate(x_new);
+
+        if (f_new <= fx + armijo_constant * step * slope) {
+          accepted = true;
+          break;
+        }
+
+        // Minimum of the quadratic interpolation, limited to [0.1, 0.5] of the current step
+        const double denominator = 2.0 * (f_new - fx - step * slope);
+        const double shrink      = denominator > 0.0 ? -slope * step / denominator : 0.5;
+        step *= std::clamp(shrink, 0.1, 0.5);
+      }
+
+      if (!accepted) {
+        if (corrections.empty()) {
+          fStatus = 2;  // Line search failed along the steepest descent direction
+          break;
+        }
+        corrections.clear();
+        continue;
+      }
+
+      gradient(x_new, free, g_new);
+
+      Correction correction{std::vector<double>(n), std::vector<double>(n), 0.0};
+      for (std::size_t k = 0; k < n; ++k) {
+        correction.s[k] = x_new[free[k]] - x[free[k]];
+        correction.y[k] = g_new[k] - g[k];
+      }
+
+      // Only keep pairs which preserve the positive definiteness of the approximation
+      const double sy = dot(correction.s, correction.y);
+      if (sy > std::numeric_limits<double>::epsilon() * dot(correction.y, correction.y)) {
+        correction.rho = 1.0 / sy;
+        corrections.push_back(std::move(correction));
+        if (corrections.size() > m_History) {
+          corrections.pop_front();
+        }
+      }
+
+      x  = std::move(x_new);
+      fx = f_new;
+      g.swap(g_new);
+    }
+
+    m_X        = std::move(x);
+    m_MinValue = fx;
+
+    if (PrintLevel() > 0) {
+      std::cout << "LBFGS finished with status " << fStatus << ", FCN = " << m_MinValue << ", Edm = " << m_Edm
+                << ", NCalls = " << m_NCalls << '\n';
+    }
+
+    return fStatus == 0;
+  }
+
+  bool LBFGSMinimizer::Hesse() {
+    if (!m_Function) {
+      return false;
+    }
+
+    std::unique_ptr<ROOT::Math::Minimizer> hesse(ROOT::Math::Factory::CreateMinimizer("Minuit2", "Migrad"));
+
+    hesse->SetFunction(*m_Function);
+    hesse->SetErrorDef(ErrorDef());
+    hesse->SetPrintLevel(PrintLevel());
+
+    for (unsigned int i = 0; i < NDim(); ++i) {
+      hesse->SetVariable(i, m_Names[i], m_X[i], m_Steps[i]);
+      if (m_Fixed[i]) {
+        hesse->FixVariable(i);
+      }
+    }
+
+    if (!hesse->Hesse()) {
+      return false;
+    }
+
+    m_NCalls += hesse->NCalls();
+
+    m_Errors.assign(hesse->Errors(), hesse->Errors() + NDim());
+    m_Covariance.assign(static_cast<std::size_t>(NDim()) * NDim(), 0.0);
+    if (!hesse->GetCovMatrix(m_Covariance.data())) {
+      m_Covariance.clear();
+      return false;
+    }
+
+    fValidError = true;
+    return true;
+  }
+
+}  // namespace ana
@@ -0,0 +1,147 @@
+#pragma once
+
+// includes
+#include "TaskScheduler.h"
+
+// STL includes
+#include <memory>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include <Math/IFunction.h>
+#include <Math/Minimizer.h>
+
+namespace ana {
+
+  /**
+   * @class LBFGSMinimizer
+   * @brief Limited-memory BFGS minimizer implementing the ROOT::Math::Minimizer interface.
+   *
+   * Instead of the dense inverse Hessian of Migrad only the last few parameter and gradient differences are
+   * stored, so memory and time per iteration scale linearly with the number of free parameters. The gradient
+   * is calculated with central differences, the initial inverse Hessian is the diagonal of the squared step
+   * sizes. The convergence criterion follows Minuit, i.e. the estimated distance to the minimum has to be
+   * smaller than 0.002 * tolerance * error definition. The error matrix is calculated afterward by Hesse().
+   *
+   * The central differences of the gradient take two function calls per free parameter. With gradient functions
+   * set, they are evaluated in parallel on the threads of a scheduler.
+   */
+  class LBFGSMinimizer : public ROOT::Math::Minimizer {
+   public:
+    /**
+     * @brief Constructs the minimizer.
+     *
+     * @param history The number of stored correction pairs.
+     */
+    explicit LBFGSMinimizer(std::size_t history = 10);
+
+    ~LBFGSMinimizer() override = default;
+
+    void SetFunction(const ROOT::Math::IMultiGenFunction& func) override;
+
+    /**
+     * @brief Sets the functions evaluating the gradient in parallel.
+     *
+     * Every function is called by a single task at a time, so the functions have to be independent of each other,
+     * e.g. separate likelihood objects of the same data. They have to return the same values as the function of
+     * SetFunction(). Without functions, the gradient is calculated sequentially with the function of SetFunction().
+     *
+     * @param scheduler The scheduler running the evaluations.
+     * @param functions One function per task, usually one per thread of the scheduler.
+     */
+    void SetGradientFunctions(utilities::TaskScheduler& scheduler, std::vector<std::shared_ptr<ROOT::Math::IMultiGenFunction>> functions);
+
+    bool SetVariable(unsigned int ivar, const std::string& name, double val, double step) override;
+
+    bool SetVariableValue(unsigned int ivar, double val) override;
+
+    bool SetVariableStepSize(unsigned int ivar, double step) override;
+
+    bool FixVariable(unsigned int ivar) override;
+
+    bool ReleaseVariable(unsigned int ivar) override;
+
+    [[nodiscard]] bool IsFixedVariable(unsigned int ivar) const override;
+
+    bool Minimize() override;
+
+    /**
+     * @brief Calculates the error matrix at the current point with the Minuit2 Hesse algorithm.
+     */
+    bool Hesse() override;
+
+    [[nodiscard]] double MinValue() const override { return m_MinValue; }
+
+    [[nodiscard]] const double* X() const override { return m_X.data(); }
+
+    [[nodiscard]] double Edm() const override { return m_Edm; }
+
+    [[nodiscard]] const double* Errors() const override { return m_Errors.empty() ? nullptr : m_Errors.data(); }
+
+    [[nodiscard]] double CovMatrix(unsigned int i, unsigned int j) const override;
+
+    bool GetCovMatrix(double* cov) const override;
+
+    [[nodiscard]] unsigned int NCalls() const override { return m_NCalls; }
+
+    [[nodiscard]] unsigned int NDim() const override { return static_cast<unsigned int>(m_X.size()); }
+
+    [[nodiscard]] unsigned int NFree() const override;
+
+    /**
+     * @brief Returns true once the error matrix has been calculated by Hesse().
+     */
+    [[nodiscard]] bool ProvidesError() const override { return !m_Covariance.empty(); }
+
+    [[nodiscard]] int CovMatrixStatus() const override { return m_Covariance.empty() ? 0 : 3; }
+
+    [[nodiscard]] std::string VariableName(unsigned int ivar) const override;
+
+    [[nodiscard]] int VariableIndex(const std::string& name) const override;
+
+    void Clear() override;
+
+   private:
+    /**
+     * @brief Evaluates the function at x and counts the call.
+     */
+    double evaluate(const std::vector<double>& x);
+
+    /**
+     * @brief Calculates the gradient in the free parameters with central differences.
+     */
+    void gradient(std::vector<double>& x, const std::vector<std::size_t>& free, std::vector<double>& g);
+
+    /**
+     * @brief Calculates the gradient with the gradient functions, the free parameters are distributed dynamically.
+     */
+    void parallel_gradient(const std::vector<double>& x, const std::vector<std::size_t>& free, std::vector<double>& g);
+
+    /**
+     * @brief Returns the step of the central difference of parameter i at the value xi.
+     */
+    [[nodiscard]] double derivative_step(std::size_t i, double xi) const noexcept;
+
+    std::unique_ptr<ROOT::Math::IMultiGenFunction> m_Function;  ///< The function to be minimized.
+
+    utilities::TaskScheduler*                                    m_Scheduler = nullptr;  ///< The scheduler of the parallel gradient.
+    std::vector<std::shared_ptr<ROOT::Math::IMultiGenFunction>> m_GradientFunctions;    ///< The functions of the parallel gradient.
+    std::vector<std::vector<double>>                             m_GradientPoints;       ///< The evaluation point of every gradient function.
+
+    std::size_t m_History;  ///< The number of stored correction pairs.
+
+    std::vector<std::string> m_Names;  ///< The parameter names.
+    std::vector<double>      m_X;      ///< The current parameter values.
+    std::vector<double>      m_Steps;  ///< The parameter step sizes.
+    std::vector<bool>        m_Fixed;  ///< Flags for the fixed parameters.
+
+    std::vector<double> m_Errors;      ///< The parameter errors, empty before Hesse().
+    std::vector<double> m_Covariance;  ///< The row-major covariance matrix, empty before Hesse().
+
+    double       m_MinValue;  ///< The function value at the minimum.
+    double       m_Edm;       ///< The estimated distance to the minimum.
+    unsigned int m_NCalls;    ///< The number of function calls.
+  };
+
+}  // namespace ana
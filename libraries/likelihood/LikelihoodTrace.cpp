@@ -0,0 +1,133 @@
+#include "LikelihoodTrace.h"
+
+// STL includes
+#include <array>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+
+namespace ana {
+
+  namespace {
+    constexpr std::array<char, 8> trace_magic   = {'P', 'L', 'N', 'O', 'T', 'R', 'C', 'E'};
+    constexpr std::uint32_t       trace_version = 1;
+
+    template <typename T>
+    void write_value(std::ostream& os, const T& value) {
+      os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    T read_value(std::istream& is) {
+      T value{};
+      is.read(reinterpret_cast<char*>(&value), sizeof(T));
+      if (!is) {
+        throw std::runtime_error("Unexpected end of likelihood trace");
+      }
+      return value;
+    }
+  }  // namespace
+
+  LikelihoodTraceWriter::LikelihoodTraceWriter(const std::string& path, const std::vector<std::string>& names, const std::vector<int>& profiled)
+    : m_File(path, std::ios::binary | std::ios::trunc)
+    , m_Previous(names.size(), std::numeric_limits<double>::quiet_NaN())
+    , m_NRecords(0) {
+    if (!m_File) {
+      throw std::runtime_error("Could not create likelihood trace " + path);
+    }
+
+    m_File.write(trace_magic.data(), trace_magic.size());
+    write_value(m_File, trace_version);
+
+    write_value(m_File, static_cast<std::uint64_t>(names.size()));
+    for (const auto& name : names) {
+      write_value(m_File, static_cast<std::uint64_t>(name.size()));
+      m_File.write(name.data(), static_cast<std::streamsize>(name.size()));
+    }
+
+    write_value(m_File, static_cast<std::uint64_t>(profiled.size()));
+    for (const int idx : profiled) {
+      write_value(m_File, static_cast<std::int32_t>(idx));
+    }
+
+    m_Changed.reserve(names.size());
+  }
+
+  void LikelihoodTraceWriter::record(const double* parameter, const double value) {
+    // The comparison is bitwise, so the replay sees exactly the same parameters. The NaN initialization of the
+    // previous parameters makes the first record contain all parameters.
+    m_Changed.clear();
+    for (std::size_t i = 0, N = m_Previous.size(); i < N; ++i) {
+      if (std::bit_cast<std::uint64_t>(parameter[i]) != std::bit_cast<std::uint64_t>(m_Previous[i])) {
+        m_Changed.emplace_back(static_cast<std::uint32_t>(i), parameter[i]);
+        m_Previous[i] = parameter[i];
+      }
+    }
+
+    write_value(m_File, static_cast<std::uint32_t>(m_Changed.size()));
+    for (const auto& [idx, v] : m_Changed) {
+      write_value(m_File, idx);
+      write_value(m_File, v);
+    }
+    write_value(m_File, value);
+
+    ++m_NRecords;
+  }
+
+  LikelihoodTraceReader::LikelihoodTraceReader(const std::string& path)
+    : m_File(path, std::ios::binary) {
+    if (!m_File) {
+      throw std::runtime_error("Could not open likelihood trace " + path);
+    }
+
+    std::array<char, 8> magic{};
+    m_File.read(magic.data(), magic.size());
+    if (!m_File || magic != trace_magic) {
+      throw std::runtime_error(path + " is not a likelihood trace");
+    }
+
+    if (const auto version = read_value<std::uint32_t>(m_File); version != trace_version) {
+      throw std::runtime_error("Unsupported likelihood trace version " + std::to_string(version) + " in " + path);
+    }
+
+    m_Names.resize(read_value<std::uint64_t>(m_File));
+    for (auto& name : m_Names) {
+      name.resize(read_value<std::uint64_t>(m_File));
+      m_File.read(name.data(), static_cast<std::streamsize>(name.size()));
+    }
+
+    m_Profiled.resize(read_value<std::uint64_t>(m_File));
+    for (auto& idx : m_Profiled) {
+      idx = read_value<std::int32_t>(m_File);
+    }
+    if (!m_File) {
+      throw std::runtime_error("Unexpected end of likelihood trace " + path);
+    }
+
+    m_Parameter.assign(m_Names.size(), 0.0);
+  }
+
+  bool LikelihoodTraceReader::next(std::span<const double>& parameter, double& value) {
+    std::uint32_t n_changed = 0;
+    m_File.read(reinterpret_cast<char*>(&n_changed), sizeof(n_changed));
+    if (m_File.gcount() == 0 && m_File.eof()) {
+      return false;
+    }
+    if (!m_File) {
+      throw std::runtime_error("Unexpected end of likelihood trace");
+    }
+
+    for (std::uint32_t i = 0; i < n_changed; ++i) {
+      const auto idx = read_value<std::uint32_t>(m_File);
+      if (idx >= m_Parameter.size()) {
+        throw std::runtime_error("Parameter index out of range in likelihood trace");
+      }
+      m_Parameter[idx] = read_value<double>(m_File);
+    }
+    value = read_value<double>(m_File);
+
+    parameter = m_Parameter;
+    return true;
+  }
+
+}  // namespace ana
@@ -0,0 +1,93 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace ana {
+
+  /**
+   * @class LikelihoodTraceWriter
+   * @brief Records the parameter vectors of all likelihood calls of a fit together with the returned values.
+   *
+   * The trace is a binary file with the magic "PLNOTRCE", a version number, the parameter names and the indices of
+   * the analytically profiled parameters, followed by one record per call. As the minimizer usually only changes a
+   * few parameters between two calls, a record only contains the parameters which differ bitwise from the previous
+   * call, as pairs of index and value, followed by the likelihood value.
+   */
+  class LikelihoodTraceWriter {
+   public:
+    /**
+     * @brief Creates the trace file, an existing file is overwritten.
+     *
+     * @param path The path of the trace file.
+     * @param names The names of the parameters.
+     * @param profiled The indices of the analytically profiled parameters.
+     * @throws std::runtime_error if the file can not be created.
+     */
+    LikelihoodTraceWriter(const std::string& path, const std::vector<std::string>& names, const std::vector<int>& profiled);
+
+    ~LikelihoodTraceWriter() = default;
+
+    /**
+     * @brief Appends a likelihood call to the trace.
+     *
+     * @param parameter The parameter vector of the call, of the size of the parameter names.
+     * @param value The returned likelihood value.
+     */
+    void record(const double* parameter, double value);
+
+    [[nodiscard]] std::uint64_t number_of_records() const noexcept { return m_NRecords; }
+
+   private:
+    std::ofstream       m_File;      ///< The trace file.
+    std::vector<double> m_Previous;  ///< The parameters of the previous call.
+    std::uint64_t       m_NRecords;  ///< The number of written records.
+
+    std::vector<std::pair<std::uint32_t, double>> m_Changed;  ///< The changed parameters of the current call.
+  };
+
+  /**
+   * @class LikelihoodTraceReader
+   * @brief Reads a likelihood trace written by LikelihoodTraceWriter.
+   */
+  class LikelihoodTraceReader {
+   public:
+    /**
+     * @brief Opens a trace file and reads its header.
+     *
+     * @param path The path of the trace file.
+     * @throws std::runtime_error if the file can not be read or is not a trace file.
+     */
+    explicit LikelihoodTraceReader(const std::string& path);
+
+    ~LikelihoodTraceReader() = default;
+
+    [[nodiscard]] const std::vector<std::string>& names() const noexcept { return m_Names; }
+
+    /**
+     * @brief Returns the indices of the parameters which were profiled analytically during the recording.
+     */
+    [[nodiscard]] const std::vector<int>& profiled() const noexcept { return m_Profiled; }
+
+    /**
+     * @brief Reads the next call of the trace.
+     *
+     * @param parameter The full parameter vector of the call.
+     * @param value The recorded likelihood value.
+     * @return False if the end of the trace is reached.
+     * @throws std::runtime_error if the trace is corrupted.
+     */
+    bool next(std::span<const double>& parameter, double& value);
+
+   private:
+    std::ifstream            m_File;       ///< The trace file.
+    std::vector<std::string> m_Names;      ///< The parameter names.
+    std::vector<int>         m_Profiled;   ///< The indices of the profiled parameters.
+    std::vector<double>      m_Parameter;  ///< The parameters of the current call.
+  };
+
+}  // namespace ana
@@ -0,0 +1,28 @@
+#pragma once
+
+// STL includes
+#include <span>
+
+namespace ana {
+
+  /**
+   * @class ParameterTransform
+   * @brief A stage of the ParameterWrapper which maps the raw parameters of the minimizer onto the model parameters.
+   *
+   * The transformation is applied by every ParameterWrapper::reset_parameter() before the change detection, so the
+   * change flags describe the transformed values. A transform may keep state between the calls, e.g. to recalculate
+   * only the parts whose inputs changed, therefore every wrapper owns its own instance.
+   */
+  class ParameterTransform {
+   public:
+    virtual ~ParameterTransform() = default;
+
+    /**
+     * @brief Replaces the raw parameters by the transformed ones.
+     *
+     * @param parameters The parameters in the order of params::index.
+     */
+    virtual void operator()(std::span<double> parameters) noexcept = 0;
+  };
+
+}  // namespace ana
@@ -6,14 +6,46 @@
 
 namespace ana::dc {
 
-  ParameterWrapper::ParameterWrapper(const std::size_t nParameter, std::shared_ptr<io::Options> options, transform_fn_t transform_fn)
+  ParameterWrapper::ParameterWrapper(const std::size_t nParameter, std::shared_ptr<io::Options> options)
     : m_CurrentParameters(nParameter, 0.0)
     , m_PreviousParameters(nParameter, 0.0)
+    , m_IndexParameters(nParameter, 0.0)
     , m_ParameterChanged(nParameter, true)
+    , m_Slots(nParameter)
+    , m_IdentityLayout(true)
+    , m_Invalidated(false)
     , m_NParameter(nParameter)
     , m_Options(std::move(options))
-    , m_RawParameter(nullptr)
-    , m_TransformFn(transform_fn) {}
+    , m_RawParameter(nullptr) {
+    std::iota(m_Slots.begin(), m_Slots.end(), 0);
+  }
+
+  void ParameterWrapper::set_layout(const params::ParameterRegistry& registry) {
+    if (!registry.finalized()) {
+      throw std::invalid_argument("The parameter layout is not finalized");
+    }
+    if (static_cast<std::size_t>(registry.size()) != m_NParameter) {
+      throw std::invalid_argument("The parameter layout has " + std::to_string(registry.size()) + " parameters instead of " + std::to_string(m_NParameter));
+    }
+
+    // Move the stored parameters into the new layout, so the change detection of the next call still works
+    auto permute = [this, &registry](auto& values) {
+      auto result = values;
+      for (std::size_t i = 0; i < m_NParameter; ++i) {
+        result[registry.slot(static_cast<int>(i))] = values[m_Slots[i]];
+      }
+      values = std::move(result);
+    };
+    permute(m_CurrentParameters);
+    permute(m_PreviousParameters);
+    permute(m_ParameterChanged);
+
+    m_Slots          = registry.slots();
+    m_IdentityLayout = true;
+    for (std::size_t i = 0; i < m_NParameter; ++i) {
+      m_IdentityLayout &= m_Slots[i] == static_cast<int>(i);
+    }
+  }
 
   void ParameterWrapper::reset_parameter(const double* parameter) {
     // Set the raw parameter pointer to the new parameter array
@@ -22,24 +54,42 @@ namespace ana::dc {
     // Swap the current parameters with the previous parameters
     std::swap(m_CurrentParameters, m_PreviousParameters);
 
-    // Copy the new parameter values into the current parameters array
-    std::copy_n(parameter, m_NParameter, m_CurrentParameters.begin());
+    if (m_IdentityLayout) {
+      // Copy the new parameter values into the current parameters array
+      std::copy_n(parameter, m_NParameter, m_CurrentParameters.begin());
 
-    if (m_TransformFn) {
-      m_TransformFn(*m_Options, m_CurrentParameters);
+      if (m_Transform) {
+        (*m_Transform)(m_CurrentParameters);
+      }
+    } else {
+      // The transformation works on the order of params::index, afterwards the values are scattered into the layout
+      std::copy_n(parameter, m_NParameter, m_IndexParameters.begin());
+
+      if (m_Transform) {
+        (*m_Transform)(m_IndexParameters);
+      }
+
+      for (std::size_t i = 0; i < m_NParameter; ++i) {
+        m_CurrentParameters[m_Slots[i]] = m_IndexParameters[i];
+      }
     }
 
     // Update the parameter changed status for each parameter
     for (std::size_t i = 0; i < m_NParameter; ++i) {
       m_ParameterChanged[i] = static_cast<char>(utilities::fuzzyCompare(m_CurrentParameters[i], m_PreviousParameters[i]));
     }
+
+    if (m_Invalidated) {
+      std::ranges::fill(m_ParameterChanged, char{0});
+      m_Invalidated = false;
+    }
   }
 
   bool ParameterWrapper::check_parameter_changed(const int idx) const {
     if (idx < 0 || idx >= m_NParameter) {
       throw std::out_of_range("Parameter index out of range");
     }
-    const bool same = static_cast<bool>(m_ParameterChanged[idx]);
+    const bool same = static_cast<bool>(m_ParameterChanged[m_Slots[idx]]);
     return !same;
   }
 
@@ -52,9 +102,21 @@ namespace ana::dc {
       throw std::invalid_argument("Invalid range");
     }
 
-    const auto same_count = std::accumulate(m_ParameterChanged.begin() + from, m_ParameterChanged.begin() + (to + 1), 0);
+    assert(is_contiguous(from, to));
+
+    const auto first      = m_ParameterChanged.begin() + m_Slots[from];
+    const auto same_count = std::accumulate(first, first + (to - from + 1), 0);
     const bool same       = same_count == (to - from + 1);
     return !same;
   }
 
+  bool ParameterWrapper::is_contiguous(const int first, const int last) const noexcept {
+    for (int idx = first; idx < last; ++idx) {
+      if (m_Slots[idx + 1] != m_Slots[idx] + 1) {
+        return false;
+      }
+    }
+    return true;
+  }
+
 }  // namespace ana::dc
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "Options.h"
+#include "ParameterRegistry.h"
+#include "ParameterTransform.h"
 
 // STL includes
+#include <cassert>
+#include <memory>
 #include <span>
 #include <vector>
 
@@ -13,25 +17,46 @@ namespace ana::dc {  // TODO move class to ana namespace
    *
    * The ParameterWrapper class provides a convenient way to access and manipulate a parameter array.
    * It wraps a raw double pointer and provides various member functions for accessing the parameters.
+   *
+   * The parameters are addressed with the indices of params::index. Internally they are stored in the layout of a
+   * params::ParameterRegistry, so that the parameters of a component are contiguous. Without a registry the layout
+   * is the one of params::index.
    */
   class ParameterWrapper {
-    using transform_fn_t = void (*)(const io::Options& options, std::span<double> parameter);
-
    public:
     /**
      * @brief Constructs a ParameterWrapper object.
      *
      * @param nParameter The number of parameters.
-     * @param transform_fn A function pointer to transform the parameters (default is nullptr).
      */
-    ParameterWrapper(std::size_t nParameter, std::shared_ptr<io::Options> options, transform_fn_t transform_fn = nullptr);
+    ParameterWrapper(std::size_t nParameter, std::shared_ptr<io::Options> options);
     /**
      * @brief Default destructor.
      */
     ~ParameterWrapper() = default;
 
     /**
-     * @brief Resets the parameter to the given values.
+     * @brief Stores the parameters in the layout of the registry from now on.
+     *
+     * @param registry The finalized layout of the parameters.
+     * @throws std::invalid_argument if the registry is not finalized or has a different number of parameters.
+     */
+    void set_layout(const params::ParameterRegistry& registry);
+
+    /**
+     * @brief Transforms the parameters with the given stage from the next reset on, nullptr removes the stage.
+     *
+     * The transformation works on the order of params::index, before the change detection.
+     */
+    void set_transform(std::unique_ptr<ParameterTransform> transform) noexcept { m_Transform = std::move(transform); }
+
+    /**
+     * @brief Reports every parameter as changed by the next reset, so all components recalculate their spectra.
+     */
+    void invalidate() noexcept { m_Invalidated = true; }
+
+    /**
+     * @brief Resets the parameter to the given values and applies the transformation.
      *
      * @param parameter A pointer to the new value of the parameters.
      */
@@ -43,12 +68,21 @@ namespace ana::dc {  // TODO move class to ana namespace
      * @param index The index of the parameter.
      * @return The value of the parameter.
      */
-    [[nodiscard]] double operator[](int index) const noexcept { return m_CurrentParameters[index]; }
+    [[nodiscard]] double operator[](int index) const noexcept { return m_CurrentParameters[m_Slots[index]]; }
 
+    /**
+     * @brief Returns the parameters [start, end), they have to belong to one block of a registered component.
+     */
     [[nodiscard]] std::span<const double> sub_range(int start, int end) const noexcept {
-      return std::span(m_CurrentParameters).subspan(start, end - start);
+      assert(is_contiguous(start, end - 1));
+      return std::span(m_CurrentParameters).subspan(m_Slots[start], end - start);
     }
 
+    /**
+     * @brief Returns the number of parameters.
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return m_NParameter; }
+
     /**
      * @brief Returns a span of the raw parameters.
      *
@@ -61,7 +95,7 @@ namespace ana::dc {  // TODO move class to ana namespace
     }
 
     /**
-     * @brief Returns an iterator to the beginning of the unified parameters.
+     * @brief Returns an iterator to the beginning of the unified parameters, they are in the order of the layout.
      *
      * @return An iterator to the beginning of the unified parameters.
      */
@@ -133,20 +167,24 @@ namespace ana::dc {  // TODO move class to ana namespace
      * This function compares the parameters in the specified range in the current parameter array
      * with the corresponding parameters in the previous parameter array.
      *
-     * @param from The starting index of the range.
+     * @param from The starting index of the range, the range has to belong to one block of a registered component.
      * @param to The ending index of the range.
      * @return True if any parameter in the range has changed, false otherwise.
      */
     [[nodiscard]] bool check_parameter_changed(int from, int to) const;
 
    private:
-    std::vector<double>          m_CurrentParameters;   // Unified parameters array
-    std::vector<double>          m_PreviousParameters;  // Previous parameter set for comparison
-    std::vector<char>            m_ParameterChanged;    // Array to store the changed parameters
-    std::size_t                  m_NParameter;          // Number of parameters
-    std::shared_ptr<io::Options> m_Options;             // Options object
-    const double*                m_RawParameter;        // Pointer to the raw parameter array
-    transform_fn_t               m_TransformFn;         // Function to transform the parameters
+    std::vector<double>                 m_CurrentParameters;   // Unified parameters array in the order of the layout
+    std::vector<double>                 m_PreviousParameters;  // Previous parameter set for comparison
+    std::vector<double>                 m_IndexParameters;     // Parameters in the order of params::index before the scatter
+    std::vector<char>                   m_ParameterChanged;    // Array to store the changed parameters
+    std::vector<int>                    m_Slots;               // Slot of every parameter in the layout
+    bool                                m_IdentityLayout;      // Whether the layout is the one of params::index
+    bool                                m_Invalidated;         // Whether the next reset reports all parameters as changed
+    std::size_t                         m_NParameter;          // Number of parameters
+    std::shared_ptr<io::Options>        m_Options;             // Options object
+    const double*                       m_RawParameter;        // Pointer to the raw parameter array
+    std::unique_ptr<ParameterTransform> m_Transform;           // Stage to transform the parameters
 
     /**
      * @brief Unifies the parameters.
@@ -154,6 +192,11 @@ namespace ana::dc {  // TODO move class to ana namespace
      * This function unifies the parameters
      */
     void unify_parameters();
+
+    /**
+     * @brief Checks whether the parameters first to last, both included, have consecutive slots.
+     */
+    [[nodiscard]] bool is_contiguous(int first, int last) const noexcept;
   };
 
 }  // namespace ana::dc
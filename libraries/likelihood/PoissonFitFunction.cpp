@@ -0,0 +1,92 @@
+#include "PoissonFitFunction.h"
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace ana {
+
+  namespace {
+    // Fraction of the parameter step size used for the forward differences
+    constexpr double derivative_step_fraction = 1.0e-4;
+  }  // namespace
+
+  PoissonFitFunction::PoissonFitFunction(std::shared_ptr<dc::DCLikelihood> likelihood, unsigned int nParameter)
+    : ROOT::Math::FitMethodFunction(static_cast<int>(nParameter), static_cast<int>(likelihood->number_of_residuals()))
+    , m_Likelihood(std::move(likelihood))
+    , m_Free(nParameter, true)
+    , m_Steps(nParameter, 1.0)
+    , m_Residuals(m_Likelihood->number_of_residuals(), 0.0)
+    , m_Shifted(m_Likelihood->number_of_residuals(), 0.0)
+    , m_HasJacobian(false) {}
+
+  void PoissonFitFunction::set_free_parameters(std::vector<bool> free, std::vector<double> steps) {
+    m_Free  = std::move(free);
+    m_Steps = std::move(steps);
+    m_X.clear();
+  }
+
+  void PoissonFitFunction::update(const double* x, const bool with_jacobian) const {
+    const std::size_t nPar = m_Free.size();
+    const std::size_t nRes = m_Residuals.size();
+
+    const bool same_point = !m_X.empty() && std::equal(m_X.begin(), m_X.end(), x);
+
+    if (!same_point) {
+      m_X.assign(x, x + nPar);
+      m_Likelihood->calculate_residuals(m_X.data(), m_Residuals);
+      m_HasJacobian = false;
+
+      if (m_Observer) {
+        m_Observer(m_X.data(), std::inner_product(m_Residuals.begin(), m_Residuals.end(), m_Residuals.begin(), 0.0));
+      }
+    }
+
+    if (!with_jacobian || m_HasJacobian) {
+      return;
+    }
+
+    m_Jacobian.assign(nRes * nPar, 0.0);
+
+    // The shifted copy is kept alive during the calculation, as the likelihood keeps a pointer to it
+    std::vector<double> shifted = m_X;
+    for (std::size_t j = 0; j < nPar; ++j) {
+      if (!m_Free[j]) {
+        continue;
+      }
+
+      const double h = std::max(derivative_step_fraction * m_Steps[j], 1.0e-8 * std::max(std::abs(m_X[j]), 1.0));
+
+      shifted[j] = m_X[j] + h;
+      m_Likelihood->calculate_residuals(shifted.data(), m_Shifted);
+      shifted[j] = m_X[j];
+
+      for (std::size_t i = 0; i < nRes; ++i) {
+        m_Jacobian[i * nPar + j] = (m_Shifted[i] - m_Residuals[i]) / h;
+      }
+    }
+
+    // Leave the likelihood components in the state of the cached point
+    m_Likelihood->calculate_residuals(m_X.data(), m_Shifted);
+
+    m_HasJacobian = true;
+  }
+
+  double PoissonFitFunction::DataElement(const double* x, unsigned int i, double* g, double* h, bool fullHessian) const {
+    update(x, g != nullptr);
+
+    if (g != nullptr) {
+      const std::size_t nPar = m_Free.size();
+      std::copy_n(m_Jacobian.begin() + static_cast<std::ptrdiff_t>(i * nPar), nPar, g);
+    }
+
+    return m_Residuals[i];
+  }
+
+  double PoissonFitFunction::DoEval(const double* x) const {
+    update(x, false);
+    return std::inner_product(m_Residuals.begin(), m_Residuals.end(), m_Residuals.begin(), 0.0);
+  }
+
+}  // namespace ana
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "DoubleChooz/DCLikelihood.h"
+
+// STL includes
+#include <functional>
+#include <memory>
+#include <vector>
+
+// ROOT includes
+#include <Math/FitMethodFunction.h>
+
+namespace ana {
+
+  /**
+   * @class PoissonFitFunction
+   * @brief Exposes the Double Chooz likelihood as a sum of squared residuals for the Minuit2 Fumili minimizer.
+   *
+   * Fumili approximates the Hessian from the Jacobian of the residuals instead of building it from successive
+   * gradients, which exploits the binned Poisson structure of the likelihood. The Jacobian is calculated with
+   * forward differences in the free parameters only and cached for the last evaluated parameter point, as
+   * Fumili requests the residuals one by one.
+   */
+  class PoissonFitFunction : public ROOT::Math::FitMethodFunction {
+   public:
+    /// Called with the parameters and the sum of the squared residuals of every point requested by the minimizer.
+    using observer_t = std::function<void(const double*, double)>;
+
+    /**
+     * @brief Constructs the fit function.
+     *
+     * @param likelihood The likelihood providing the residuals.
+     * @param nParameter The number of parameters.
+     */
+    PoissonFitFunction(std::shared_ptr<dc::DCLikelihood> likelihood, unsigned int nParameter);
+
+    ~PoissonFitFunction() override = default;
+
+    [[nodiscard]] Type_t Type() const override { return kLeastSquare; }
+
+    [[nodiscard]] ROOT::Math::IMultiGenFunction* Clone() const override { return new PoissonFitFunction(*this); }
+
+    /**
+     * @brief Returns the residual with index i and, if requested, its gradient.
+     */
+    double DataElement(const double* x, unsigned int i, double* g = nullptr, double* h = nullptr, bool fullHessian = false) const override;
+
+    /**
+     * @brief Sets the parameters the Jacobian is calculated for and their step sizes.
+     *
+     * @param free Flags for the parameters which are free in the minimization.
+     * @param steps The step sizes of the parameters, the differentiation step is a small fraction of them.
+     */
+    void set_free_parameters(std::vector<bool> free, std::vector<double> steps);
+
+    /**
+     * @brief Sets the observer of the evaluated points, e.g. for the checkpoint of the fit.
+     *
+     * The shifted points of the Jacobian are not reported. The sum of the squared residuals differs from the
+     * likelihood by a constant, so it orders the points like the likelihood.
+     */
+    void set_observer(observer_t observer) { m_Observer = std::move(observer); }
+
+   private:
+    [[nodiscard]] double DoEval(const double* x) const override;
+
+    /**
+     * @brief Recalculates the cached residuals, and the Jacobian if requested, if the parameters changed.
+     */
+    void update(const double* x, bool with_jacobian) const;
+
+    std::shared_ptr<dc::DCLikelihood> m_Likelihood;  ///< The likelihood providing the residuals.
+
+    std::vector<bool>   m_Free;   ///< Flags for the free parameters.
+    std::vector<double> m_Steps;  ///< The differentiation step sizes.
+
+    observer_t m_Observer;  ///< The observer of the evaluated points, if set.
+
+    mutable std::vector<double> m_X;             ///< The parameters of the cached residuals.
+    mutable std::vector<double> m_Residuals;     ///< The cached residuals.
+    mutable std::vector<double> m_Jacobian;      ///< The cached row-major Jacobian, one row per residual.
+    mutable std::vector<double> m_Shifted;       ///< Workspace for the residuals of a shifted parameter.
+    mutable bool                m_HasJacobian;   ///< Whether the Jacobian belongs to the cached parameters.
+  };
+
+}  // namespace ana
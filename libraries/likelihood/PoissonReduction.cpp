@@ -0,0 +1,61 @@
+#include "PoissonReduction.h"
+
+// STL includes
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace ana {
+
+  PoissonReduction::PoissonReduction(std::span<const double> data)
+    : m_Data(data.begin(), data.end())
+    , m_Saturated(data.size(), 0.0) {
+    for (std::size_t i = 0; i < m_Data.size(); ++i) {
+      const double n = m_Data[i];
+      if (!std::isfinite(n) || n < 0.0) {
+        throw std::invalid_argument("The measured count of bin " + std::to_string(i) + " is not a finite, non-negative number");
+      }
+
+      // The limit of n * log(n) for n -> 0 is 0
+      m_Saturated[i] = (n > 0.0 ? n * std::log(n) : 0.0) - n;
+      m_SaturatedSum += m_Saturated[i];
+    }
+  }
+
+  double PoissonReduction::operator()(std::span<const double> prediction) const noexcept {
+    const double* n   = m_Data.data();
+    const double* sat = m_Saturated.data();
+    const double* mu  = prediction.data();
+
+    const std::size_t N = m_Data.size();
+
+    constexpr auto min_high = static_cast<std::int32_t>(std::bit_cast<std::uint64_t>(std::numeric_limits<double>::min()) >> 32);
+    constexpr auto inf_high = static_cast<std::int32_t>(std::bit_cast<std::uint64_t>(std::numeric_limits<double>::infinity()) >> 32);
+    constexpr auto one_bits = std::bit_cast<std::uint64_t>(1.0);
+
+    double result  = 0.0;
+    double invalid = 0.0;  // A double counter keeps all lanes of the loop the same width
+
+    #pragma omp simd reduction(+ : result, invalid)
+    for (std::size_t i = 0; i < N; ++i) {
+      // simd_log is only defined for positive, finite and normal numbers, which are the ones whose upper word lies
+      // between the ones of the smallest normal number and infinity. The others are replaced by 1 and invalidate the
+      // result. The check uses integer operations, floating point comparisons might raise an exception and are
+      // therefore not vectorized.
+      const auto          bits = std::bit_cast<std::uint64_t>(mu[i]);
+      const auto          high = static_cast<std::int32_t>(bits >> 32);
+      const std::int32_t  bad  = (high < min_high) | (high >= inf_high);
+      const std::uint64_t mask = -static_cast<std::uint64_t>(bad);
+      invalid += static_cast<double>(bad);
+
+      const double log_mu = simd_log(std::bit_cast<double>(bits ^ ((bits ^ one_bits) & mask)));
+      result += n[i] * log_mu - mu[i] - sat[i];
+    }
+
+    return (invalid > 0.0) ? std::numeric_limits<double>::quiet_NaN() : -2.0 * result;
+  }
+
+}  // namespace ana
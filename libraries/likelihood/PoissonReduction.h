@@ -0,0 +1,94 @@
+#pragma once
+
+// STL includes
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace ana {
+
+  /**
+   * @brief Returns the natural logarithm of a positive, finite and normal double.
+   *
+   * The algorithm of the fdlibm log, with an error below 1 ulp: x = 2^k * (1 + f) with 1 + f in [sqrt(2)/2, sqrt(2)),
+   * log(1 + f) = 2 atanh(s) with s = f / (2 + f) is approximated by a polynomial in s^2. The exponent and the mantissa
+   * are split with integer operations instead of branches, so the function is vectorized with the loop it is used
+   * in. The result is undefined for other arguments, which have to be handled by the caller.
+   */
+  #pragma omp declare simd
+  inline double simd_log(double x) noexcept {
+    constexpr double ln2_hi = 6.93147180369123816490e-01;
+    constexpr double ln2_lo = 1.90821492927058770002e-10;
+    constexpr double Lg1    = 6.666666666666735130e-01;
+    constexpr double Lg2    = 3.999999999940941908e-01;
+    constexpr double Lg3    = 2.857142874366239149e-01;
+    constexpr double Lg4    = 2.222219843214978396e-01;
+    constexpr double Lg5    = 1.818357216161805012e-01;
+    constexpr double Lg6    = 1.531383769920937332e-01;
+    constexpr double Lg7    = 1.479819860511658591e-01;
+
+    // Shift the exponent, so the mantissa is reduced into [sqrt(2)/2, sqrt(2))
+    const auto          bits = std::bit_cast<std::uint64_t>(x);
+    const std::uint64_t hx   = (bits >> 32) + (0x3ff00000 - 0x3fe6a09e);
+    const auto          k    = static_cast<double>(static_cast<std::int32_t>(hx >> 20) - 0x3ff);
+    const std::uint64_t hm   = (hx & 0x000fffff) + 0x3fe6a09e;
+    const double        f    = std::bit_cast<double>((hm << 32) | (bits & 0xffffffff)) - 1.0;
+
+    const double hfsq = 0.5 * f * f;
+    const double s    = f / (2.0 + f);
+    const double z    = s * s;
+    const double w    = z * z;
+    const double t1   = w * (Lg2 + w * (Lg4 + w * Lg6));
+    const double t2   = z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7)));
+    const double R    = t2 + t1;
+
+    return s * (hfsq + R) + k * ln2_lo - hfsq + f + k * ln2_hi;
+  }
+
+  /**
+   * @class PoissonReduction
+   * @brief The Poisson likelihood of binned counts, reduced over the concatenated bins of all data sets in one pass.
+   *
+   * The likelihood is the deviance -2 * sum(n * log(mu) - mu - (n * log(n) - n)). The saturated term
+   * n * log(n) - n only depends on the data, so it is calculated once and subtracted in every bin. The summed terms
+   * are then small, which keeps the sum well-conditioned, and the minimum is the same as the one of
+   * -2 * sum(n * log(mu) - mu).
+   */
+  class PoissonReduction {
+   public:
+    PoissonReduction() = default;
+
+    /**
+     * @brief Constructs the reduction for the measured counts.
+     *
+     * @param data The measured counts of all bins, they must not be negative.
+     * @throws std::invalid_argument if a count is negative or not finite.
+     */
+    explicit PoissonReduction(std::span<const double> data);
+
+    /**
+     * @brief Returns the number of bins.
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return m_Data.size(); }
+
+    /**
+     * @brief Returns the sum of the saturated terms n * log(n) - n of all bins.
+     */
+    [[nodiscard]] double saturated() const noexcept { return m_SaturatedSum; }
+
+    /**
+     * @brief Calculates the deviance of the predicted counts.
+     *
+     * @param prediction The predicted counts of all bins, in the order of the data.
+     * @return The deviance, NaN if a prediction is not positive, finite and normal.
+     */
+    [[nodiscard]] double operator()(std::span<const double> prediction) const noexcept;
+
+   private:
+    std::vector<double> m_Data;              ///< The measured counts.
+    std::vector<double> m_Saturated;         ///< The saturated term n * log(n) - n of every bin.
+    double              m_SaturatedSum = 0;  ///< The sum of the saturated terms.
+  };
+
+}  // namespace ana
@@ -4,21 +4,29 @@
 #include "Definitions.h"
 #include "ParameterWrapper.h"
 #include "../io/Options.h"
+#include "../utilities/Profiling.h"
+#include "../utilities/Timeline.h"
 
 // STL includes
 #include <span>
+#include <vector>
 
 /**
  * @brief The BackgroundBase class is a base class for background models in the ana namespace.
  *
  * It provides a common interface for derived classes to implement background models.
  *
- * @tparam Derived The derived class type.
+ * @tparam BinningPolicy The binning policy of the spectra, e.g. DCBinning.
  */
 namespace ana::dc { // TODO move class to ana namespace
 
-  class SpectrumBase {
+  template <typename BinningPolicy>
+  class BasicSpectrumBase {
    public:
+    using binning_t          = BinningPolicy;                               ///< The binning policy of the spectra.
+    using spectrum_t         = typename BinningPolicy::spectrum_t;          ///< A background or energy corrected spectrum.
+    using reactor_spectrum_t = typename BinningPolicy::reactor_spectrum_t;  ///< An oscillated reactor spectrum.
+
     /**
      * @class SpectrumBase
      * @brief Base class for spectrum calculations.
@@ -27,14 +35,15 @@ namespace ana::dc { // TODO move class to ana namespace
      * It is intended to be inherited by specific spectrum classes that implement the actual calculations.
      * The class takes an options object as a parameter in its constructor.
      */
-    explicit SpectrumBase(std::shared_ptr<io::Options> options)
-      : m_Options(std::move(options)) {
+    explicit BasicSpectrumBase(std::shared_ptr<io::Options> options, std::string name)
+      : m_Options(std::move(options))
+      , m_Profile(std::move(name)) {
     }
 
     /**
      * @brief Destructor for the BackgroundBase class.
      */
-    virtual ~SpectrumBase() = default;
+    virtual ~BasicSpectrumBase() = default;
 
     /**
      * @brief Get the options object.
@@ -66,8 +75,48 @@ namespace ana::dc { // TODO move class to ana namespace
      */
     [[nodiscard]] virtual std::span<const double> get_spectrum(params::dc::DetectorType type) const = 0;
 
+    /**
+     * @brief Get the timing counters of this component.
+     *
+     * The counters of a component only cover its own calculation, not the one of previous calculation steps.
+     */
+    [[nodiscard]] const utilities::ComponentProfile& profile() const noexcept { return m_Profile; }
+
+    /**
+     * @brief Collects the timing counters of this component and of all components it owns.
+     *
+     * @param profiles The vector the counters are appended to.
+     */
+    virtual void collect_profiles(std::vector<utilities::ComponentProfile*>& profiles) { profiles.push_back(&m_Profile); }
+
+    /**
+     * @brief Registers the parameters this component reads, so they are contiguous in the parameter layout.
+     *
+     * A component without parameters does not have to override this function.
+     *
+     * @param registry The parameter layout of the likelihood.
+     */
+    virtual void register_parameters(params::ParameterRegistry& registry) const {}
+
+    /**
+     * @brief Enables the derivatives of the spectra with respect to the shape parameters.
+     *
+     * Only the analytic profiling of the nuisance parameters reads them, so a component without shape parameters
+     * ignores the flag and the others skip them unless it is set.
+     */
+    void compute_shape_response(bool enabled) noexcept { m_ComputeShapeResponse = enabled; }
+
    protected:
     std::shared_ptr<io::Options> m_Options;
+
+    utilities::ComponentProfile m_Profile;  ///< The timing counters of this component.
+
+    bool m_ComputeShapeResponse = false;  ///< Whether the derivatives with respect to the shape parameters are calculated.
   };
 
+  /**
+   * @brief The base class of all spectrum components of the analysis binning.
+   */
+  using SpectrumBase = BasicSpectrumBase<Binning>;
+
 }  // namespace ana::dc
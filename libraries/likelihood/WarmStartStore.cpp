@@ -0,0 +1,156 @@
+#include "WarmStartStore.h"
+
+// STL includes
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// boost includes
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+namespace ana {
+
+  namespace {
+    constexpr std::array<char, 8> warm_start_magic   = {'P', 'L', 'N', 'O', 'W', 'A', 'R', 'M'};
+    constexpr std::uint32_t       warm_start_version = 1;
+
+    /**
+     * @brief 64-bit FNV-1a hash, which is stable across compilers and runs unlike std::hash.
+     */
+    class Hasher {
+     public:
+      void add(std::string_view data) noexcept {
+        for (const char c : data) {
+          m_Hash ^= static_cast<unsigned char>(c);
+          m_Hash *= 1099511628211ULL;
+        }
+        // Separate consecutive entries, so "ab" + "c" and "a" + "bc" differ
+        m_Hash ^= 0xFFU;
+        m_Hash *= 1099511628211ULL;
+      }
+
+      void add(std::uint64_t value) noexcept { add(std::to_string(value)); }
+
+      [[nodiscard]] std::uint64_t value() const noexcept { return m_Hash; }
+
+     private:
+      std::uint64_t m_Hash = 14695981039346656037ULL;
+    };
+
+    /**
+     * @brief Adds the size and modification time of every file referenced in the tree to the hash.
+     */
+    void add_input_files(Hasher& hasher, const boost::property_tree::ptree& tree) {
+      for (const auto& [name, child] : tree) {
+        if (!child.empty()) {
+          add_input_files(hasher, child);
+          continue;
+        }
+
+        const auto& value = child.data();
+
+        boost::system::error_code ec;
+        if (value.empty() || !boost::filesystem::is_regular_file(value, ec)) {
+          continue;
+        }
+
+        hasher.add(value);
+        hasher.add(static_cast<std::uint64_t>(boost::filesystem::file_size(value, ec)));
+        hasher.add(static_cast<std::uint64_t>(boost::filesystem::last_write_time(value, ec)));
+      }
+    }
+  }  // namespace
+
+  WarmStartStore::WarmStartStore(std::string directory, const io::InputOptions& options)
+    : m_Directory(std::move(directory))
+    , m_Key(hash_configuration(options)) {}
+
+  std::string WarmStartStore::path() const {
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << m_Key << ".state";
+    return (boost::filesystem::path(m_Directory) / ss.str()).string();
+  }
+
+  std::optional<FitState> WarmStartStore::load() const {
+    const std::string file_path = path();
+
+    std::ifstream file(file_path, std::ios::binary);
+    if (!file) {
+      return std::nullopt;
+    }
+
+    try {
+      std::array<char, 8> magic{};
+      file.read(magic.data(), magic.size());
+
+      std::uint32_t version = 0;
+      file.read(reinterpret_cast<char*>(&version), sizeof(version));
+
+      if (!file || magic != warm_start_magic || version != warm_start_version) {
+        std::cout << "Ignoring invalid warm-start entry " << file_path << '\n';
+        return std::nullopt;
+      }
+
+      return read_fit_state(file);
+    } catch (const std::exception& e) {
+      std::cout << "Ignoring invalid warm-start entry " << file_path << ": " << e.what() << '\n';
+      return std::nullopt;
+    }
+  }
+
+  void WarmStartStore::store(const FitState& state) const {
+    boost::filesystem::create_directories(m_Directory);
+
+    const std::string file_path = path();
+    const std::string tmp_path  = file_path + ".tmp";
+    {
+      std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+      if (!file) {
+        throw std::runtime_error("Could not write warm-start entry " + tmp_path);
+      }
+
+      file.write(warm_start_magic.data(), warm_start_magic.size());
+      file.write(reinterpret_cast<const char*>(&warm_start_version), sizeof(warm_start_version));
+
+      write_fit_state(file, state);
+    }
+
+    // Concurrent fits of the same configuration may race here, the rename keeps the entry consistent
+    boost::filesystem::rename(tmp_path, file_path);
+  }
+
+  std::uint64_t WarmStartStore::hash_configuration(const io::InputOptions& options) {
+    namespace pt = boost::property_tree;
+
+    // Reduce the Parameter block to the parameter names, as only the layout of the parameters matters
+    pt::ptree config = options.config_tree();
+    if (auto parameters = config.get_child_optional("Parameter")) {
+      for (auto& [name, parameter] : *parameters) {
+        pt::ptree reduced;
+        reduced.put("Name", parameter.get<std::string>("Name", name));
+        parameter = reduced;
+      }
+    }
+
+    std::stringstream ss;
+    pt::write_json(ss, config, false);
+
+    Hasher hasher;
+    hasher.add(ss.str());
+
+    const auto& dc = options.double_chooz();
+    hasher.add(std::string_view(dc.use_data() ? "useData" : "fakeData"));
+    hasher.add(std::string_view(dc.use_sterile() ? "sterile" : "threeFlavor"));
+    hasher.add(std::string_view(dc.reactor_split() ? "reactorSplit" : "noReactorSplit"));
+    hasher.add(std::string_view(dc.fake_bump() ? "fakeBump" : "noFakeBump"));
+    hasher.add(std::string_view(options.experiments()));
+
+    add_input_files(hasher, options.config_tree());
+
+    return hasher.value();
+  }
+
+}  // namespace ana
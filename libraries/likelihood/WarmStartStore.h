@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Checkpoint.h"
+#include "InputOptions.h"
+
+// STL includes
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace ana {
+
+  /**
+   * @class WarmStartStore
+   * @brief Local store of best-fit points, used to seed the minimizer of repeated fits of similar configurations.
+   *
+   * Every entry is a file "<directory>/<key>.state" holding the best-fit point and covariance matrix of the last
+   * finished fit with the same key. The key is a hash of the configuration tree, the relevant command line
+   * switches and the size and modification time of all input files referenced in the configuration. Start
+   * values, uncertainties and fixing flags of the Parameter block do not enter the key, so refits after
+   * changing them start from the previous minimum.
+   */
+  class WarmStartStore {
+   public:
+    /**
+     * @brief Constructs a warm-start store for the given configuration.
+     *
+     * @param directory The directory of the store. It is created on the first write.
+     * @param options The input options the key is calculated from.
+     */
+    WarmStartStore(std::string directory, const io::InputOptions& options);
+
+    ~WarmStartStore() = default;
+
+    [[nodiscard]] std::uint64_t key() const noexcept { return m_Key; }
+
+    /**
+     * @brief Returns the path of the store entry of this configuration.
+     */
+    [[nodiscard]] std::string path() const;
+
+    /**
+     * @brief Reads the stored fit state of this configuration.
+     *
+     * @return The stored fit state, or std::nullopt if there is no usable entry.
+     */
+    [[nodiscard]] std::optional<FitState> load() const;
+
+    /**
+     * @brief Writes the fit state as entry of this configuration, replacing a previous one.
+     */
+    void store(const FitState& state) const;
+
+    /**
+     * @brief Calculates the store key of the given input options.
+     */
+    [[nodiscard]] static std::uint64_t hash_configuration(const io::InputOptions& options);
+
+   private:
+    std::string   m_Directory;  ///< The directory of the store.
+    std::uint64_t m_Key;        ///< The key of the configuration.
+  };
+
+}  // namespace ana
@@ -0,0 +1,411 @@
+#include "ResultFile.h"
+
+// STL includes
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace result {
+
+  namespace {
+    constexpr std::array<char, 8> result_magic   = {'P', 'L', 'N', 'O', 'R', 'S', 'L', 'T'};
+    constexpr std::uint32_t       result_version = 1;
+
+    // The number of submitted blocks after which append() waits for the background thread
+    constexpr std::size_t max_pending_blocks = 4;
+
+    template <typename T>
+    void write_value(std::ostream& os, const T& value) {
+      os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void write_array(std::ostream& os, const std::vector<T>& values) {
+      os.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+
+    void write_names(std::ostream& os, const std::vector<std::string>& names) {
+      write_value(os, static_cast<std::uint64_t>(names.size()));
+      for (const auto& name : names) {
+        write_value(os, static_cast<std::uint64_t>(name.size()));
+        os.write(name.data(), static_cast<std::streamsize>(name.size()));
+      }
+    }
+
+    template <typename T>
+    T read_value(std::istream& is) {
+      T value{};
+      is.read(reinterpret_cast<char*>(&value), sizeof(T));
+      if (!is) {
+        throw std::runtime_error("Unexpected end of result file");
+      }
+      return value;
+    }
+
+    template <typename T>
+    void read_array(std::istream& is, std::vector<T>& values, std::size_t n) {
+      const auto offset = values.size();
+      values.resize(offset + n);
+      is.read(reinterpret_cast<char*>(values.data() + offset), static_cast<std::streamsize>(n * sizeof(T)));
+      if (!is) {
+        throw std::runtime_error("Unexpected end of result file");
+      }
+    }
+
+    std::vector<std::string> read_names(std::istream& is) {
+      std::vector<std::string> names(read_value<std::uint64_t>(is));
+      for (auto& name : names) {
+        name.resize(read_value<std::uint64_t>(is));
+        is.read(name.data(), static_cast<std::streamsize>(name.size()));
+      }
+      return names;
+    }
+
+    /**
+     * @brief The header of a result file.
+     */
+    struct ResultFileHeader {
+      std::vector<std::string> parameter_names;
+      std::vector<std::string> spectrum_names;
+      std::uint64_t            n_bins = 0;
+    };
+
+    ResultFileHeader read_header(std::istream& is, const std::string& path) {
+      std::array<char, 8> magic{};
+      is.read(magic.data(), magic.size());
+      if (!is || magic != result_magic) {
+        throw std::runtime_error(path + " is not a result file");
+      }
+
+      if (const auto version = read_value<std::uint32_t>(is); version != result_version) {
+        throw std::runtime_error("Unsupported result file version " + std::to_string(version) + " in " + path);
+      }
+
+      ResultFileHeader header;
+      header.parameter_names = read_names(is);
+      header.spectrum_names  = read_names(is);
+      header.n_bins          = read_value<std::uint64_t>(is);
+
+      is.seekg((static_cast<std::streamoff>(is.tellg()) + 7) / 8 * 8);
+      return header;
+    }
+
+    ResultFileHeader read_header(const std::string& path) {
+      std::ifstream file(path, std::ios::binary);
+      if (!file) {
+        throw std::runtime_error("Could not open result file " + path);
+      }
+      return read_header(file, path);
+    }
+
+    // The integer columns of a block are padded, so the following double columns stay aligned
+    constexpr std::size_t padded_int_column(std::size_t n) { return (n + 1) / 2 * 2; }
+
+    std::uint64_t block_bytes(std::size_t n, std::size_t n_parameters, std::size_t n_spectra, std::size_t n_bins) {
+      return sizeof(double) * n * (3 + 2 * n_parameters + n_spectra * n_bins) + 2 * sizeof(std::int32_t) * padded_int_column(n);
+    }
+
+    /**
+     * @brief Returns the size of a result file up to the end of its last complete block.
+     *
+     * The stream has to be positioned behind the header. A block whose header does not match its layout or which
+     * ends behind the end of the file, e.g. as the writing job was interrupted, and all following data is not counted.
+     */
+    std::uint64_t complete_size(std::istream& is, const ResultFileHeader& header, const std::uint64_t file_size) {
+      constexpr std::uint64_t block_header_bytes = 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t);
+
+      auto end = static_cast<std::uint64_t>(is.tellg());
+      while (end + block_header_bytes <= file_size) {
+        is.seekg(static_cast<std::streamoff>(end));
+        const std::size_t n = read_value<std::uint32_t>(is);
+        read_value<std::uint32_t>(is);
+        const auto bytes = read_value<std::uint64_t>(is);
+
+        if (bytes != block_bytes(n, header.parameter_names.size(), header.spectrum_names.size(), header.n_bins) ||
+            end + block_header_bytes + bytes > file_size) {
+          break;
+        }
+        end += block_header_bytes + bytes;
+      }
+      return end;
+    }
+  }  // namespace
+
+  ResultFileWriter::ResultFileWriter(const std::string&              path,
+                                     const std::vector<std::string>& parameter_names,
+                                     const std::vector<std::string>& spectrum_names,
+                                     const std::size_t               n_bins,
+                                     const bool                      append,
+                                     const std::size_t               block_size)
+    : m_NParameters(parameter_names.size())
+    , m_NSpectra(spectrum_names.size())
+    , m_NBins(n_bins)
+    , m_BlockSize(std::max<std::size_t>(block_size, 1))
+    , m_NRecords(0)
+    , m_Closed(false)
+    , m_Writing(false) {
+    if (append && std::filesystem::exists(path) && std::filesystem::file_size(path) > 0) {
+      const std::uint64_t file_size = std::filesystem::file_size(path);
+
+      // Only the header is compared, the blocks are appended after the last complete one
+      std::uint64_t size = 0;
+      {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+          throw std::runtime_error("Could not open result file " + path);
+        }
+
+        const ResultFileHeader header = read_header(file, path);
+        if (header.parameter_names != parameter_names || header.spectrum_names != spectrum_names || header.n_bins != n_bins) {
+          throw std::runtime_error("The layout of the result file " + path + " does not match the fit");
+        }
+        size = complete_size(file, header, file_size);
+      }
+
+      // A partially written block would corrupt all blocks appended after it
+      if (size < file_size) {
+        std::cerr << "Removing " << file_size - size << " bytes of an incomplete block from the result file " << path << '\n';
+        std::filesystem::resize_file(path, size);
+      }
+      m_File.open(path, std::ios::binary | std::ios::app);
+    } else {
+      m_File.open(path, std::ios::binary | std::ios::trunc);
+
+      m_File.write(result_magic.data(), result_magic.size());
+      write_value(m_File, result_version);
+      write_names(m_File, parameter_names);
+      write_names(m_File, spectrum_names);
+      write_value(m_File, static_cast<std::uint64_t>(n_bins));
+
+      // The blocks start at a multiple of 8 bytes
+      const auto header_size = static_cast<std::size_t>(m_File.tellp());
+      for (std::size_t i = header_size; i % 8 != 0; ++i) {
+        m_File.put('\0');
+      }
+    }
+
+    if (!m_File) {
+      throw std::runtime_error("Could not create result file " + path);
+    }
+
+    m_Current.reserve(m_BlockSize);
+    m_Thread = std::thread(&ResultFileWriter::write_loop, this);
+  }
+
+  ResultFileWriter::~ResultFileWriter() {
+    try {
+      close();
+    } catch (const std::exception& e) {
+      std::cerr << "Error while writing the result file: " << e.what() << '\n';
+    }
+  }
+
+  void ResultFileWriter::append(ResultRecord record) {
+    if (m_Closed) {
+      throw std::logic_error("Appending to the closed result file");
+    }
+    if (record.parameters.size() != m_NParameters || record.errors.size() != m_NParameters) {
+      throw std::invalid_argument("The number of parameters of the record does not match the result file");
+    }
+    if (record.spectra.size() != m_NSpectra * m_NBins) {
+      throw std::invalid_argument("The spectra of the record do not match the result file");
+    }
+
+    m_Current.push_back(std::move(record));
+    ++m_NRecords;
+
+    if (m_Current.size() == m_BlockSize) {
+      submit_block();
+    }
+  }
+
+  void ResultFileWriter::flush() {
+    if (m_Closed) {
+      throw std::logic_error("Flushing the closed result file");
+    }
+
+    if (!m_Current.empty()) {
+      submit_block();
+    }
+
+    std::unique_lock lock(m_Mutex);
+    m_Condition.wait(lock, [this] { return (m_Queue.empty() && !m_Writing) || m_Error; });
+    if (m_Error) {
+      throw std::runtime_error("The result file could not be written");
+    }
+  }
+
+  void ResultFileWriter::close() {
+    if (m_Thread.joinable()) {
+      if (!m_Current.empty()) {
+        submit_block();
+      }
+      {
+        std::lock_guard lock(m_Mutex);
+        m_Closed = true;
+      }
+      m_Condition.notify_all();
+      m_Thread.join();
+      m_File.close();
+    }
+
+    if (m_Error) {
+      std::rethrow_exception(std::exchange(m_Error, nullptr));
+    }
+  }
+
+  void ResultFileWriter::submit_block() {
+    std::unique_lock lock(m_Mutex);
+    m_Condition.wait(lock, [this] { return m_Queue.size() < max_pending_blocks || m_Error; });
+    if (m_Error) {
+      m_Current.clear();
+      throw std::runtime_error("The result file could not be written");
+    }
+
+    m_Queue.push_back(std::move(m_Current));
+    lock.unlock();
+    m_Condition.notify_all();
+
+    m_Current = block_t{};
+    m_Current.reserve(m_BlockSize);
+  }
+
+  void ResultFileWriter::write_loop() {
+    std::unique_lock lock(m_Mutex);
+    while (true) {
+      m_Condition.wait(lock, [this] { return !m_Queue.empty() || m_Closed; });
+      if (m_Queue.empty()) {
+        return;
+      }
+
+      block_t block = std::move(m_Queue.front());
+      m_Queue.pop_front();
+      m_Writing = true;
+      lock.unlock();
+      m_Condition.notify_all();
+
+      std::exception_ptr error;
+      try {
+        write_block(block);
+      } catch (...) {
+        error = std::current_exception();
+      }
+
+      lock.lock();
+      m_Writing = false;
+      m_Condition.notify_all();
+      if (error) {
+        m_Error = error;
+        m_Queue.clear();
+        m_Condition.notify_all();
+        return;
+      }
+    }
+  }
+
+  void ResultFileWriter::write_block(const block_t& block) {
+    const std::size_t n = block.size();
+
+    write_value(m_File, static_cast<std::uint32_t>(n));
+    write_value(m_File, static_cast<std::uint32_t>(0));
+    write_value(m_File, block_bytes(n, m_NParameters, m_NSpectra, m_NBins));
+
+    auto write_column = [this, &block](auto&& get) {
+      m_Column.clear();
+      for (const auto& record : block) {
+        m_Column.push_back(get(record));
+      }
+      write_array(m_File, m_Column);
+    };
+
+    write_column([](const ResultRecord& r) { return r.llh; });
+    write_column([](const ResultRecord& r) { return r.edm; });
+    write_column([](const ResultRecord& r) { return r.duration; });
+
+    std::vector<std::int32_t> int_column(padded_int_column(n), 0);
+    std::ranges::transform(block, int_column.begin(), &ResultRecord::status);
+    write_array(m_File, int_column);
+    std::ranges::transform(block, int_column.begin(), &ResultRecord::n_free);
+    write_array(m_File, int_column);
+
+    for (std::size_t i = 0; i < m_NParameters; ++i) {
+      write_column([i](const ResultRecord& r) { return r.parameters[i]; });
+    }
+    for (std::size_t i = 0; i < m_NParameters; ++i) {
+      write_column([i](const ResultRecord& r) { return r.errors[i]; });
+    }
+
+    for (std::size_t s = 0; s < m_NSpectra; ++s) {
+      m_Column.clear();
+      for (const auto& record : block) {
+        const auto first = record.spectra.begin() + static_cast<std::ptrdiff_t>(s * m_NBins);
+        m_Column.insert(m_Column.end(), first, first + static_cast<std::ptrdiff_t>(m_NBins));
+      }
+      write_array(m_File, m_Column);
+    }
+
+    // Every block is flushed, so a crashed run leaves all completed blocks readable
+    m_File.flush();
+    if (!m_File) {
+      throw std::runtime_error("Could not write a block of the result file");
+    }
+  }
+
+  ResultFileReader::ResultFileReader(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      throw std::runtime_error("Could not open result file " + path);
+    }
+
+    ResultFileHeader header = read_header(file, path);
+    m_ParameterNames        = std::move(header.parameter_names);
+    m_SpectrumNames         = std::move(header.spectrum_names);
+    m_NBins                 = header.n_bins;
+
+    m_Parameters.resize(m_ParameterNames.size());
+    m_Errors.resize(m_ParameterNames.size());
+    m_Spectra.resize(m_SpectrumNames.size());
+
+    std::vector<std::int32_t> int_column;
+
+    while (file.peek() != std::ifstream::traits_type::eof()) {
+      const std::size_t n = read_value<std::uint32_t>(file);
+      read_value<std::uint32_t>(file);
+      if (read_value<std::uint64_t>(file) != block_bytes(n, m_ParameterNames.size(), m_SpectrumNames.size(), m_NBins)) {
+        throw std::runtime_error("Corrupted block in result file " + path);
+      }
+
+      read_array(file, m_LLH, n);
+      read_array(file, m_EDM, n);
+      read_array(file, m_Duration, n);
+
+      for (auto* column : {&m_Status, &m_NFree}) {
+        int_column.clear();
+        read_array(file, int_column, padded_int_column(n));
+        column->insert(column->end(), int_column.begin(), int_column.begin() + static_cast<std::ptrdiff_t>(n));
+      }
+
+      for (auto& column : m_Parameters) {
+        read_array(file, column, n);
+      }
+      for (auto& column : m_Errors) {
+        read_array(file, column, n);
+      }
+      for (auto& column : m_Spectra) {
+        read_array(file, column, n * m_NBins);
+      }
+    }
+  }
+
+  std::span<const double> ResultFileReader::parameter(const std::string& name) const {
+    const auto it = std::ranges::find(m_ParameterNames, name);
+    if (it == m_ParameterNames.end()) {
+      throw std::invalid_argument("Parameter " + name + " not found in result file");
+    }
+    return m_Parameters[static_cast<std::size_t>(std::distance(m_ParameterNames.begin(), it))];
+  }
+
+}  // namespace result
@@ -0,0 +1,224 @@
+#pragma once
+
+// STL includes
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace result {
+
+  /**
+   * @brief The result of a single fit as stored in a result file.
+   */
+  struct ResultRecord {
+    static constexpr std::int32_t converged_flag   = 1 << 0;  ///< Status bit of a converged fit.
+    static constexpr std::int32_t valid_error_flag = 1 << 1;  ///< Status bit of a valid error matrix.
+
+    std::vector<double> parameters;      ///< The best-fit values of all parameters.
+    std::vector<double> errors;          ///< The errors of all parameters.
+    double              llh      = 0.0;  ///< The minimal likelihood value.
+    double              edm      = 0.0;  ///< The estimated distance to the minimum.
+    double              duration = 0.0;  ///< The duration of the fit in seconds.
+    std::int32_t        status   = 0;    ///< The status bits of the fit.
+    std::int32_t        n_free   = 0;    ///< The number of free parameters.
+    std::vector<double> spectra;         ///< All spectra one after another, empty if the file stores no spectra.
+  };
+
+  /**
+   * @class ResultFileWriter
+   * @brief Appends fit results to a binary columnar file on a background thread.
+   *
+   * The file starts with the magic "PLNORSLT", a version number, the parameter names and the names and the number
+   * of bins of the stored spectra, padded to 8 bytes. It is followed by blocks of up to block_size records. A block
+   * starts with the number of records, 4 bytes of padding and the size of its columns in bytes. The records are
+   * stored column by column: LLH, EDM and duration as doubles, status and number of free parameters as 32-bit
+   * integers padded to 8 bytes, the values and the errors of every parameter as doubles and finally every spectrum
+   * as rows of n_bins doubles. All numbers are stored in the native byte order, so a block can be mapped into
+   * memory directly.
+   *
+   * The records are collected into blocks by the calling thread and written by the background thread, which also
+   * performs the transposition. append() only blocks if the background thread falls behind by several blocks.
+   */
+  class ResultFileWriter {
+   public:
+    /**
+     * @brief Creates the result file.
+     *
+     * @param path The path of the result file.
+     * @param parameter_names The names of the parameters.
+     * @param spectrum_names The names of the spectra, empty to store no spectra.
+     * @param n_bins The number of bins of every spectrum.
+     * @param append Whether the records are appended to an existing file instead of overwriting it. An incomplete
+     *               block at the end of the file, e.g. of an interrupted job, is removed before.
+     * @param block_size The number of records per block.
+     * @throws std::runtime_error if the file can not be created or an existing file has a different layout.
+     */
+    ResultFileWriter(const std::string&              path,
+                     const std::vector<std::string>& parameter_names,
+                     const std::vector<std::string>& spectrum_names,
+                     std::size_t                     n_bins,
+                     bool                            append     = false,
+                     std::size_t                     block_size = 1024);
+
+    ResultFileWriter(const ResultFileWriter&)            = delete;
+    ResultFileWriter& operator=(const ResultFileWriter&) = delete;
+
+    /**
+     * @brief Writes the remaining records and waits for the background thread. Errors are only reported on stderr,
+     *        call close() to handle them.
+     */
+    ~ResultFileWriter();
+
+    /**
+     * @brief Appends a record.
+     *
+     * @param record The result of a fit, with the sizes given at the construction.
+     * @throws std::invalid_argument if the sizes of the record do not match the file.
+     * @throws std::runtime_error if the background thread failed to write a previous block.
+     * @throws std::logic_error if the file is closed.
+     */
+    void append(ResultRecord record);
+
+    /**
+     * @brief Writes the appended records and waits until they are written to the file.
+     *
+     * @throws std::runtime_error if a block could not be written.
+     * @throws std::logic_error if the file is closed.
+     */
+    void flush();
+
+    /**
+     * @brief Writes the remaining records and closes the file. Further records can not be appended.
+     *
+     * @throws std::runtime_error if a block could not be written.
+     */
+    void close();
+
+    [[nodiscard]] bool stores_spectra() const noexcept { return m_NSpectra > 0; }
+
+    [[nodiscard]] std::uint64_t number_of_records() const noexcept { return m_NRecords; }
+
+   private:
+    using block_t = std::vector<ResultRecord>;
+
+    /**
+     * @brief Hands the current block over to the background thread.
+     */
+    void submit_block();
+
+    /**
+     * @brief The loop of the background thread, writes the submitted blocks until the writer is closed.
+     */
+    void write_loop();
+
+    /**
+     * @brief Writes a block in the columnar layout.
+     */
+    void write_block(const block_t& block);
+
+    std::ofstream m_File;        ///< The result file, only accessed by the background thread after the header.
+    std::size_t   m_NParameters; ///< The number of parameters per record.
+    std::size_t   m_NSpectra;    ///< The number of spectra per record.
+    std::size_t   m_NBins;       ///< The number of bins per spectrum.
+    std::size_t   m_BlockSize;   ///< The maximal number of records per block.
+    std::uint64_t m_NRecords;    ///< The number of appended records.
+
+    block_t             m_Current;  ///< The block filled by append().
+    std::vector<double> m_Column;   ///< The buffer of the background thread for the transposition.
+
+    std::mutex              m_Mutex;      ///< Guards the queue, the closed flag and the error.
+    std::condition_variable m_Condition;  ///< Signals changes of the queue.
+    std::deque<block_t>     m_Queue;      ///< The blocks waiting to be written.
+    bool                    m_Closed;     ///< Whether no further blocks are submitted.
+    bool                    m_Writing;    ///< Whether the background thread is writing a block.
+    std::exception_ptr      m_Error;      ///< The error of the background thread.
+    std::thread             m_Thread;     ///< The background thread.
+  };
+
+  /**
+   * @class ResultFileReader
+   * @brief Reads a result file written by ResultFileWriter into memory.
+   *
+   * The columns of all blocks are concatenated, so every column is a contiguous array with one entry per record.
+   */
+  class ResultFileReader {
+   public:
+    /**
+     * @brief Reads a result file.
+     *
+     * @param path The path of the result file.
+     * @throws std::runtime_error if the file can not be read or is not a result file.
+     */
+    explicit ResultFileReader(const std::string& path);
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_LLH.size(); }
+
+    [[nodiscard]] const std::vector<std::string>& parameter_names() const noexcept { return m_ParameterNames; }
+
+    [[nodiscard]] const std::vector<std::string>& spectrum_names() const noexcept { return m_SpectrumNames; }
+
+    [[nodiscard]] std::size_t number_of_bins() const noexcept { return m_NBins; }
+
+    [[nodiscard]] std::span<const double> llh() const noexcept { return m_LLH; }
+
+    [[nodiscard]] std::span<const double> edm() const noexcept { return m_EDM; }
+
+    [[nodiscard]] std::span<const double> duration() const noexcept { return m_Duration; }
+
+    [[nodiscard]] std::span<const std::int32_t> status() const noexcept { return m_Status; }
+
+    [[nodiscard]] std::span<const std::int32_t> n_free() const noexcept { return m_NFree; }
+
+    [[nodiscard]] bool converged(std::size_t record) const noexcept { return m_Status[record] & ResultRecord::converged_flag; }
+
+    /**
+     * @brief Returns the best-fit values of a parameter for all records.
+     */
+    [[nodiscard]] std::span<const double> parameter(std::size_t idx) const noexcept { return m_Parameters[idx]; }
+
+    /**
+     * @brief Returns the best-fit values of a parameter for all records.
+     *
+     * @throws std::invalid_argument if the file contains no parameter of this name.
+     */
+    [[nodiscard]] std::span<const double> parameter(const std::string& name) const;
+
+    /**
+     * @brief Returns the errors of a parameter for all records.
+     */
+    [[nodiscard]] std::span<const double> error(std::size_t idx) const noexcept { return m_Errors[idx]; }
+
+    /**
+     * @brief Returns a spectrum of a single record.
+     *
+     * @param idx The index of the spectrum in spectrum_names().
+     * @param record The index of the record.
+     */
+    [[nodiscard]] std::span<const double> spectrum(std::size_t idx, std::size_t record) const noexcept {
+      return std::span<const double>(m_Spectra[idx]).subspan(record * m_NBins, m_NBins);
+    }
+
+   private:
+    std::vector<std::string> m_ParameterNames;  ///< The parameter names.
+    std::vector<std::string> m_SpectrumNames;   ///< The spectrum names.
+    std::size_t              m_NBins;           ///< The number of bins per spectrum.
+
+    std::vector<double>       m_LLH;       ///< The likelihood values.
+    std::vector<double>       m_EDM;       ///< The estimated distances to the minimum.
+    std::vector<double>       m_Duration;  ///< The fit durations.
+    std::vector<std::int32_t> m_Status;    ///< The status bits.
+    std::vector<std::int32_t> m_NFree;     ///< The numbers of free parameters.
+
+    std::vector<std::vector<double>> m_Parameters;  ///< The best-fit values per parameter.
+    std::vector<std::vector<double>> m_Errors;      ///< The errors per parameter.
+    std::vector<std::vector<double>> m_Spectra;     ///< The spectra of all records per spectrum.
+  };
+
+}  // namespace result
@@ -9,10 +9,10 @@
 
 namespace result {
 
-  inline void perform_fit(ana::Fit& fit, std::string_view name, const std::function<void(ana::Fit&)>& function = [](ana::Fit&) {}) {
+  inline void perform_fit(ana::Fit& fit, std::string_view name, const std::function<void(ana::Fit&)>& function = [](ana::Fit&) {}, ResultFileWriter* sink = nullptr) {
     function(fit);
     fit.minimize();
-    write_results(fit, name);
+    write_results(fit, name, sink);
   }
 
 }  // namespace result
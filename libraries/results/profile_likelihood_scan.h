@@ -1,21 +1,92 @@
 #pragma once
 
-namespace rslt {
+#include "Checkpoint.h"
+#include "Fit.h"
+#include "perform_fit.h"
 
-  void profile_likelihood_scan(boost::asio::thread_pool& pool,
-                               const io::Options& options,
-                               const std::string& output_dir,
-                               unsigned int n_points,
-                               std::function<void(Analysis::Fitter&)> function,
-                               double min,
-                               double max) {
-    // Create the output directory
-    boost::filesystem::create_directories(output_dir);
+// STL includes
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
 
-    // Create the fitter object
-    Analysis::Fitter fit(options);
+namespace result {
 
-    // Perform the likelihood scan
-    fit.perform_likelihood_scan(pool, output_dir, n_points, function, min, max);
+  /**
+   * @brief Performs a profile likelihood scan of a single parameter.
+   *
+   * For every scan point the parameter is fixed to the scan value and all other free parameters are profiled.
+   * The result of each point is written to "<name>_<point>.json", or appended to "<name>.plnr" in the binary
+   * result format. If a checkpoint file is configured, the completed points and the state of the running fit are
+   * stored in it, so a scan started with --resume skips the completed points and continues the interrupted fit.
+   *
+   * @param options The options of the fit.
+   * @param name The prefix of the output files.
+   * @param parameter_name The name of the scanned parameter as given in the config file.
+   * @param n_points The number of scan points.
+   * @param min The lower end of the scan range.
+   * @param max The upper end of the scan range.
+   */
+  inline void profile_likelihood_scan(const std::shared_ptr<io::Options>& options,
+                                      std::string_view                    name,
+                                      std::string_view                    parameter_name,
+                                      unsigned int                        n_points,
+                                      double                              min,
+                                      double                              max) {
+    const auto& inputOptions = options->inputOptions();
 
-  }
\ No newline at end of file
+    const auto names = ana::Fit::parameter_names(*options);
+    const auto it    = std::ranges::find(names, parameter_name);
+    if (it == names.end()) {
+      throw std::invalid_argument("Scan parameter " + std::string(parameter_name) + " not found in config file");
+    }
+    const auto parameter = static_cast<unsigned int>(std::distance(names.begin(), it));
+
+    std::shared_ptr<ana::Checkpoint> checkpoint;
+    if (!inputOptions.checkpoint_file().empty()) {
+      checkpoint = std::make_shared<ana::Checkpoint>(inputOptions.checkpoint_file(), inputOptions.checkpoint_interval());
+      if (inputOptions.resume() && checkpoint->exists()) {
+        checkpoint->load();
+      }
+    }
+
+    // A resumed scan appends the remaining points to the binary result file
+    const auto sink = make_result_sink(*options, name);
+
+    for (unsigned int i = 0; i < n_points; ++i) {
+      if (checkpoint && checkpoint->completed(i)) {
+        std::cout << "Skipping completed scan point " << i << '\n';
+        continue;
+      }
+
+      const double value = (n_points > 1) ? min + i * (max - min) / (n_points - 1) : min;
+
+      ana::Fit fit(options, checkpoint);
+
+      std::stringstream ss;
+      ss << name << '_' << i;
+      std::cout << "Scan point " << i << " at " << value << '\n';
+
+      perform_fit(fit, ss.str(), [parameter, value](ana::Fit& f) {
+        const auto minimizer = f.get_minimizer();
+        minimizer->SetVariableValue(parameter, value);
+        minimizer->FixVariable(parameter);
+      }, sink.get());
+
+      if (checkpoint) {
+        // A completed point has to be on disk before the checkpoint skips it
+        if (sink) {
+          sink->flush();
+        }
+        checkpoint->mark_completed(i, value);
+        checkpoint->save();
+      }
+    }
+
+    if (sink) {
+      sink->close();
+    }
+  }
+
+}  // namespace result
@@ -1,16 +1,224 @@
 #pragma once
 
 #include "Fit.h"
+#include "ResultFile.h"
 
 #include <nlohmann/json.hpp>
 
 // STL includes
+#include <memory>
 #include <string_view>
 
 namespace result {
 
   namespace dc {
 
+    /**
+     * @brief Converts hardware performance counts into JSON, including the derived instructions per cycle and the
+     *        cache misses per thousand instructions.
+     */
+    inline nlohmann::json get_hardware_json(const utilities::HardwareCounts& counts) {
+      const auto ratio = [](std::uint64_t a, std::uint64_t b) { return b > 0 ? static_cast<double>(a) / static_cast<double>(b) : 0.0; };
+
+      nlohmann::json j;
+      j["cycles"]                     = counts.cycles;
+      j["instructions"]               = counts.instructions;
+      j["cacheMisses"]                = counts.cache_misses;
+      j["branchMisses"]               = counts.branch_misses;
+      j["instructionsPerCycle"]       = ratio(counts.instructions, counts.cycles);
+      j["cacheMissesPerKInstruction"] = 1000.0 * ratio(counts.cache_misses, counts.instructions);
+      return j;
+    }
+
+    /**
+     * @brief Converts a timing counter into JSON, with the histogram truncated after the last filled bin.
+     */
+    inline nlohmann::json get_counter_json(const utilities::TimingCounter& counter) {
+      const auto& histogram = counter.histogram();
+      const auto  last      = std::find_if(histogram.rbegin(), histogram.rend(), [](auto n) { return n != 0; });
+
+      nlohmann::json j;
+      j["calls"]           = counter.calls();
+      j["recomputes"]      = counter.recomputes();
+      j["cacheHitRate"]    = counter.calls() > 0 ? 1.0 - static_cast<double>(counter.recomputes()) / static_cast<double>(counter.calls()) : 0.0;
+      j["totalTime"]       = static_cast<double>(counter.total_time()) * 1.0e-9;
+      j["meanTime"]        = counter.calls() > 0 ? static_cast<double>(counter.total_time()) * 1.0e-9 / static_cast<double>(counter.calls()) : 0.0;
+      j["histogramLog2Ns"] = std::vector<std::uint64_t>(histogram.begin(), last.base());
+      if (utilities::hardware_counters_enabled()) {
+        j["hardware"] = get_hardware_json(counter.hardware());
+      }
+      return j;
+    }
+
+    /**
+     * @brief Returns the timing counters of the spectrum components and the likelihood terms of a fit.
+     *
+     * Times are given in seconds. Bin i of a histogram counts the calls which took between 2^(i-1) and 2^i ns.
+     */
+    inline nlohmann::json get_profile_json(ana::dc::DCLikelihood& likelihood) {
+      using enum params::dc::DetectorType;
+
+      nlohmann::json j;
+      j["enabled"] = utilities::profiling_enabled();
+
+      for (const auto* profile : likelihood.collect_profiles()) {
+        auto component = get_counter_json(profile->total());
+
+        for (const auto detector : {ND, FDI, FDII, NDB1, NDB2, FDIB1, FDIB2, FDIIB1, FDIIB2}) {
+          const auto& counter = profile->data_set(params::get_index(detector));
+          if (counter.calls() > 0) {
+            component["detectors"][params::dc::get_detector_name(detector)] = get_counter_json(counter);
+          }
+        }
+
+        j["components"][profile->name()] = std::move(component);
+      }
+      return j;
+    }
+
+    /**
+     * @brief The names of the spectra of a fit result, in the order in which visit_spectra() visits them.
+     */
+    inline std::vector<std::string> result_spectrum_names() {
+      using enum params::dc::DetectorType;
+
+      std::vector<std::string> names;
+      for (const auto detector : {ND, FDI, FDII}) {
+        for (const auto* spectrum : {"accidental", "lithium", "fastn", "dnc", "signal"}) {
+          names.push_back(params::dc::get_detector_name(detector) + '/' + spectrum);
+        }
+      }
+      for (const auto* spectrum : {"signal0", "signal-shape", "signal0-shape"}) {
+        for (const auto detector : {ND, FDI, FDII}) {
+          names.push_back(params::dc::get_detector_name(detector) + '/' + spectrum);
+        }
+      }
+      return names;
+    }
+
+    /**
+     * @brief Recalculates the predicted spectra at the best fit and hands them to a visitor.
+     *
+     * Besides the backgrounds and the signal of the best fit, the signal is calculated without oscillation
+     * (signal0), without the shape parameters (signal-shape) and without both (signal0-shape).
+     *
+     * The hypotheses are evaluated on two reactor chains in parallel: the likelihood of the fit evaluates the best
+     * fit and then signal-shape, its hypothesis chain evaluates signal0 and then signal0-shape. As the shape
+     * variants only change the shape parameters, every chain reuses its oscillated spectra and only one oscillation
+     * is calculated besides the one of the best fit, which is usually still cached from the minimization. The
+     * hypothesis chain is kept by the likelihood, so later calls reuse it and its unchanged spectra.
+     *
+     * With the reactor split, the spectra of the detectors are visited, i.e. the signal is the sum of both reactors.
+     *
+     * @param visitor Called with the detector name, the spectrum name and the bin contents of every spectrum.
+     */
+    template <typename Visitor>
+    void visit_spectra(ana::Fit& fit, Visitor&& visitor) {
+      using enum params::dc::DetectorType;
+      using span_t     = std::span<const double>;
+      using spectrum_t = ana::dc::Binning::spectrum_t;
+
+      static constexpr std::array detector_types = {ND, FDI, FDII};
+
+      std::span<const double> X = fit.parameters();
+
+      auto dc_llh = fit.doublechooz_likelihood();
+
+      // The parameters of the hypotheses
+      const std::vector<double> best_fit(X.begin(), X.begin() + params::number_of_parameters());
+
+      auto remove_oscillation = [](std::vector<double> parameters) {
+        parameters[params::General::SinSqT13] = 0.0;
+        return parameters;
+      };
+      auto remove_shape = [](std::vector<double> parameters) {
+        for (const auto detector : {ND, FDI, FDII}) {
+          using enum params::dc::Detector;
+          for (int i = NuShape01; i <= NuShape43; ++i) {
+            parameters[params::index(detector, i)] = 0.0;
+          }
+        }
+        return parameters;
+      };
+
+      const std::vector<double> no_oscillation = remove_oscillation(best_fit);
+
+      // The reactor spectrum is normalized with the MC normalization, which does not depend on the hypothesis
+      auto normalized_signal = [&dc_llh](const ana::dc::SpectrumBase& signal, const ana::dc::ParameterWrapper& parameter) {
+        std::array<spectrum_t, detector_types.size()> spectra{};
+        for (std::size_t d = 0; d < detector_types.size(); ++d) {
+          const span_t sig    = signal.get_spectrum(detector_types[d]);
+          const double mcNorm = dc_llh->calculate_mcNorm(parameter, detector_types[d]);
+
+          std::transform(sig.begin(), sig.end(), spectra[d].begin(), [mcNorm](double x) -> double { return x * mcNorm; });
+        }
+        return spectra;
+      };
+
+      std::array<spectrum_t, detector_types.size()> signal0{};
+      std::array<spectrum_t, detector_types.size()> signal0_no_shape{};
+
+      // The null hypotheses on the hypothesis chain as a task of the scheduler, the chain only shares the events
+      // with the likelihood, which are not modified
+      auto& chain = dc_llh->hypothesis_chain();
+
+      utilities::TaskGroup null_hypotheses(fit.options()->scheduler());
+      null_hypotheses.run([&] {
+        auto& [signal, parameter] = chain;
+
+        parameter.reset_parameter(no_oscillation.data());
+        signal.check_and_recalculate(parameter);
+        signal0 = normalized_signal(signal, parameter);
+
+        const std::vector<double> no_oscillation_shape = remove_shape(no_oscillation);
+        parameter.reset_parameter(no_oscillation_shape.data());
+        signal.check_and_recalculate(parameter);
+        signal0_no_shape = normalized_signal(signal, parameter);
+      });
+
+      // The best fit on the likelihood of the fit, the backgrounds are visited before the reactor chain moves on
+      auto& parameter = dc_llh->parameter();
+      auto& signal    = dc_llh->reactor_spectrum();
+
+      std::cout << "Writing default spectra to output file\n";
+      dc_llh->check_and_recalculate(best_fit.data());
+      {
+        const auto signal_best_fit = normalized_signal(signal, parameter);
+
+        for (std::size_t d = 0; d < detector_types.size(); ++d) {
+          const auto detector = detector_types[d];
+          const auto name     = params::dc::get_detector_name(detector);
+
+          visitor(name, "accidental", dc_llh->accidental_background().get_spectrum(detector));
+          visitor(name, "lithium", dc_llh->lithium_background().get_spectrum(detector));
+          visitor(name, "fastn", dc_llh->fastn_background().get_spectrum(detector));
+          visitor(name, "dnc", dc_llh->dnc_background().get_spectrum(detector));
+          visitor(name, "signal", span_t(signal_best_fit[d]));
+        }
+      }
+
+      const std::vector<double> no_shape = remove_shape(best_fit);
+      dc_llh->check_and_recalculate(no_shape.data());
+      const auto signal_no_shape = normalized_signal(signal, parameter);
+
+      null_hypotheses.wait();
+
+      auto visit_signal = [&](const char* spectrum, const auto& spectra) {
+        for (std::size_t d = 0; d < detector_types.size(); ++d) {
+          visitor(params::dc::get_detector_name(detector_types[d]), spectrum, span_t(spectra[d]));
+        }
+      };
+
+      std::cout << "Writing sginal Null-Hpothesis (signal0) to output file\n";
+      visit_signal("signal0", signal0);
+
+      std::cout << "Writing default case without Shape parameter (signal-shape) to output file\n";
+      visit_signal("signal-shape", signal_no_shape);
+
+      std::cout << "Writing Null-Hpothesis case without Shape parameter (signal0-shape) to output file\n";
+      visit_signal("signal0-shape", signal0_no_shape);
+    }
+
     inline nlohmann::json get_json_file(ana::Fit& fit) {
       using namespace nlohmann;
 
@@ -26,10 +234,9 @@ namespace result {
       const auto& parameters      = inputParameters.parameters();
       const auto& constrained     = inputParameters.constrained();
 
-      assert(min->X() != nullptr);
-
-      std::span<const double> X(min->X(), parameters.size());
-      std::span<const double> error(min->Errors(), parameters.size());
+      // The parameters of the fit include the analytically profiled nuisance parameters
+      std::span<const double> X     = fit.parameters();
+      std::span<const double> error = fit.errors();
 
       json j;
 
@@ -46,6 +253,12 @@ namespace result {
       j["fitTime"]      = std::chrono::system_clock::now().time_since_epoch().count();
       j["fitDuration"]  = fit.time_duration();
       j["converged"]    = fit.converged();
+      if (utilities::hardware_counters_enabled()) {
+        j["hardware"] = get_hardware_json(fit.hardware_counts());
+      }
+
+      // Collected before the spectra below are recalculated, so the counters only contain the calls of the fit
+      j["profile"] = get_profile_json(*fit.doublechooz_likelihood());
 
       {
         std::vector<double> binning(io::dc::Constants::EnergyBinXaxis.begin(), io::dc::Constants::EnergyBinXaxis.end());
@@ -59,7 +272,7 @@ namespace result {
 
       auto& parameter = llh->parameter();
 
-      parameter.reset_parameter(min->X());
+      parameter.reset_parameter(X.data());
 
       for (std::size_t i = 0, N = parameters.size(); i < N; ++i) {
         parametersJson.push_back({{"CV", parameters[i].value()},
@@ -67,159 +280,62 @@ namespace result {
                                   {"name", parameter_names[i]},
                                   {"index", i},
                                   {"value", X[i]},
-                                  {"fixed", min->IsFixedVariable(i)},
+                                  {"fixed", min->IsFixedVariable(i) && !fit.profiled(i)},
+                                  {"profiled", fit.profiled(i)},
                                   {"constrained", constrained[i]},
                                   {"error", error[i]},
                                   {"true", parameter[i]}});
       }
 
-      j["parameter"] = std::move(parametersJson);
-
-      std::vector<params::dc::DetectorType> detector_types;
-
-      using enum params::dc::DetectorType;
-
-      if (dcInfo.reactor_split()) {
-        throw std::invalid_argument("Reactor split is not supported yet.");
-      } else {
-        detector_types = {ND, FDI, FDII};
-      }
-
-      auto dc_llh = fit.doublechooz_likelihood();
-
-      auto& acc_bkg = dc_llh->accidental_background();
-      auto& li_bkg  = dc_llh->lithium_background();
-      auto& fn_bkg  = dc_llh->fastn_background();
-      auto& dnc_bkg = dc_llh->dnc_background();
-      auto& signal  = dc_llh->reactor_spectrum();
-
-      std::array<double, 44> signal_prediction{};
-      std::ranges::fill(signal_prediction, 0.0);
-
-      std::cout << "Writing default spectra to output file\n";
-      // Default Case
-      using span_t = std::span<const double>;
-      {
-        dc_llh->check_and_recalculate(min->X());
-
-        for (const auto detector : detector_types) {
-          const span_t acc = acc_bkg.get_spectrum(detector);
-          const span_t li  = li_bkg.get_spectrum(detector);
-          const span_t fn  = fn_bkg.get_spectrum(detector);
-          const span_t dnc = dnc_bkg.get_spectrum(detector);
-          const span_t sig = signal.get_spectrum(detector);
-
-          const double mcNorm = dc_llh->calculate_mcNorm(parameter, detector);
-
-          std::transform(sig.begin(),
-                         sig.end(),
-                         signal_prediction.begin(),
-                         [mcNorm](double x) -> double {
-                           return x * mcNorm;
-                         });
-
-          std::string name = params::dc::get_detector_name(detector);
-
-          json detector_json;
-
-          detector_json["accidental"] = acc;
-          detector_json["lithium"]    = li;
-          detector_json["fastn"]      = fn;
-          detector_json["dnc"]        = dnc;
-          detector_json["signal"]     = signal_prediction;
-
-          j[name] = detector_json;
-        }
-      }
-      std::cout << "Writing sginal Null-Hpothesis (signal0) to output file\n";
-      std::ranges::fill(signal_prediction, 0.0);
-
-      std::vector<double> input_parameters(params::number_of_parameters(), 0.0);
-      std::copy_n(min->X(), params::number_of_parameters(), input_parameters.begin());
-
-      // Null Hypothesis
-      using enum params::General;
-      input_parameters[SinSqT13] = 0.0;
-      {
-        dc_llh->check_and_recalculate(input_parameters.data());
-
-        for (const auto detector : detector_types) {
-          const span_t sig = signal.get_spectrum(detector);
-
-          const double mcNorm = dc_llh->calculate_mcNorm(parameter, detector);
-
-          std::transform(sig.begin(),
-                         sig.end(),
-                         signal_prediction.begin(),
-                         [mcNorm](double x) -> double {
-                           return x * mcNorm;
-                         });
-
-          std::string name = params::dc::get_detector_name(detector);
-
-          j[name]["signal0"] = signal_prediction;
-        }
-      }
-      std::cout << "Writing default case without Shape parameter (signal-shape) to output file\n";
-      std::ranges::fill(signal_prediction, 0.0);
-      std::copy_n(min->X(), params::number_of_parameters(), input_parameters.begin());
-      for (const auto detector : {ND, FDI, FDII}) {
-        using enum params::dc::Detector;
-        for (int i = NuShape01; i <= NuShape43; ++i) {
-          input_parameters[params::index(detector, i)] = 0.0;
-        }
+      // The parameters of the further experiments of a combined fit follow the Double Chooz parameters
+      const auto& fit_names = fit.parameter_names();
+      for (std::size_t i = parameters.size(), N = fit_names.size(); i < N; ++i) {
+        parametersJson.push_back({{"name", fit_names[i]},
+                                  {"index", i},
+                                  {"value", X[i]},
+                                  {"fixed", min->IsFixedVariable(i)},
+                                  {"error", error[i]}});
       }
-      {
-        dc_llh->check_and_recalculate(input_parameters.data());
-
-        for (const auto detector : detector_types) {
-          const span_t sig = signal.get_spectrum(detector);
-
-          const double mcNorm = dc_llh->calculate_mcNorm(parameter, detector);
-
-          std::transform(sig.begin(),
-                         sig.end(),
-                         signal_prediction.begin(),
-                         [mcNorm](double x) -> double {
-                           return x * mcNorm;
-                         });
 
-          std::string name = params::dc::get_detector_name(detector);
-
-          j[name]["signal-shape"] = signal_prediction;
-        }
-      }
-      std::cout << "Writing Null-Hpothesis case without Shape parameter (signal0-shape) to output file\n";
-      std::ranges::fill(signal_prediction, 0.0);
-      std::copy_n(min->X(), params::number_of_parameters(), input_parameters.begin());
-      for (const auto detector : {ND, FDI, FDII}) {
-        using enum params::dc::Detector;
-        for (int i = NuShape01; i <= NuShape43; ++i) {
-          input_parameters[params::index(detector, i)] = 0.0;
+      if (const auto& composite = fit.composite_likelihood()) {
+        json experiments;
+        for (std::size_t e = 0; e < composite->number_of_experiments(); ++e) {
+          experiments[composite->experiment(e).name] = {{"LLH", composite->value(e)}, {"evaluations", composite->evaluations(e)}};
         }
+        j["experiments"] = std::move(experiments);
       }
-      input_parameters[SinSqT13] = 0.0;
-      {
-        dc_llh->check_and_recalculate(input_parameters.data());
 
-        for (const auto detector : detector_types) {
-          const span_t sig = signal.get_spectrum(detector);
+      j["parameter"] = std::move(parametersJson);
 
-          const double mcNorm = dc_llh->calculate_mcNorm(parameter, detector);
+      visit_spectra(fit, [&j](const std::string& detector, const char* spectrum, std::span<const double> values) { j[detector][spectrum] = values; });
 
-          std::transform(sig.begin(),
-                         sig.end(),
-                         signal_prediction.begin(),
-                         [mcNorm](double x) -> double {
-                           return x * mcNorm;
-                         });
+      return j;
+    }
 
-          std::string name = params::dc::get_detector_name(detector);
+    /**
+     * @brief Converts the result of a fit into a record of a binary result file.
+     *
+     * @param spectra Whether the spectra of result_spectrum_names() are calculated and stored.
+     */
+    inline ResultRecord get_result_record(ana::Fit& fit, bool spectra) {
+      const auto min = fit.get_minimizer();
+      assert(min != nullptr);
 
-          j[name]["signal0-shape"] = signal_prediction;
-        }
+      ResultRecord record;
+      record.parameters.assign(fit.parameters().begin(), fit.parameters().end());
+      record.errors.assign(fit.errors().begin(), fit.errors().end());
+      record.llh      = min->MinValue();
+      record.edm      = min->Edm();
+      record.duration = fit.time_duration();
+      record.status   = (fit.converged() ? ResultRecord::converged_flag : 0) | (min->IsValidError() ? ResultRecord::valid_error_flag : 0);
+      record.n_free   = static_cast<std::int32_t>(min->NFree());
+
+      if (spectra) {
+        visit_spectra(fit, [&record](const std::string&, const char*, std::span<const double> values) {
+          record.spectra.insert(record.spectra.end(), values.begin(), values.end());
+        });
       }
-      return j;
+      return record;
     }
 
     inline void write_double_chooz_results(ana::Fit& fit, std::string_view name) {
@@ -234,12 +350,46 @@ namespace result {
     }
   }  // namespace dc
 
-  inline void write_results(ana::Fit& fit, std::string_view name) {
-    if (fit.use_double_chooz()) {
-      dc::write_double_chooz_results(fit, name);
-    } else {
+  /**
+   * @brief Creates the binary result file "<name>.plnr" if the binary result format is selected. A resumed run
+   *        appends to an existing file.
+   *
+   * @return The result file, or a nullptr if the results are written as JSON.
+   * @throws std::invalid_argument if the result format is unknown.
+   */
+  inline std::unique_ptr<ResultFileWriter> make_result_sink(const io::Options& options, std::string_view name) {
+    const auto& inputOptions = options.inputOptions();
+
+    if (inputOptions.result_format() == "json") {
+      return nullptr;
+    }
+    if (inputOptions.result_format() != "binary") {
+      throw std::invalid_argument("Unknown result format " + inputOptions.result_format() + ", use json or binary");
+    }
+
+    return std::make_unique<ResultFileWriter>(std::string(name) + ".plnr",
+                                              ana::Fit::parameter_names(options),
+                                              inputOptions.result_spectra() ? dc::result_spectrum_names() : std::vector<std::string>{},
+                                              io::dc::Constants::EnergyBinXaxis.size() - 1,
+                                              inputOptions.resume());
+  }
+
+  /**
+   * @brief Writes the result of a fit.
+   *
+   * @param name The name of the JSON file without extension.
+   * @param sink The binary result file the result is appended to instead, if not a nullptr.
+   */
+  inline void write_results(ana::Fit& fit, std::string_view name, ResultFileWriter* sink = nullptr) {
+    if (!fit.use_double_chooz()) {
       throw std::invalid_argument("Only Double Chooz results are supported at the moment.");
     }
+
+    if (sink) {
+      sink->append(dc::get_result_record(fit, sink->stores_spectra()));
+    } else {
+      dc::write_double_chooz_results(fit, name);
+    }
   }
 
 }  // namespace result
@@ -0,0 +1,178 @@
+#include "AllocationCounter.h"
+
+#ifdef PHYLINO_COUNT_ALLOCATIONS
+
+// STL includes
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+}
+#endif
+
+namespace {
+
+  // Initial-exec TLS does not allocate on the first access, which would recurse into the allocation functions
+  thread_local std::uint64_t allocations __attribute__((tls_model("initial-exec"))) = 0;
+
+  // Constant initialized, so it is usable by allocations during the static initialization
+  std::atomic<std::uint64_t> process_allocations{0};
+
+  void count_allocation() noexcept {
+    ++allocations;
+    process_allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void* counted_malloc(std::size_t size) noexcept {
+    count_allocation();
+#if defined(__GLIBC__)
+    return __libc_malloc(size);
+#else
+    return std::malloc(size);
+#endif
+  }
+
+  void* counted_aligned_malloc(std::size_t size, std::size_t alignment) noexcept {
+    count_allocation();
+#if defined(__GLIBC__)
+    return __libc_memalign(alignment, size);
+#else
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+  }
+
+  void* throwing_malloc(std::size_t size) {
+    void* ptr = counted_malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+      throw std::bad_alloc();
+    }
+    return ptr;
+  }
+
+  void* throwing_aligned_malloc(std::size_t size, std::align_val_t alignment) {
+    void* ptr = counted_aligned_malloc(size == 0 ? 1 : size, static_cast<std::size_t>(alignment));
+    if (ptr == nullptr) {
+      throw std::bad_alloc();
+    }
+    return ptr;
+  }
+
+}  // namespace
+
+#if defined(__GLIBC__)
+extern "C" {
+void* malloc(std::size_t size) {
+  return counted_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) {
+  count_allocation();
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, std::size_t size) {
+  count_allocation();
+  return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void** ptr, std::size_t alignment, std::size_t size) {
+  *ptr = counted_aligned_malloc(size, alignment);
+  return *ptr != nullptr ? 0 : ENOMEM;
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) {
+  return counted_aligned_malloc(size, alignment);
+}
+}
+#endif
+
+void* operator new(std::size_t size) {
+  return throwing_malloc(size);
+}
+
+void* operator new[](std::size_t size) {
+  return throwing_malloc(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return counted_malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return counted_malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return throwing_aligned_malloc(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return throwing_aligned_malloc(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+namespace utilities {
+
+  std::uint64_t allocation_count() noexcept {
+    return allocations;
+  }
+
+  std::uint64_t process_allocation_count() noexcept {
+    return process_allocations.load(std::memory_order_relaxed);
+  }
+
+}  // namespace utilities
+
+#else
+
+namespace utilities {
+
+  std::uint64_t allocation_count() noexcept {
+    return 0;
+  }
+
+  std::uint64_t process_allocation_count() noexcept {
+    return 0;
+  }
+
+}  // namespace utilities
+
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+
+/**
+ * The heap allocations are only counted if PHYLINO_COUNT_ALLOCATIONS is defined, which is controlled by the CMake
+ * option of the same name. The global operator new is then replaced by a counting version. On glibc the C
+ * allocation functions are replaced as well, as Eigen allocates its dynamic matrices with malloc.
+ */
+namespace utilities {
+
+  /**
+   * @brief Checks if the heap allocations are counted.
+   */
+  constexpr bool allocation_counting_enabled() noexcept {
+#ifdef PHYLINO_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * @brief Returns the number of heap allocations of the calling thread, zero if the allocations are not counted.
+   */
+  [[nodiscard]] std::uint64_t allocation_count() noexcept;
+
+  /**
+   * @brief Returns the number of heap allocations of all threads, zero if the allocations are not counted.
+   */
+  [[nodiscard]] std::uint64_t process_allocation_count() noexcept;
+
+  /**
+   * @class AllocationScope
+   * @brief Counts the heap allocations of all threads since its construction.
+   *
+   * The allocations of the scheduler threads which run the tasks of the calling thread are included, so the scope
+   * should only be used while no unrelated work runs in parallel.
+   */
+  class AllocationScope {
+   public:
+    AllocationScope() noexcept
+      : m_Start(process_allocation_count()) {}
+
+    [[nodiscard]] std::uint64_t count() const noexcept { return process_allocation_count() - m_Start; }
+
+   private:
+    std::uint64_t m_Start;  ///< The allocation count at the construction.
+  };
+
+}  // namespace utilities
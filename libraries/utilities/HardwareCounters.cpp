@@ -0,0 +1,176 @@
+#include "HardwareCounters.h"
+
+// STL includes
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace utilities {
+
+  namespace {
+
+    std::atomic<bool> enabled{false};
+
+#ifdef __linux__
+    /**
+     * @class CounterGroup
+     * @brief The perf event group of a thread, read with a single system call.
+     *
+     * The group may count another thread of the process, its file descriptors can be read by any thread.
+     */
+    class CounterGroup {
+     public:
+      static constexpr std::array<std::uint64_t, 4> events = {PERF_COUNT_HW_CPU_CYCLES,
+                                                              PERF_COUNT_HW_INSTRUCTIONS,
+                                                              PERF_COUNT_HW_CACHE_MISSES,
+                                                              PERF_COUNT_HW_BRANCH_MISSES};
+
+      /**
+       * @param thread The system id of the counted thread, 0 for the calling thread.
+       */
+      explicit CounterGroup(const pid_t thread = 0) {
+        m_Fds.fill(-1);
+
+        for (std::size_t i = 0; i < events.size(); ++i) {
+          perf_event_attr attr{};
+          attr.type           = PERF_TYPE_HARDWARE;
+          attr.size           = sizeof(perf_event_attr);
+          attr.config         = events[i];
+          attr.disabled       = (i == 0) ? 1 : 0;
+          attr.exclude_kernel = 1;
+          attr.exclude_hv     = 1;
+          attr.read_format    = PERF_FORMAT_GROUP;
+
+          const int group = (i == 0) ? -1 : m_Fds[0];
+
+          m_Fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, thread, -1, group, 0));
+          if (m_Fds[i] < 0) {
+            m_Error = errno;
+            close_all();
+            return;
+          }
+        }
+
+        ioctl(m_Fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(m_Fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+      }
+
+      CounterGroup(const CounterGroup&)            = delete;
+      CounterGroup& operator=(const CounterGroup&) = delete;
+
+      ~CounterGroup() { close_all(); }
+
+      [[nodiscard]] bool valid() const noexcept { return m_Fds[0] >= 0; }
+
+      [[nodiscard]] int error() const noexcept { return m_Error; }
+
+      [[nodiscard]] HardwareCounts read() const noexcept {
+        // The group read format is the number of events followed by their values
+        std::array<std::uint64_t, 1 + events.size()> buffer{};
+        if (!valid() || ::read(m_Fds[0], buffer.data(), sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer))) {
+          return {};
+        }
+        return {buffer[1], buffer[2], buffer[3], buffer[4]};
+      }
+
+     private:
+      std::array<int, events.size()> m_Fds{};      ///< The file descriptors, the first one is the group leader.
+      int                            m_Error = 0;  ///< The errno of a failed perf_event_open.
+
+      void close_all() noexcept {
+        for (auto& fd : m_Fds) {
+          if (fd >= 0) {
+            close(fd);
+            fd = -1;
+          }
+        }
+      }
+    };
+
+    CounterGroup& thread_counters() {
+      thread_local CounterGroup counters;
+      return counters;
+    }
+#endif
+
+  }  // namespace
+
+#ifdef __linux__
+  class ThreadCounters::Group : public CounterGroup {
+   public:
+    using CounterGroup::CounterGroup;
+  };
+#else
+  class ThreadCounters::Group {};
+#endif
+
+  bool enable_hardware_counters(const bool enable) {
+    if (!enable) {
+      enabled = false;
+      return false;
+    }
+
+#ifdef __linux__
+    if (const auto& counters = thread_counters(); !counters.valid()) {
+      std::cerr << "Hardware performance counters are not available: " << std::strerror(counters.error())
+                << ", check /proc/sys/kernel/perf_event_paranoid\n";
+      enabled = false;
+      return false;
+    }
+    enabled = true;
+    return true;
+#else
+    std::cerr << "Hardware performance counters are only supported on Linux\n";
+    return false;
+#endif
+  }
+
+  bool hardware_counters_enabled() noexcept {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  HardwareCounts read_hardware_counters() noexcept {
+#ifdef __linux__
+    if (hardware_counters_enabled()) {
+      return thread_counters().read();
+    }
+#endif
+    return {};
+  }
+
+  ThreadCounters::ThreadCounters([[maybe_unused]] const std::span<const int> threads) {
+#ifdef __linux__
+    if (!hardware_counters_enabled()) {
+      return;
+    }
+
+    for (const int thread : threads) {
+      if (auto group = std::make_unique<Group>(thread); group->valid()) {
+        m_Groups.push_back(std::move(group));
+      }
+    }
+#endif
+  }
+
+  ThreadCounters::~ThreadCounters() = default;
+
+  HardwareCounts ThreadCounters::read() const noexcept {
+    HardwareCounts counts;
+#ifdef __linux__
+    for (const auto& group : m_Groups) {
+      counts += group->read();
+    }
+#endif
+    return counts;
+  }
+
+}  // namespace utilities
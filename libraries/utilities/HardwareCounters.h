@@ -0,0 +1,86 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace utilities {
+
+  /**
+   * @struct HardwareCounts
+   * @brief The values of the hardware performance counters, or the difference of two readings.
+   */
+  struct HardwareCounts {
+    std::uint64_t cycles        = 0;  ///< The CPU cycles.
+    std::uint64_t instructions  = 0;  ///< The retired instructions.
+    std::uint64_t cache_misses  = 0;  ///< The misses of the last level cache.
+    std::uint64_t branch_misses = 0;  ///< The mispredicted branches.
+
+    HardwareCounts& operator+=(const HardwareCounts& other) noexcept {
+      cycles += other.cycles;
+      instructions += other.instructions;
+      cache_misses += other.cache_misses;
+      branch_misses += other.branch_misses;
+      return *this;
+    }
+
+    [[nodiscard]] HardwareCounts operator-(const HardwareCounts& other) const noexcept {
+      return {cycles - other.cycles, instructions - other.instructions, cache_misses - other.cache_misses, branch_misses - other.branch_misses};
+    }
+  };
+
+  /**
+   * @brief Enables or disables the sampling of the hardware performance counters.
+   *
+   * The counters are read with perf_event_open on Linux and count the user space events of the reading thread.
+   * Each thread opens its counters on its first reading.
+   *
+   * @param enable Whether the counters should be read.
+   * @return True if the counters are enabled, false if they are disabled or not available, e.g. due to the
+   *         perf_event_paranoid setting or a virtual machine without performance monitoring unit.
+   */
+  bool enable_hardware_counters(bool enable);
+
+  /**
+   * @brief Checks if the hardware performance counters are enabled.
+   */
+  [[nodiscard]] bool hardware_counters_enabled() noexcept;
+
+  /**
+   * @brief Reads the hardware performance counters of the calling thread, zero if they are not enabled.
+   */
+  [[nodiscard]] HardwareCounts read_hardware_counters() noexcept;
+
+  /**
+   * @class ThreadCounters
+   * @brief The hardware performance counters of a set of threads, e.g. of the threads of a task scheduler.
+   *
+   * A counter group is opened for every thread, so the work of the workers running the tasks of a thread is
+   * counted as well. The counts start at zero on the construction. Nothing is opened if the counters are disabled.
+   */
+  class ThreadCounters {
+   public:
+    /**
+     * @param threads The system thread ids, see TaskScheduler::thread_ids().
+     */
+    explicit ThreadCounters(std::span<const int> threads);
+
+    ThreadCounters(const ThreadCounters&)            = delete;
+    ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+    ~ThreadCounters();
+
+    /**
+     * @brief Returns the sum of the counts of all threads since the construction.
+     */
+    [[nodiscard]] HardwareCounts read() const noexcept;
+
+   private:
+    class Group;
+
+    std::vector<std::unique_ptr<Group>> m_Groups;  ///< The counter group of every thread which could be opened.
+  };
+
+}  // namespace utilities
@@ -0,0 +1,142 @@
+#include "MemoryPlacement.h"
+
+// STL includes
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace utilities {
+
+  namespace {
+
+    constexpr std::size_t huge_page_size = std::size_t{2} << 20;  // The size of a transparent huge page on x86-64
+    constexpr std::size_t alignment      = 64;                    // The alignment of the standard allocation
+
+    using node_mask_t = std::array<unsigned long, 16>;
+
+    constexpr std::size_t bits_per_word = sizeof(unsigned long) * CHAR_BIT;
+
+    /**
+     * @brief Returns the online NUMA nodes as bit mask, an empty mask if they cannot be determined.
+     */
+    node_mask_t online_nodes() noexcept {
+      node_mask_t mask{};
+
+      // The list has the format of e.g. "0-1,3"
+      std::ifstream file("/sys/devices/system/node/online");
+      std::string   list;
+      if (!file || !std::getline(file, list)) {
+        return mask;
+      }
+
+      std::istringstream ranges(list);
+      std::string        range;
+      while (std::getline(ranges, range, ',')) {
+        try {
+          const auto         dash  = range.find('-');
+          const unsigned int first = std::stoul(range.substr(0, dash));
+          const unsigned int last  = (dash == std::string::npos) ? first : std::stoul(range.substr(dash + 1));
+          for (unsigned int node = first; node <= last && node < mask.size() * bits_per_word; ++node) {
+            mask[node / bits_per_word] |= 1UL << (node % bits_per_word);
+          }
+        } catch (const std::exception&) {
+          return node_mask_t{};
+        }
+      }
+      return mask;
+    }
+
+    [[nodiscard]] std::size_t round_up(std::size_t bytes, std::size_t multiple) noexcept {
+      return (bytes + multiple - 1) / multiple * multiple;
+    }
+
+  }  // namespace
+
+  MemoryPlacement parse_memory_placement(const std::string& name) {
+    using enum MemoryPlacement;
+    if (name == "default") {
+      return Default;
+    }
+    if (name == "hugepages") {
+      return HugePages;
+    }
+    if (name == "interleave") {
+      return Interleave;
+    }
+    if (name == "local") {
+      return Local;
+    }
+    throw std::invalid_argument("Unknown memory placement " + name + ", use default, hugepages, interleave or local");
+  }
+
+  unsigned int numa_nodes() noexcept {
+    unsigned int count = 0;
+    for (const auto word : online_nodes()) {
+      count += static_cast<unsigned int>(__builtin_popcountl(word));
+    }
+    return (count > 0) ? count : 1;
+  }
+
+  std::pair<void*, bool> allocate_placed(const std::size_t bytes, const MemoryPlacement placement) {
+#ifdef __linux__
+    if (placement != MemoryPlacement::Default) {
+      // Map an extra huge page, so the start can be aligned to a huge page
+      const std::size_t length = round_up(bytes, huge_page_size);
+      void*             mapped = mmap(nullptr, length + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+      if (mapped != MAP_FAILED) {
+        const auto        address = reinterpret_cast<std::uintptr_t>(mapped);
+        const auto        aligned = round_up(address, huge_page_size);
+        const std::size_t head    = aligned - address;
+
+        if (head > 0) {
+          munmap(mapped, head);
+        }
+        if (huge_page_size - head > 0) {
+          munmap(reinterpret_cast<void*>(aligned + length), huge_page_size - head);
+        }
+
+        auto* data = reinterpret_cast<void*>(aligned);
+
+        // Both are hints, the memory is still usable if the kernel does not support them
+        madvise(data, length, MADV_HUGEPAGE);
+        if (placement == MemoryPlacement::Interleave) {
+          const node_mask_t nodes = online_nodes();
+          syscall(SYS_mbind, data, length, MPOL_INTERLEAVE, nodes.data(), nodes.size() * bits_per_word, 0);
+        }
+
+        return {data, true};
+      }
+    }
+#endif
+
+    return {::operator new(bytes, std::align_val_t{alignment}), false};
+  }
+
+  void release_placed(void* data, const std::size_t bytes, const bool mapped) noexcept {
+    if (data == nullptr) {
+      return;
+    }
+
+#ifdef __linux__
+    if (mapped) {
+      munmap(data, round_up(bytes, huge_page_size));
+      return;
+    }
+#endif
+
+    ::operator delete(data, std::align_val_t{alignment});
+  }
+
+}  // namespace utilities
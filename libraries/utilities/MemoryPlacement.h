@@ -0,0 +1,110 @@
+#pragma once
+
+// STL includes
+#include <cstddef>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace utilities {
+
+  /**
+   * @brief The placement of large, read-mostly arrays in memory.
+   */
+  enum class MemoryPlacement {
+    Default,     ///< The arrays are allocated with the standard allocator.
+    HugePages,   ///< The arrays are backed by transparent huge pages, which reduces the TLB misses of a sweep.
+    Interleave,  ///< Huge pages, interleaved over all NUMA nodes, which balances the memory bandwidth.
+    Local        ///< Huge pages, placed on the node of the worker which first touches them, the workers are pinned.
+  };
+
+  /**
+   * @brief Parses a memory placement: default, hugepages, interleave or local.
+   *
+   * @throws std::invalid_argument if the name is unknown.
+   */
+  [[nodiscard]] MemoryPlacement parse_memory_placement(const std::string& name);
+
+  /**
+   * @brief Returns the number of online NUMA nodes, 1 if it cannot be determined.
+   */
+  [[nodiscard]] unsigned int numa_nodes() noexcept;
+
+  /**
+   * @brief Allocates memory with the given placement, the pages are not touched.
+   *
+   * Except for the default placement, the memory is mapped directly and aligned to the huge page size, so a page is
+   * only assigned to a NUMA node by the first write into it. If the mapping fails, the standard allocator is used.
+   *
+   * @param bytes The number of bytes.
+   * @param placement The placement of the memory.
+   * @return The memory and whether it was mapped, which has to be handed over to release_placed().
+   * @throws std::bad_alloc if no memory is available.
+   */
+  [[nodiscard]] std::pair<void*, bool> allocate_placed(std::size_t bytes, MemoryPlacement placement);
+
+  /**
+   * @brief Releases memory of allocate_placed().
+   */
+  void release_placed(void* data, std::size_t bytes, bool mapped) noexcept;
+
+  /**
+   * @class PlacedArray
+   * @brief A fixed size, uninitialized array of trivial values with a memory placement.
+   *
+   * The values are not initialized, so the first write, e.g. by the worker which later reads a slice, decides the
+   * NUMA node of a page.
+   */
+  template <typename T>
+  class PlacedArray {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>);
+
+   public:
+    PlacedArray() = default;
+
+    PlacedArray(std::size_t size, MemoryPlacement placement)
+      : m_Size(size) {
+      if (size > 0) {
+        const auto [data, mapped] = allocate_placed(size * sizeof(T), placement);
+
+        m_Data   = static_cast<T*>(data);
+        m_Mapped = mapped;
+      }
+    }
+
+    PlacedArray(const PlacedArray&)            = delete;
+    PlacedArray& operator=(const PlacedArray&) = delete;
+
+    PlacedArray(PlacedArray&& other) noexcept
+      : m_Data(std::exchange(other.m_Data, nullptr))
+      , m_Size(std::exchange(other.m_Size, 0))
+      , m_Mapped(other.m_Mapped) {}
+
+    PlacedArray& operator=(PlacedArray&& other) noexcept {
+      if (this != &other) {
+        release_placed(m_Data, m_Size * sizeof(T), m_Mapped);
+        m_Data   = std::exchange(other.m_Data, nullptr);
+        m_Size   = std::exchange(other.m_Size, 0);
+        m_Mapped = other.m_Mapped;
+      }
+      return *this;
+    }
+
+    ~PlacedArray() { release_placed(m_Data, m_Size * sizeof(T), m_Mapped); }
+
+    [[nodiscard]] T* data() noexcept { return m_Data; }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_Size; }
+
+    [[nodiscard]] std::span<T> span() noexcept { return {m_Data, m_Size}; }
+
+    [[nodiscard]] std::span<const T> span() const noexcept { return {m_Data, m_Size}; }
+
+   private:
+    T*          m_Data   = nullptr;  ///< The values.
+    std::size_t m_Size   = 0;        ///< The number of values.
+    bool        m_Mapped = false;    ///< Whether the memory is mapped directly instead of the standard allocator.
+  };
+
+}  // namespace utilities
@@ -0,0 +1,159 @@
+#pragma once
+
+// STL includes
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// includes
+#include "HardwareCounters.h"
+
+/**
+ * The timing counters are compiled in if PHYLINO_PROFILING is defined, which is controlled by the CMake option of
+ * the same name. Otherwise the macros expand to nothing and the counters stay empty.
+ */
+#ifdef PHYLINO_PROFILING
+#define PHYLINO_PROFILE_SCOPE(timer, counter) ::utilities::ScopedTimer timer(counter)
+#define PHYLINO_PROFILE_RECOMPUTED(timer, recomputed) timer.set_recomputed(recomputed)
+#else
+#define PHYLINO_PROFILE_SCOPE(timer, counter)
+#define PHYLINO_PROFILE_RECOMPUTED(timer, recomputed)
+#endif
+
+namespace utilities {
+
+  /**
+   * @brief Checks if the timing counters are compiled in.
+   */
+  constexpr bool profiling_enabled() noexcept {
+#ifdef PHYLINO_PROFILING
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * @class TimingCounter
+   * @brief Counts the calls of a code section, how often it recomputed its result and the time spent in it.
+   *
+   * The durations are additionally filled into a histogram with logarithmic bins: bin i holds the calls which took
+   * between 2^(i-1) and 2^i nanoseconds. If the hardware performance counters are enabled, their differences are
+   * summed up as well.
+   */
+  class TimingCounter {
+   public:
+    static constexpr std::size_t number_of_bins = 48;
+
+    /**
+     * @brief Records a single call.
+     *
+     * @param recomputed Whether the call recomputed its result, i.e. was not served from the cache.
+     * @param nanoseconds The duration of the call.
+     * @param hardware The hardware performance counts of the call.
+     */
+    void record(bool recomputed, std::uint64_t nanoseconds, const HardwareCounts& hardware = {}) noexcept {
+      ++m_Calls;
+      m_Recomputes += recomputed;
+      m_TotalTime += nanoseconds;
+      ++m_Histogram[std::min<std::size_t>(std::bit_width(nanoseconds), number_of_bins - 1)];
+      m_Hardware += hardware;
+    }
+
+    void reset() noexcept { *this = TimingCounter{}; }
+
+    [[nodiscard]] std::uint64_t calls() const noexcept { return m_Calls; }
+
+    [[nodiscard]] std::uint64_t recomputes() const noexcept { return m_Recomputes; }
+
+    [[nodiscard]] std::uint64_t total_time() const noexcept { return m_TotalTime; }
+
+    [[nodiscard]] const std::array<std::uint64_t, number_of_bins>& histogram() const noexcept { return m_Histogram; }
+
+    [[nodiscard]] const HardwareCounts& hardware() const noexcept { return m_Hardware; }
+
+   private:
+    std::uint64_t                             m_Calls      = 0;  ///< The number of calls.
+    std::uint64_t                             m_Recomputes = 0;  ///< The number of calls which recomputed their result.
+    std::uint64_t                             m_TotalTime  = 0;  ///< The cumulative time in nanoseconds.
+    std::array<std::uint64_t, number_of_bins> m_Histogram{};     ///< The histogram of the call durations.
+    HardwareCounts                            m_Hardware;        ///< The cumulative hardware performance counts.
+  };
+
+  /**
+   * @class ComponentProfile
+   * @brief The timing counters of a component, in total and per data set.
+   */
+  class ComponentProfile {
+   public:
+    static constexpr std::size_t max_data_sets = 9;
+
+    explicit ComponentProfile(std::string name)
+      : m_Name(std::move(name)) {}
+
+    [[nodiscard]] const std::string& name() const noexcept { return m_Name; }
+
+    [[nodiscard]] TimingCounter& total() noexcept { return m_Total; }
+
+    [[nodiscard]] const TimingCounter& total() const noexcept { return m_Total; }
+
+    /**
+     * @brief Returns the counter of a data set, e.g. a detector.
+     *
+     * @param idx The index of the data set, smaller than max_data_sets.
+     */
+    [[nodiscard]] TimingCounter& data_set(std::size_t idx) noexcept { return m_DataSets[idx]; }
+
+    [[nodiscard]] const TimingCounter& data_set(std::size_t idx) const noexcept { return m_DataSets[idx]; }
+
+    void reset() noexcept {
+      m_Total.reset();
+      for (auto& counter : m_DataSets) {
+        counter.reset();
+      }
+    }
+
+   private:
+    std::string                              m_Name;      ///< The name of the component.
+    TimingCounter                            m_Total;     ///< The counter of the whole component.
+    std::array<TimingCounter, max_data_sets> m_DataSets;  ///< The counters per data set.
+  };
+
+  /**
+   * @class ScopedTimer
+   * @brief Records the time between its construction and destruction in a timing counter.
+   *
+   * The hardware performance counters are read outside the timed section, so the system calls do not distort the
+   * durations.
+   */
+  class ScopedTimer {
+   public:
+    explicit ScopedTimer(TimingCounter& counter) noexcept
+      : m_Counter(counter)
+      , m_StartCounts(read_hardware_counters())
+      , m_Start(std::chrono::steady_clock::now()) {}
+
+    ScopedTimer(const ScopedTimer&)            = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer() {
+      const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Start);
+      m_Counter.record(m_Recomputed, static_cast<std::uint64_t>(duration.count()), read_hardware_counters() - m_StartCounts);
+    }
+
+    /**
+     * @brief Sets whether the timed call recomputed its result. Defaults to true.
+     */
+    void set_recomputed(bool recomputed) noexcept { m_Recomputed = recomputed; }
+
+   private:
+    TimingCounter&                        m_Counter;            ///< The counter the time is recorded in.
+    HardwareCounts                        m_StartCounts;        ///< The hardware performance counts at the start.
+    std::chrono::steady_clock::time_point m_Start;              ///< The start of the timed section.
+    bool                                  m_Recomputed = true;  ///< Whether the call recomputed its result.
+  };
+
+}  // namespace utilities
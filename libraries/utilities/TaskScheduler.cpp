@@ -0,0 +1,288 @@
+#include "TaskScheduler.h"
+
+// STL includes
+#include <latch>
+#include <stdexcept>
+#include <utility>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace utilities {
+
+  namespace {
+
+    /**
+     * @brief The scheduler and queue of a worker thread, a nullptr for threads outside of a pool.
+     */
+    struct WorkerIdentity {
+      const TaskScheduler* scheduler = nullptr;
+      std::size_t          queue     = 0;
+    };
+
+    thread_local WorkerIdentity current_worker;
+
+    /**
+     * @brief Returns the system id of the calling thread, -1 if it is not available.
+     */
+    int system_thread_id() noexcept {
+#ifdef __linux__
+      return static_cast<int>(syscall(SYS_gettid));
+#else
+      return -1;
+#endif
+    }
+
+  }  // namespace
+
+  TaskScheduler::TaskScheduler(const unsigned int threads, const bool pin) {
+    if (threads == 0) {
+      throw std::invalid_argument("The task scheduler needs at least one thread");
+    }
+
+#ifdef __linux__
+    if (pin) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+          if (CPU_ISSET(cpu, &set)) {
+            m_Cpus.push_back(cpu);
+          }
+        }
+      }
+    }
+#endif
+
+    // One queue per worker and the shared queue of the other threads
+    for (unsigned int i = 0; i < threads; ++i) {
+      m_Queues.push_back(std::make_unique<Queue>());
+    }
+
+    // The workers store their ids before the constructor returns
+    m_Ids.resize(threads - 1, -1);
+    std::latch started(threads - 1);
+
+    m_Workers.reserve(threads - 1);
+    for (unsigned int i = 0; i + 1 < threads; ++i) {
+      m_Workers.emplace_back([this, i, &started] {
+        m_Ids[i] = system_thread_id();
+        started.count_down();
+        worker_loop(i);
+      });
+    }
+    started.wait();
+  }
+
+  std::vector<int> TaskScheduler::thread_ids() const {
+    std::vector<int> ids = {system_thread_id()};
+    ids.insert(ids.end(), m_Ids.begin(), m_Ids.end());
+    if (std::ranges::find(ids, -1) != ids.end()) {
+      return {};
+    }
+    return ids;
+  }
+
+  TaskScheduler::~TaskScheduler() {
+    {
+      const std::scoped_lock lock(m_SleepMutex);
+      m_Stop = true;
+    }
+    m_Wake.notify_all();
+
+    for (auto& worker : m_Workers) {
+      worker.join();
+    }
+  }
+
+  std::size_t TaskScheduler::own_queue() const noexcept {
+    return (current_worker.scheduler == this) ? current_worker.queue : m_Workers.size();
+  }
+
+  TaskScheduler::Task::Task(Task&& other) noexcept
+    : m_Operations(std::exchange(other.m_Operations, nullptr)) {
+    if (m_Operations) {
+      m_Operations->relocate(other.m_Buffer, m_Buffer);
+    }
+  }
+
+  TaskScheduler::Task& TaskScheduler::Task::operator=(Task&& other) noexcept {
+    if (this != &other) {
+      reset();
+      m_Operations = std::exchange(other.m_Operations, nullptr);
+      if (m_Operations) {
+        m_Operations->relocate(other.m_Buffer, m_Buffer);
+      }
+    }
+    return *this;
+  }
+
+  void TaskScheduler::Task::reset() noexcept {
+    if (m_Operations) {
+      std::exchange(m_Operations, nullptr)->destroy(m_Buffer);
+    }
+  }
+
+  void TaskScheduler::Queue::push_back(Task&& task) {
+    if (size == tasks.size()) {
+      // Unroll the ring into a buffer of twice the size, the oldest task moves to the front
+      std::vector<Task> grown(2 * tasks.size());
+      for (std::size_t i = 0; i < size; ++i) {
+        grown[i] = std::move(tasks[(head + i) & (tasks.size() - 1)]);
+      }
+      tasks = std::move(grown);
+      head  = 0;
+    }
+
+    tasks[(head + size) & (tasks.size() - 1)] = std::move(task);
+    ++size;
+  }
+
+  void TaskScheduler::Queue::pop_back(Task& task) noexcept {
+    --size;
+    task = std::move(tasks[(head + size) & (tasks.size() - 1)]);
+  }
+
+  void TaskScheduler::Queue::pop_front(Task& task) noexcept {
+    task = std::move(tasks[head]);
+    head = (head + 1) & (tasks.size() - 1);
+    --size;
+  }
+
+  void TaskScheduler::submit(Task task) {
+    submit(std::move(task), own_queue());
+  }
+
+  void TaskScheduler::submit(Task task, const std::size_t index) {
+    {
+      auto&                  queue = *m_Queues[index % m_Queues.size()];
+      const std::scoped_lock lock(queue.mutex);
+      queue.push_back(std::move(task));
+    }
+
+    // The counter is increased under the sleep mutex, so a worker checking it before sleeping cannot miss the task
+    {
+      const std::scoped_lock lock(m_SleepMutex);
+      m_Queued.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_Wake.notify_one();
+  }
+
+  bool TaskScheduler::take_task(const std::size_t own, Task& task) {
+    {
+      auto&                  queue = *m_Queues[own];
+      const std::scoped_lock lock(queue.mutex);
+      if (!queue.empty()) {
+        queue.pop_back(task);
+        return true;
+      }
+    }
+
+    // Steal the oldest task of another queue, starting with the next one, so the thieves spread over the queues
+    const std::size_t n = m_Queues.size();
+    for (std::size_t i = 1; i < n; ++i) {
+      auto&                  queue = *m_Queues[(own + i) % n];
+      const std::scoped_lock lock(queue.mutex);
+      if (!queue.empty()) {
+        queue.pop_front(task);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool TaskScheduler::run_pending_task() {
+    Task task;
+    if (!take_task(own_queue(), task)) {
+      return false;
+    }
+
+    m_Queued.fetch_sub(1, std::memory_order_relaxed);
+    task();
+    return true;
+  }
+
+  void TaskScheduler::pin_thread(const std::size_t cpu) const noexcept {
+#ifdef __linux__
+    if (m_Cpus.empty()) {
+      return;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(m_Cpus[cpu % m_Cpus.size()], &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#endif
+  }
+
+  TaskScheduler::CallerPin::CallerPin(const TaskScheduler& scheduler) noexcept {
+#ifdef __linux__
+    static_assert(sizeof(cpu_set_t) <= sizeof(m_Mask));
+
+    if (scheduler.m_Cpus.empty() || scheduler.own_queue() != scheduler.m_Workers.size()) {
+      return;
+    }
+
+    auto* previous = reinterpret_cast<cpu_set_t*>(m_Mask.data());
+    if (sched_getaffinity(0, sizeof(cpu_set_t), previous) == 0) {
+      scheduler.pin_thread(0);
+      m_Pinned = true;
+    }
+#else
+    static_cast<void>(scheduler);
+#endif
+  }
+
+  TaskScheduler::CallerPin::~CallerPin() {
+#ifdef __linux__
+    if (m_Pinned) {
+      sched_setaffinity(0, sizeof(cpu_set_t), reinterpret_cast<const cpu_set_t*>(m_Mask.data()));
+    }
+#endif
+  }
+
+  void TaskScheduler::worker_loop(const std::size_t index) {
+    current_worker = {this, index};
+
+    // The first CPU is left for the thread calling parallel_for()
+    pin_thread(index + 1);
+
+    while (true) {
+      if (run_pending_task()) {
+        continue;
+      }
+
+      std::unique_lock lock(m_SleepMutex);
+      m_Wake.wait(lock, [this] { return m_Stop || m_Queued.load(std::memory_order_relaxed) > 0; });
+      if (m_Stop && m_Queued.load(std::memory_order_relaxed) == 0) {
+        return;
+      }
+    }
+  }
+
+  TaskGroup::~TaskGroup() {
+    try {
+      wait();
+    } catch (...) {
+      // The exception was not retrieved by the owner of the group
+    }
+  }
+
+  void TaskGroup::wait() {
+    while (m_Pending.load(std::memory_order_acquire) > 0) {
+      // Run other tasks instead of blocking, the tasks of the group might be queued behind them
+      if (!m_Scheduler.run_pending_task()) {
+        std::this_thread::yield();
+      }
+    }
+
+    const std::scoped_lock lock(m_ExceptionMutex);
+    if (m_Exception) {
+      std::rethrow_exception(std::exchange(m_Exception, nullptr));
+    }
+  }
+
+}  // namespace utilities
@@ -0,0 +1,384 @@
+#pragma once
+
+// STL includes
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace utilities {
+
+  /**
+   * @class TaskScheduler
+   * @brief A work-stealing thread pool shared by all parallel features of a process.
+   *
+   * Every worker owns a task queue, it runs its own tasks last in, first out and steals the oldest tasks of the
+   * other queues if its queue is empty. Tasks submitted by threads outside of the pool go into a separate queue.
+   * A thread waiting for a TaskGroup runs pending tasks instead of blocking, so parallel features can be nested, e.g.
+   * a parallel loop inside of a task, without starting more threads than the scheduler was sized for.
+   *
+   * The chunks of parallel_for() are queued in a fixed order on the queues of the workers and on the shared queue,
+   * which the threads outside of the pool, e.g. the main thread, run while they wait. The same loop therefore runs
+   * the same chunk on the same thread unless it is stolen. With pinned threads, the memory first touched by a chunk
+   * is local to the thread which processes the chunk later. A thread outside of the pool is only pinned while it
+   * runs a parallel_for(), afterward its original affinity is restored, so the threads it starts later are not
+   * restricted to a single CPU.
+   *
+   * The tasks are stored in place in preallocated ring buffers, so submitting a task, e.g. a chunk of parallel_for(),
+   * does not allocate once the rings are large enough for the number of pending tasks.
+   */
+  class TaskScheduler {
+   public:
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param threads The number of threads running tasks, including the thread waiting for them. With a single
+     *                thread, no worker is started and all tasks run on the submitting thread.
+     * @param pin Whether the workers are pinned to consecutive CPUs of the process. The first CPU is left for the
+     *            thread calling parallel_for(), which is pinned during the loop.
+     * @throws std::invalid_argument if the number of threads is zero.
+     */
+    explicit TaskScheduler(unsigned int threads, bool pin = false);
+
+    TaskScheduler(const TaskScheduler&)            = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /**
+     * @brief Stops the worker threads after all submitted tasks ran.
+     */
+    ~TaskScheduler();
+
+    /**
+     * @brief Returns the number of threads running tasks, including the waiting thread.
+     */
+    [[nodiscard]] unsigned int concurrency() const noexcept { return static_cast<unsigned int>(m_Workers.size()) + 1; }
+
+    /**
+     * @brief Checks whether tasks run on more than the submitting thread.
+     */
+    [[nodiscard]] bool parallel() const noexcept { return !m_Workers.empty(); }
+
+    /**
+     * @brief Returns the system thread ids of the calling thread and of the workers, i.e. of all threads running the
+     *        tasks the calling thread waits for. Empty if the ids are not available on the platform.
+     */
+    [[nodiscard]] std::vector<int> thread_ids() const;
+
+    /**
+     * @brief Calls body(begin, end) for consecutive chunks of [0, N) in parallel and waits for all of them.
+     *
+     * The range is split into a few chunks per thread, but no chunk is smaller than the grain size, so a chunk is
+     * worth a task. The chunks are queued on the threads in turn and the calling thread runs tasks while it waits.
+     * With a single thread, the body is called once for the whole range.
+     *
+     * @param N The size of the range.
+     * @param grain The minimal number of indices per chunk.
+     * @param body The function called with the begin and end index of a chunk.
+     */
+    template <typename Body>
+    void parallel_for(std::size_t N, std::size_t grain, Body&& body);
+
+   private:
+    friend class TaskGroup;
+
+    /**
+     * @class Task
+     * @brief A move-only callable which stores small functions in place.
+     *
+     * Unlike std::function, whose buffer only holds two pointers, the buffer fits the tasks of TaskGroup and the
+     * chunks of parallel_for(). Larger functions, or functions which might throw when moved, are put on the heap.
+     */
+    class Task {
+     public:
+      static constexpr std::size_t buffer_size = 64;  ///< The size of the in-place buffer.
+
+      Task() noexcept = default;
+
+      template <typename F>
+        requires(!std::is_same_v<std::remove_cvref_t<F>, Task>)
+      explicit Task(F&& function);
+
+      Task(Task&& other) noexcept;
+      Task& operator=(Task&& other) noexcept;
+      ~Task() { reset(); }
+
+      Task(const Task&)            = delete;
+      Task& operator=(const Task&) = delete;
+
+      void operator()() { m_Operations->invoke(m_Buffer); }
+
+      /**
+       * @brief Destroys the stored function.
+       */
+      void reset() noexcept;
+
+     private:
+      /**
+       * @brief The type-erased operations of the stored function.
+       */
+      struct Operations {
+        void (*invoke)(void* buffer);
+        void (*relocate)(void* from, void* to) noexcept;  ///< Moves the function to another buffer and destroys the source.
+        void (*destroy)(void* buffer) noexcept;
+      };
+
+      template <typename F>
+      static constexpr bool stored_in_place = sizeof(F) <= buffer_size && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+
+      template <typename F>
+      static constexpr Operations operations_for = {
+        [](void* buffer) { (*std::launder(reinterpret_cast<F*>(buffer)))(); },
+        [](void* from, void* to) noexcept {
+          F* source = std::launder(reinterpret_cast<F*>(from));
+          ::new (to) F(std::move(*source));
+          source->~F();
+        },
+        [](void* buffer) noexcept { std::launder(reinterpret_cast<F*>(buffer))->~F(); }};
+
+      template <typename F>
+      static constexpr Operations heap_operations_for = {
+        [](void* buffer) { (**std::launder(reinterpret_cast<F**>(buffer)))(); },
+        [](void* from, void* to) noexcept { ::new (to) F*(*std::launder(reinterpret_cast<F**>(from))); },
+        [](void* buffer) noexcept { delete *std::launder(reinterpret_cast<F**>(buffer)); }};
+
+      alignas(std::max_align_t) std::byte m_Buffer[buffer_size];  ///< The function or a pointer to it.
+      const Operations*                   m_Operations = nullptr;  ///< The operations, a nullptr if empty.
+    };
+
+    /**
+     * @brief A task queue, guarded by its own mutex, so a steal only contends with the owner of the queue.
+     *
+     * The tasks are kept in a ring buffer, which only grows if more tasks are pending than ever before.
+     */
+    struct Queue {
+      static constexpr std::size_t initial_capacity = 64;  ///< The initial number of tasks, a power of two.
+
+      Queue()
+        : tasks(initial_capacity) {}
+
+      void push_back(Task&& task);
+      void pop_back(Task& task) noexcept;
+      void pop_front(Task& task) noexcept;
+
+      [[nodiscard]] bool empty() const noexcept { return size == 0; }
+
+      std::mutex        mutex;     ///< Guards the tasks.
+      std::vector<Task> tasks;     ///< The ring buffer of the tasks, its size is a power of two.
+      std::size_t       head = 0;  ///< The index of the oldest pending task.
+      std::size_t       size = 0;  ///< The number of pending tasks, the owner takes from the back.
+    };
+
+    /**
+     * @brief Queues a task on the queue of the calling worker, or on the shared queue for other threads.
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Queues a task on the given queue.
+     *
+     * @param queue The queue index modulo the number of threads, the last queue is the shared one.
+     */
+    void submit(Task task, std::size_t queue);
+
+    /**
+     * @brief Pins the calling thread to a CPU, the CPU index runs over the CPUs the process may use.
+     */
+    void pin_thread(std::size_t cpu) const noexcept;
+
+    /**
+     * @class CallerPin
+     * @brief Pins a thread outside of the pool to the first CPU of the scheduler and restores its affinity on destruction.
+     *
+     * Workers and threads of an unpinned scheduler are not changed. The previous affinity is stored in place, so the
+     * pin does not allocate.
+     */
+    class CallerPin {
+     public:
+      explicit CallerPin(const TaskScheduler& scheduler) noexcept;
+      ~CallerPin();
+
+      CallerPin(const CallerPin&)            = delete;
+      CallerPin& operator=(const CallerPin&) = delete;
+
+     private:
+      std::array<unsigned long, 16> m_Mask{};         ///< The previous affinity mask, large enough for a cpu_set_t.
+      bool                          m_Pinned = false;  ///< Whether the thread was pinned and its mask is restored.
+    };
+
+    /**
+     * @brief Runs a pending task of the calling thread or steals one of another queue.
+     *
+     * @return Whether a task ran.
+     */
+    bool run_pending_task();
+
+    /**
+     * @brief Takes a task, the one of the own queue first, then the oldest ones of the other queues.
+     */
+    bool take_task(std::size_t own, Task& task);
+
+    /**
+     * @brief The loop of a worker thread, it sleeps if no queue has a task.
+     */
+    void worker_loop(std::size_t index);
+
+    /**
+     * @brief Returns the queue index of the calling thread, the shared queue for threads outside of the pool.
+     */
+    [[nodiscard]] std::size_t own_queue() const noexcept;
+
+    std::vector<std::unique_ptr<Queue>> m_Queues;   ///< The queue of every worker, followed by the shared queue.
+    std::vector<std::thread>            m_Workers;  ///< The worker threads.
+    std::vector<int>                    m_Cpus;     ///< The CPUs the threads are pinned to, empty if not pinned.
+    std::vector<int>                    m_Ids;      ///< The system thread ids of the workers.
+
+    std::mutex               m_SleepMutex;    ///< Guards the sleeping of the workers.
+    std::condition_variable  m_Wake;          ///< Wakes up sleeping workers if a task is submitted.
+    std::atomic<std::size_t> m_Queued{0};     ///< The number of queued tasks which did not start yet.
+    bool                     m_Stop = false;  ///< Whether the workers should exit, guarded by the sleep mutex.
+  };
+
+  /**
+   * @class TaskGroup
+   * @brief A set of tasks on a scheduler which are waited for together.
+   *
+   * The waiting thread runs pending tasks of the scheduler until all tasks of the group finished. The first
+   * exception thrown by a task is rethrown by wait(), the remaining tasks still run.
+   */
+  class TaskGroup {
+   public:
+    explicit TaskGroup(TaskScheduler& scheduler) noexcept
+      : m_Scheduler(scheduler) {}
+
+    TaskGroup(const TaskGroup&)            = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * @brief Waits for the remaining tasks, their exceptions are discarded.
+     */
+    ~TaskGroup();
+
+    /**
+     * @brief Runs a task of the group, on the calling thread if the scheduler has no workers.
+     *
+     * The task has to stay valid until wait() returns, i.e. captured references have to outlive the group.
+     */
+    template <typename Task>
+    void run(Task&& task);
+
+    /**
+     * @brief Runs a task of the group from the given queue, it is only taken by another thread if the owner of the
+     *        queue is busy.
+     *
+     * @param queue The queue index modulo the number of threads, the last queue is the one of the threads outside
+     *              of the pool.
+     */
+    template <typename Task>
+    void run_on(std::size_t queue, Task&& task);
+
+    /**
+     * @brief Waits for all tasks of the group and rethrows the first exception thrown by one of them.
+     */
+    void wait();
+
+   private:
+    /**
+     * @brief Calls the task and stores its exception.
+     */
+    template <typename Task>
+    void execute(Task& task) noexcept;
+
+    TaskScheduler&           m_Scheduler;       ///< The scheduler running the tasks.
+    std::atomic<std::size_t> m_Pending{0};      ///< The number of tasks which did not finish yet.
+    std::mutex               m_ExceptionMutex;  ///< Guards the exception.
+    std::exception_ptr       m_Exception;       ///< The first exception thrown by a task.
+  };
+
+  template <typename Task>
+  void TaskGroup::execute(Task& task) noexcept {
+    try {
+      task();
+    } catch (...) {
+      const std::scoped_lock lock(m_ExceptionMutex);
+      if (!m_Exception) {
+        m_Exception = std::current_exception();
+      }
+    }
+  }
+
+  template <typename Task>
+  void TaskGroup::run(Task&& task) {
+    if (!m_Scheduler.parallel()) {
+      execute(task);
+      return;
+    }
+
+    m_Pending.fetch_add(1, std::memory_order_relaxed);
+    m_Scheduler.submit(TaskScheduler::Task([this, task = std::forward<Task>(task)]() mutable {
+      execute(task);
+      m_Pending.fetch_sub(1, std::memory_order_release);
+    }));
+  }
+
+  template <typename Task>
+  void TaskGroup::run_on(const std::size_t queue, Task&& task) {
+    if (!m_Scheduler.parallel()) {
+      execute(task);
+      return;
+    }
+
+    m_Pending.fetch_add(1, std::memory_order_relaxed);
+    m_Scheduler.submit(TaskScheduler::Task([this, task = std::forward<Task>(task)]() mutable {
+                         execute(task);
+                         m_Pending.fetch_sub(1, std::memory_order_release);
+                       }),
+                       queue);
+  }
+
+  template <typename F>
+    requires(!std::is_same_v<std::remove_cvref_t<F>, TaskScheduler::Task>)
+  TaskScheduler::Task::Task(F&& function) {
+    using function_t = std::decay_t<F>;
+    if constexpr (stored_in_place<function_t>) {
+      ::new (static_cast<void*>(m_Buffer)) function_t(std::forward<F>(function));
+      m_Operations = &operations_for<function_t>;
+    } else {
+      ::new (static_cast<void*>(m_Buffer)) function_t*(new function_t(std::forward<F>(function)));
+      m_Operations = &heap_operations_for<function_t>;
+    }
+  }
+
+  template <typename Body>
+  void TaskScheduler::parallel_for(const std::size_t N, const std::size_t grain, Body&& body) {
+    if (N == 0) {
+      return;
+    }
+
+    // A few chunks per thread balance the load if the chunks take different times
+    const std::size_t max_chunks = 4 * static_cast<std::size_t>(concurrency());
+    const std::size_t chunks     = std::clamp<std::size_t>(N / std::max<std::size_t>(grain, 1), 1, max_chunks);
+    if (chunks == 1 || !parallel()) {
+      body(std::size_t{0}, N);
+      return;
+    }
+
+    // The chunks of the shared queue run on the same CPU in every loop, e.g. after a first-touch pass
+    const CallerPin pin(*this);
+
+    TaskGroup group(*this);
+    for (std::size_t c = 0; c < chunks; ++c) {
+      group.run_on(c, [&body, begin = c * N / chunks, end = (c + 1) * N / chunks] { body(begin, end); });
+    }
+    group.wait();
+  }
+
+}  // namespace utilities
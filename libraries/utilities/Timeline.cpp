@@ -0,0 +1,134 @@
+#include "Timeline.h"
+
+// STL includes
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <stdexcept>
+
+namespace utilities {
+
+  namespace detail {
+    std::atomic<bool> timeline_active{false};
+  }
+
+  namespace {
+
+    /**
+     * @brief A recorded event, the times are given in nanoseconds since the timeline was enabled.
+     */
+    struct TimelineEvent {
+      const char*  name;
+      const char*  category;
+      std::int64_t start;
+      std::int64_t end;
+    };
+
+    /**
+     * @brief The ring buffer of a thread. Only the owning thread writes, the count is published with release
+     *        semantics, so a reader sees completely written events.
+     */
+    struct ThreadBuffer {
+      explicit ThreadBuffer(std::size_t capacity, std::uint32_t index)
+        : events(std::make_unique<TimelineEvent[]>(capacity))
+        , capacity(capacity)
+        , thread_index(index) {}
+
+      std::unique_ptr<TimelineEvent[]> events;            ///< The events, used as ring buffer.
+      std::size_t                      capacity;          ///< The number of events in the buffer.
+      std::atomic<std::uint64_t>       written{0};        ///< The number of events written so far.
+      std::uint32_t                    thread_index;      ///< The index of the thread in the trace.
+      ThreadBuffer*                    next = nullptr;    ///< The buffer registered before this one.
+    };
+
+    std::atomic<ThreadBuffer*> buffers{nullptr};    // The buffers of all threads as lock-free list
+    std::atomic<std::uint32_t> n_threads{0};        // The number of registered threads
+    std::atomic<std::size_t>   buffer_capacity{0};  // The capacity of new buffers
+
+    const auto epoch = std::chrono::steady_clock::now();
+
+    ThreadBuffer* register_thread() {
+      auto* buffer = new ThreadBuffer(buffer_capacity.load(), n_threads.fetch_add(1));
+
+      // The buffers live until the end of the program, so the events of finished threads can still be written
+      buffer->next = buffers.load();
+      while (!buffers.compare_exchange_weak(buffer->next, buffer)) {
+      }
+      return buffer;
+    }
+
+  }  // namespace
+
+  void enable_timeline(const std::size_t capacity) {
+    if (capacity == 0) {
+      throw std::invalid_argument("The timeline capacity must be positive");
+    }
+    buffer_capacity = capacity;
+    detail::timeline_active = true;
+  }
+
+  std::int64_t timeline_now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+  }
+
+  void record_timeline_event(const char* name, const char* category, const std::int64_t start, const std::int64_t end) {
+    thread_local ThreadBuffer* buffer = register_thread();
+
+    const auto n = buffer->written.load(std::memory_order_relaxed);
+
+    buffer->events[n % buffer->capacity] = {name, category, start, end};
+    buffer->written.store(n + 1, std::memory_order_release);
+  }
+
+  std::size_t write_chrome_trace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) {
+      throw std::runtime_error("Could not write the timeline to " + path);
+    }
+
+    // The Chrome trace format expects microseconds
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    std::size_t n_events = 0;
+    bool        first    = true;
+
+    auto separator = [&file, &first]() -> std::ofstream& {
+      file << (first ? "\n" : ",\n");
+      first = false;
+      return file;
+    };
+
+    for (const auto* buffer = buffers.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->next) {
+      const auto tid = buffer->thread_index;
+
+      separator() << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << tid
+                  << R"(,"args":{"name":"thread )" << tid << "\"}}";
+
+      const std::uint64_t written = buffer->written.load(std::memory_order_acquire);
+      const std::uint64_t first_event = written > buffer->capacity ? written - buffer->capacity : 0;
+
+      for (std::uint64_t i = first_event; i < written; ++i) {
+        const auto& event = buffer->events[i % buffer->capacity];
+
+        separator() << R"({"name":")" << event.name << R"(","cat":")" << event.category
+                    << R"(","ph":"X","pid":1,"tid":)" << tid
+                    << ",\"ts\":" << static_cast<double>(event.start) * 1e-3
+                    << ",\"dur\":" << static_cast<double>(event.end - event.start) * 1e-3 << '}';
+        ++n_events;
+      }
+
+      if (first_event > 0) {
+        separator() << R"({"name":"dropped events","ph":"i","s":"t","pid":1,"tid":)" << tid
+                    << ",\"ts\":" << static_cast<double>(buffer->events[first_event % buffer->capacity].start) * 1e-3
+                    << R"(,"args":{"count":)" << first_event << "}}";
+      }
+    }
+
+    file << "\n]}\n";
+    return n_events;
+  }
+
+}  // namespace utilities
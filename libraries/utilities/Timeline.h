@@ -0,0 +1,95 @@
+#pragma once
+
+// STL includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#define PHYLINO_TIMELINE_CONCAT_IMPL(a, b) a##b
+#define PHYLINO_TIMELINE_CONCAT(a, b) PHYLINO_TIMELINE_CONCAT_IMPL(a, b)
+
+/**
+ * Records the enclosing scope in the timeline. The name and the category have to be string literals, as only the
+ * pointers are stored. If the timeline is disabled, this costs a single relaxed atomic load.
+ */
+#define PHYLINO_TIMELINE_SCOPE(name, category) \
+  const ::utilities::TimelineScope PHYLINO_TIMELINE_CONCAT(timeline_scope_, __LINE__)(name, category)
+
+namespace utilities {
+
+  namespace detail {
+    extern std::atomic<bool> timeline_active;  ///< Whether the timeline records events.
+  }
+
+  /**
+   * @brief Enables the recording of the timeline.
+   *
+   * Every thread records its events into its own ring buffer of the given capacity, which is allocated on the first
+   * event of the thread. If a buffer is full, the oldest events are overwritten.
+   *
+   * @param capacity The number of events per thread.
+   */
+  void enable_timeline(std::size_t capacity);
+
+  /**
+   * @brief Checks if the timeline records events.
+   */
+  [[nodiscard]] inline bool timeline_enabled() noexcept {
+    return detail::timeline_active.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the time since the timeline was enabled in nanoseconds.
+   */
+  [[nodiscard]] std::int64_t timeline_now() noexcept;
+
+  /**
+   * @brief Records an event of the calling thread.
+   *
+   * @param name The name of the event, a string literal.
+   * @param category The category of the event, a string literal.
+   * @param start The start time as returned by timeline_now().
+   * @param end The end time as returned by timeline_now().
+   */
+  void record_timeline_event(const char* name, const char* category, std::int64_t start, std::int64_t end);
+
+  /**
+   * @brief Writes the recorded events of all threads in the Chrome trace format.
+   *
+   * The file can be loaded in chrome://tracing or Perfetto. The events are read without synchronization with the
+   * recording threads, so no events should be recorded while the timeline is written.
+   *
+   * @param path The output file.
+   * @return The number of written events.
+   * @throws std::runtime_error if the file can not be written.
+   */
+  std::size_t write_chrome_trace(const std::string& path);
+
+  /**
+   * @class TimelineScope
+   * @brief Records the time between its construction and destruction as a timeline event.
+   */
+  class TimelineScope {
+   public:
+    TimelineScope(const char* name, const char* category) noexcept
+      : m_Name(name)
+      , m_Category(category)
+      , m_Start(timeline_enabled() ? timeline_now() : -1) {}
+
+    TimelineScope(const TimelineScope&)            = delete;
+    TimelineScope& operator=(const TimelineScope&) = delete;
+
+    ~TimelineScope() {
+      if (m_Start >= 0) {
+        record_timeline_event(m_Name, m_Category, m_Start, timeline_now());
+      }
+    }
+
+   private:
+    const char*  m_Name;      ///< The name of the event.
+    const char*  m_Category;  ///< The category of the event.
+    std::int64_t m_Start;     ///< The start time, negative if the timeline was disabled at the construction.
+  };
+
+}  // namespace utilities